@@ -37,6 +37,7 @@
 #endif
 
 #include "baseapi.h"
+#include "binaryresult.h"
 
 #include "resultiterator.h"
 #include "thresholder.h"
@@ -54,6 +55,7 @@
 #include "imgs.h"
 #include "imgtiff.h"
 #include "makerow.h"
+#include "memry.h"
 #include "permute.h"
 #include "otsuthr.h"
 #include "osdetect.h"
@@ -96,12 +98,18 @@ TessBaseAPI::TessBaseAPI()
     last_oem_requested_(OEM_DEFAULT),
     recognition_done_(false),
     truth_cb_(NULL),
+    result_cb_(NULL),
+    report_it_(NULL),
+    report_block_it_(NULL),
+    page_allocations_start_(0),
     rect_left_(0), rect_top_(0), rect_width_(0), rect_height_(0),
     image_width_(0), image_height_(0) {
+  line_done_cb_ = NewPermanentTessCallback(this, &TessBaseAPI::ReportLine);
 }
 
 TessBaseAPI::~TessBaseAPI() {
   End();
+  delete line_done_cb_;
 }
 
 /**
@@ -226,6 +234,42 @@ int TessBaseAPI::Init(const char* datapath, const char* language,
   return 0;
 }
 
+// Start tesseract sharing the read-only models of master.
+// Returns 0 on success and -1 on initialization failure.
+int TessBaseAPI::InitShared(TessBaseAPI* master,
+                            char **configs, int configs_size,
+                            const GenericVector<STRING> *vars_vec,
+                            const GenericVector<STRING> *vars_values,
+                            bool set_only_init_params) {
+  if (master == NULL || master == this || master->tesseract_ == NULL ||
+      master->datapath_ == NULL || master->language_ == NULL)
+    return -1;
+  if (tesseract_ != NULL) {
+    tesseract_->end_tesseract();
+    delete tesseract_;
+    tesseract_ = NULL;
+  }
+  tesseract_ = new Tesseract;
+  if (tesseract_->init_tesseract_shared(
+          master->datapath_->string(),
+          output_file_ != NULL ? output_file_->string() : NULL,
+          master->tesseract_->lang.string(), master->last_oem_requested_,
+          configs, configs_size, vars_vec, vars_values,
+          set_only_init_params, master->tesseract_) != 0) {
+    return -1;
+  }
+  if (datapath_ == NULL)
+    datapath_ = new STRING(*master->datapath_);
+  else
+    *datapath_ = *master->datapath_;
+  if (language_ == NULL)
+    language_ = new STRING(*master->language_);
+  else
+    *language_ = *master->language_;
+  last_oem_requested_ = master->last_oem_requested_;
+  return 0;
+}
+
 // Init only the lang model component of Tesseract. The only functions
 // that work after this init are SetVariable and IsValidWord.
 // WARNING: temporary! This function will be removed from here and placed
@@ -307,10 +351,53 @@ void TessBaseAPI::ClearAdaptiveClassifier() {
   tesseract_->getDict().ResetDocumentDictionary();
 }
 
+// Saves the adapted templates of the adaptive classifier to filename.
+bool TessBaseAPI::SaveAdaptiveClassifier(const char* filename) {
+  if (tesseract_ == NULL)
+    return false;
+  FILE* fp = fopen(filename, "wb");
+  if (fp == NULL) {
+    tprintf("Error: can't open %s for writing\n", filename);
+    return false;
+  }
+  bool result = tesseract_->WriteAdaptedSnapshot(fp);
+  if (fclose(fp) != 0)
+    result = false;
+  return result;
+}
+
+// Replaces the adapted templates of the adaptive classifier with those
+// saved in filename by SaveAdaptiveClassifier.
+bool TessBaseAPI::LoadAdaptiveClassifier(const char* filename) {
+  if (tesseract_ == NULL)
+    return false;
+  FILE* fp = fopen(filename, "rb");
+  if (fp == NULL) {
+    tprintf("Error: can't open %s for reading\n", filename);
+    return false;
+  }
+  bool result = tesseract_->ReadAdaptedSnapshot(fp);
+  fclose(fp);
+  return result;
+}
+
+// Replaces the adapted templates of the adaptive classifier with a copy of
+// those of source.
+bool TessBaseAPI::CopyAdaptiveClassifier(const TessBaseAPI& source) {
+  if (tesseract_ == NULL || source.tesseract_ == NULL ||
+      language_ == NULL || source.language_ == NULL ||
+      *language_ != *source.language_)
+    return false;
+  return tesseract_->CopyAdaptedTemplatesFrom(*source.tesseract_);
+}
+
 // Provide an image for Tesseract to recognize. Format is as
 // TesseractRect above. Does not copy the image buffer, or take
 // ownership. The source image may be destroyed after Recognize is called,
 // either explicitly or implicitly via one of the Get*Text functions.
+// The buffer is read in place, with any bytes_per_line, to make the
+// thresholded and greyscale images, so no full-page copy of the caller's
+// image is made.
 // SetImage clears all recognition results, and sets the rectangle to the
 // full image, so it may be followed immediately by a GetUTF8Text, and it
 // will automatically perform recognition.
@@ -520,6 +607,51 @@ PageIterator* TessBaseAPI::AnalyseLayout() {
   return NULL;
 }
 
+// ResultIterator with access to the underlying results, for the API
+// functions that need more than the public iterator interface.
+class ApiResultIterator : public ResultIterator {
+ public:
+  ApiResultIterator(PAGE_RES* page_res, Tesseract* tesseract,
+                    int scale, int scaled_yres,
+                    int rect_left, int rect_top,
+                    int rect_width, int rect_height)
+    : ResultIterator(page_res, tesseract, scale, scaled_yres,
+                     rect_left, rect_top, rect_width, rect_height) {
+  }
+
+  // Returns the current word, or NULL in a non-text block.
+  WERD_RES* word() const {
+    return it_->word();
+  }
+  // Returns the row of the current word, or NULL in a non-text block.
+  ROW_RES* row() const {
+    return it_->row();
+  }
+  // Returns the number of symbols of the current word.
+  int word_length() const {
+    return word_length_;
+  }
+  // Moves to the symbol of the given index in the current word.
+  void MoveToSymbol(int index) {
+    BeginWord(index);
+  }
+  // Returns the index of the current symbol in the current word.
+  int symbol_index() const {
+    return blob_index_;
+  }
+
+  // Moves forward to the first word of the given row, or of the given block
+  // if row is NULL. See PAGE_RES_IT::forward_to_row.
+  void MoveForwardTo(BLOCK_RES* block, ROW_RES* row) {
+    it_->forward_to_row(block, row);
+    BeginWord(0);
+  }
+  // Returns true if the iterator is at a word of the given row.
+  bool InRow(ROW_RES* row) const {
+    return it_->word() != NULL && it_->row() == row;
+  }
+};
+
 // Recognize the tesseract global image and return the result as Tesseract
 // internal structures.
 int TessBaseAPI::Recognize(ETEXT_DESC* monitor) {
@@ -527,6 +659,8 @@ int TessBaseAPI::Recognize(ETEXT_DESC* monitor) {
     return -1;
   if (FindLines() != 0)
     return -1;
+  // FindLines may have run on another thread, and counted its allocations.
+  page_allocations_start_ = alloc_count();
   if (page_res_ != NULL)
     delete page_res_;
 
@@ -560,12 +694,160 @@ int TessBaseAPI::Recognize(ETEXT_DESC* monitor) {
         *input_file_, page_res_, monitor, training_output_file);
     fclose(training_output_file);
   } else {
-    // Now run the main recognition.
+    // Now run the main recognition. The report iterators follow it down
+    // the page, so each line is reported without walking the page again.
+    if (result_cb_ != NULL) {
+      report_it_ = new ApiResultIterator(
+          page_res_, tesseract_, thresholder_->GetScaleFactor(),
+          thresholder_->GetScaledYResolution(),
+          rect_left_, rect_top_, rect_width_, rect_height_);
+      report_block_it_ = new ApiResultIterator(*report_it_);
+      tesseract_->set_line_done_callback(line_done_cb_);
+    }
     tesseract_->recog_all_words(page_res_, monitor, NULL, NULL, 0);
+    tesseract_->set_line_done_callback(NULL);
+    delete report_it_;
+    report_it_ = NULL;
+    delete report_block_it_;
+    report_block_it_ = NULL;
   }
+  CountPageAllocations();
   return 0;
 }
 
+// alloc_count() is per thread, so the layout analysis and the recognition
+// of a page, which RecognizeBatch runs on different threads, each count the
+// allocations of their own thread.
+void TessBaseAPI::CountPageAllocations() {
+  PageStats* stats = tesseract_->page_stats();
+  if (stats->enabled)
+    stats->allocations += alloc_count() - page_allocations_start_;
+  page_allocations_start_ = alloc_count();
+}
+
+void TessBaseAPI::ReportLine(BLOCK_RES* block, ROW_RES* row,
+                             bool block_done) {
+  if (result_cb_ == NULL || report_it_ == NULL)
+    return;
+  // Moving an iterator sets the previous word choice, which recognition has
+  // already set for the word it is at.
+  WERD_CHOICE* prev_word_choice = tesseract_->prev_word_best_choice_;
+  report_it_->MoveForwardTo(block, row);
+  // The callback is given copies, which it may move at will.
+  ApiResultIterator word_it(*report_it_);
+  do {
+    result_cb_->Run(&word_it, RIL_WORD);
+  } while (word_it.Next(RIL_WORD) && word_it.InRow(row));
+  ApiResultIterator line_it(*report_it_);
+  result_cb_->Run(&line_it, RIL_TEXTLINE);
+  if (block_done) {
+    report_block_it_->MoveForwardTo(block, NULL);
+    ApiResultIterator block_it(*report_block_it_);
+    result_cb_->Run(&block_it, RIL_BLOCK);
+    // The next block starts after the last line of this one.
+    delete report_block_it_;
+    report_block_it_ = new ApiResultIterator(*report_it_);
+  }
+  tesseract_->prev_word_best_choice_ = prev_word_choice;
+}
+
+// State shared by RecognizeBatch, which recognizes the pages in the calling
+// thread, and BatchLayoutThread, which thresholds and segments them ahead.
+// Both walk the pages in order, so page i always uses slot i % num_slots, and
+// the semaphores count the slots that are free and the pages that are ready.
+struct BatchPipeline {
+  Pix** pages;
+  int num_pages;
+  TessBaseAPI** slots;
+  int num_slots;
+  bool* layout_ok;
+  CCUtilSemaphore free_slots;
+  CCUtilSemaphore ready_pages;
+};
+
+// Recognize a batch of pages, overlapping the layout analysis of the next
+// pages with the recognition of the current one.
+int TessBaseAPI::RecognizeBatch(Pix** pages, int num_pages, int queue_depth,
+                                BatchPageCallback* page_cb) {
+  if (tesseract_ == NULL || pages == NULL || num_pages <= 0)
+    return 0;
+  int num_recognized = 0;
+  BatchPipeline pipeline;
+  pipeline.pages = pages;
+  pipeline.num_pages = num_pages;
+  pipeline.num_slots = MIN(queue_depth, num_pages - 1) + 1;
+  pipeline.slots = NULL;
+  pipeline.layout_ok = NULL;
+  CCUtilThread layout_thread;
+  if (pipeline.num_slots > 1) {
+    pipeline.slots = new TessBaseAPI*[pipeline.num_slots];
+    pipeline.layout_ok = new bool[num_pages];
+    bool slots_ok = true;
+    int s = 0;
+    for (; s < pipeline.num_slots; ++s) {
+      pipeline.slots[s] = new TessBaseAPI;
+      if (pipeline.slots[s]->InitShared(this) != 0) {
+        slots_ok = false;
+        break;
+      }
+      ParamUtils::CopyParams(tesseract_->params(),
+                             pipeline.slots[s]->tesseract_->params());
+      pipeline.free_slots.Signal();
+    }
+    if (!slots_ok ||
+        !layout_thread.Start(&TessBaseAPI::BatchLayoutThread, &pipeline)) {
+      tprintf("Warning: failed to start the batch pipeline,"
+              " recognizing the pages sequentially\n");
+      // The slots made so far, including the one that failed to init.
+      int num_made = slots_ok ? pipeline.num_slots : s + 1;
+      for (int d = 0; d < num_made; ++d)
+        delete pipeline.slots[d];
+      delete [] pipeline.slots;
+      pipeline.slots = NULL;
+    }
+  }
+  for (int i = 0; i < num_pages; ++i) {
+    TessBaseAPI* api = this;
+    bool ok;
+    if (pipeline.slots != NULL) {
+      pipeline.ready_pages.Wait();
+      api = pipeline.slots[i % pipeline.num_slots];
+      ok = pipeline.layout_ok[i] && api->Recognize(NULL) >= 0;
+    } else {
+      SetImage(pages[i]);
+      ok = Recognize(NULL) >= 0;
+    }
+    if (ok) ++num_recognized;
+    if (page_cb != NULL) page_cb->Run(i, ok ? api : NULL);
+    if (pipeline.slots != NULL) {
+      api->Clear();
+      pipeline.free_slots.Signal();
+    }
+  }
+  if (pipeline.slots != NULL) {
+    layout_thread.Join();
+    for (int s = 0; s < pipeline.num_slots; ++s)
+      delete pipeline.slots[s];
+    delete [] pipeline.slots;
+  }
+  delete [] pipeline.layout_ok;
+  return num_recognized;
+}
+
+// Thresholds and finds the lines of each page of a RecognizeBatch pipeline
+// as soon as a slot is free for it.
+void* TessBaseAPI::BatchLayoutThread(void* arg) {
+  BatchPipeline* pipeline = static_cast<BatchPipeline*>(arg);
+  for (int i = 0; i < pipeline->num_pages; ++i) {
+    pipeline->free_slots.Wait();
+    TessBaseAPI* slot = pipeline->slots[i % pipeline->num_slots];
+    slot->SetImage(pipeline->pages[i]);
+    pipeline->layout_ok[i] = slot->FindLines() == 0;
+    pipeline->ready_pages.Signal();
+  }
+  return NULL;
+}
+
 // Tests the chopper by exhaustively running chop_one_blob.
 int TessBaseAPI::RecognizeForChopTest(ETEXT_DESC* monitor) {
   if (tesseract_ == NULL)
@@ -1021,6 +1303,194 @@ char* TessBaseAPI::GetBoxText(int page_number) {
   return result;
 }
 
+// Helper returns the offset in text_pool of a copy of the given string.
+static inT32 AddBinaryResultText(const char* text,
+                                 GenericVector<char>* text_pool) {
+  inT32 offset = text_pool->size();
+  do {
+    text_pool->push_back(*text);
+  } while (*text++ != '\0');
+  return offset;
+}
+
+// Helper appends the given table to result at offset, which it advances.
+template <typename T>
+static void WriteBinaryResultTable(const GenericVector<T>& table,
+                                   char* result, inT32* offset) {
+  if (!table.empty()) {
+    memcpy(result + *offset, &table[0], table.size() * sizeof(T));
+    *offset += table.size() * sizeof(T);
+  }
+}
+
+// Make a binary result of the page. See binaryresult.h.
+char* TessBaseAPI::GetBinaryResult(int max_choices, int* size) {
+  if (tesseract_ == NULL ||
+      (!recognition_done_ && Recognize(NULL) < 0))
+    return NULL;
+  GenericVector<BinaryResultBlock> blocks;
+  GenericVector<BinaryResultRow> rows;
+  GenericVector<BinaryResultWord> words;
+  GenericVector<BinaryResultSymbol> symbols;
+  GenericVector<BinaryResultChoice> choices;
+  GenericVector<BinaryResultUnichar> unichars;
+  GenericVector<char> text_pool;
+  // Index in unichars of each unichar id, or -1 if not used yet.
+  const UNICHARSET& unicharset = tesseract_->unicharset;
+  GenericVector<inT32> unichar_index;
+  unichar_index.init_to_size(unicharset.size(), -1);
+
+  ApiResultIterator it(page_res_, tesseract_,
+                       thresholder_->GetScaleFactor(),
+                       thresholder_->GetScaledYResolution(),
+                       rect_left_, rect_top_, rect_width_, rect_height_);
+  ROW_RES* last_row = NULL;
+  do {
+    if (it.IsAtBeginningOf(RIL_BLOCK)) {
+      BinaryResultBlock block;
+      it.BoundingBox(RIL_BLOCK, &block.box.left, &block.box.top,
+                     &block.box.right, &block.box.bottom);
+      block.type = it.BlockType();
+      block.first_row = rows.size();
+      block.num_rows = 0;
+      blocks.push_back(block);
+    }
+    WERD_RES* word = it.word();
+    if (word == NULL || word->best_choice == NULL)
+      continue;  // A non-text block.
+    if (it.row() != last_row) {
+      last_row = it.row();
+      BinaryResultRow row;
+      it.BoundingBox(RIL_TEXTLINE, &row.box.left, &row.box.top,
+                     &row.box.right, &row.box.bottom);
+      row.first_word = words.size();
+      row.num_words = 0;
+      rows.push_back(row);
+      ++blocks[blocks.size() - 1].num_rows;
+    }
+    WERD_CHOICE* best_choice = word->best_choice;
+    BinaryResultWord word_rec;
+    it.BoundingBox(RIL_WORD, &word_rec.box.left, &word_rec.box.top,
+                   &word_rec.box.right, &word_rec.box.bottom);
+    word_rec.first_symbol = symbols.size();
+    word_rec.num_symbols = it.word_length();
+    word_rec.text = AddBinaryResultText(
+        best_choice->unichar_string().string(), &text_pool);
+    word_rec.flags = (it.WordIsFromDictionary() ? kBinaryResultDictWord : 0) |
+                     (it.WordIsNumeric() ? kBinaryResultNumeric : 0);
+    word_rec.font_id = word->fontinfo_id;
+    word_rec.rating = best_choice->rating();
+    word_rec.certainty = best_choice->certainty();
+    word_rec.confidence = it.Confidence(RIL_WORD);
+    words.push_back(word_rec);
+    ++rows[rows.size() - 1].num_words;
+
+    BLOB_CHOICE_LIST_C_IT blob_choices_it;
+    if (best_choice->blob_choices() != NULL)
+      blob_choices_it.set_to_list(best_choice->blob_choices());
+    for (int s = 0; s < it.word_length(); ++s) {
+      it.MoveToSymbol(s);
+      BinaryResultSymbol symbol;
+      it.BoundingBox(RIL_SYMBOL, &symbol.box.left, &symbol.box.top,
+                     &symbol.box.right, &symbol.box.bottom);
+      symbol.rejected = word->reject_map[s].rejected();
+      symbol.first_choice = choices.size();
+      symbol.num_choices = 0;
+      // Cube results have no blob choices, so the best unichar is the only
+      // choice, with the certainty of the word.
+      BLOB_CHOICE_LIST best_list;
+      BLOB_CHOICE_IT choice_it(&best_list);
+      if (best_choice->blob_choices() != NULL &&
+          s < best_choice->blob_choices()->length()) {
+        choice_it.set_to_list(blob_choices_it.data());
+        blob_choices_it.forward();
+      } else {
+        choice_it.add_after_then_move(
+            new BLOB_CHOICE(best_choice->unichar_id(s), best_choice->rating(),
+                            best_choice->certainty(), -1, -1, -1));
+      }
+      for (choice_it.mark_cycle_pt(); !choice_it.cycled_list() &&
+           (max_choices <= 0 || symbol.num_choices < max_choices);
+           choice_it.forward()) {
+        UNICHAR_ID id = choice_it.data()->unichar_id();
+        if (id < 0 || id >= unicharset.size())
+          continue;
+        if (unichar_index[id] < 0) {
+          BinaryResultUnichar unichar;
+          unichar.text = AddBinaryResultText(unicharset.id_to_unichar(id),
+                                             &text_pool);
+          unichar_index[id] = unichars.size();
+          unichars.push_back(unichar);
+        }
+        BinaryResultChoice choice;
+        choice.unichar = unichar_index[id];
+        choice.rating = choice_it.data()->rating();
+        choice.certainty = choice_it.data()->certainty();
+        choices.push_back(choice);
+        ++symbol.num_choices;
+      }
+      UNICHAR_ID best_id = best_choice->unichar_id(s);
+      if (best_id >= 0 && best_id < unicharset.size() &&
+          unichar_index[best_id] < 0) {
+        BinaryResultUnichar unichar;
+        unichar.text = AddBinaryResultText(unicharset.id_to_unichar(best_id),
+                                           &text_pool);
+        unichar_index[best_id] = unichars.size();
+        unichars.push_back(unichar);
+      }
+      symbol.unichar = best_id >= 0 && best_id < unicharset.size()
+                     ? unichar_index[best_id] : -1;
+      symbols.push_back(symbol);
+    }
+    it.MoveToSymbol(0);
+  } while (it.Next(RIL_WORD));
+
+  BinaryResultHeader header;
+  memcpy(header.magic, kBinaryResultMagic, sizeof(header.magic));
+  header.version = kBinaryResultVersion;
+  header.image_width = image_width_;
+  header.image_height = image_height_;
+  inT32 offset = sizeof(header);
+  header.num_blocks = blocks.size();
+  header.blocks_offset = offset;
+  offset += blocks.size() * sizeof(BinaryResultBlock);
+  header.num_rows = rows.size();
+  header.rows_offset = offset;
+  offset += rows.size() * sizeof(BinaryResultRow);
+  header.num_words = words.size();
+  header.words_offset = offset;
+  offset += words.size() * sizeof(BinaryResultWord);
+  header.num_symbols = symbols.size();
+  header.symbols_offset = offset;
+  offset += symbols.size() * sizeof(BinaryResultSymbol);
+  header.num_choices = choices.size();
+  header.choices_offset = offset;
+  offset += choices.size() * sizeof(BinaryResultChoice);
+  header.num_unichars = unichars.size();
+  header.unichars_offset = offset;
+  offset += unichars.size() * sizeof(BinaryResultUnichar);
+  // Pad the text pool so the size stays a multiple of 4.
+  while (text_pool.size() % 4 != 0)
+    text_pool.push_back('\0');
+  header.text_size = text_pool.size();
+  header.text_offset = offset;
+  header.size = offset + text_pool.size();
+
+  char* result = new char[header.size];
+  memcpy(result, &header, sizeof(header));
+  offset = sizeof(header);
+  WriteBinaryResultTable(blocks, result, &offset);
+  WriteBinaryResultTable(rows, result, &offset);
+  WriteBinaryResultTable(words, result, &offset);
+  WriteBinaryResultTable(symbols, result, &offset);
+  WriteBinaryResultTable(choices, result, &offset);
+  WriteBinaryResultTable(unichars, result, &offset);
+  WriteBinaryResultTable(text_pool, result, &offset);
+  ASSERT_HOST(offset == header.size);
+  *size = header.size;
+  return result;
+}
+
 // Conversion table for non-latin characters.
 // Maps characters out of the latin set into the latin set.
 // TODO(rays) incorporate this translation into unicharset.
@@ -1358,6 +1828,7 @@ bool TessBaseAPI::InternalSetImage() {
 // The usual argument to Threshold is Tesseract::mutable_pix_binary().
 void TessBaseAPI::Threshold(Pix** pix) {
   ASSERT_HOST(pix != NULL);
+  PageStageTimer timer(tesseract_->page_stats(), PAGE_STAGE_THRESHOLD);
   if (!thresholder_->IsBinary()) {
     tesseract_->set_pix_grey(thresholder_->GetPixRectGrey());
   }
@@ -1384,12 +1855,15 @@ int TessBaseAPI::FindLines() {
     tesseract_ = new Tesseract;
     tesseract_->InitAdaptiveClassifier(false);
   }
+  tesseract_->ResetPageStats();
+  page_allocations_start_ = alloc_count();
   if (tesseract_->pix_binary() == NULL)
     Threshold(tesseract_->mutable_pix_binary());
   if (tesseract_->ImageWidth() > MAX_INT16 ||
       tesseract_->ImageHeight() > MAX_INT16) {
     tprintf("Image too large: (%d, %d)\n",
             tesseract_->ImageWidth(), tesseract_->ImageHeight());
+    CountPageAllocations();
     return -1;
   }
 
@@ -1415,8 +1889,10 @@ int TessBaseAPI::FindLines() {
     }
   }
 
-  if (tesseract_->SegmentPage(input_file_, block_list_, osd_tess, &osr) < 0)
+  if (tesseract_->SegmentPage(input_file_, block_list_, osd_tess, &osr) < 0) {
+    CountPageAllocations();
     return -1;
+  }
   // If OCR is to be run using Tesseract, OCR-able blobs are required for
   // training, or interactive mode is needed, prepare data and images for ocr.
   if (tesseract_->interactive_mode ||
@@ -1427,6 +1903,7 @@ int TessBaseAPI::FindLines() {
       OEM_TESSERACT_CUBE_COMBINED) {
     tesseract_->PrepareForTessOCR(block_list_, osd_tess, &osr);
   }
+  CountPageAllocations();
   return 0;
 }
 
@@ -1924,7 +2401,30 @@ const char* TessBaseAPI::GetLastInitLanguage() const {
 }
 
 // Return a pointer to underlying CubeRecoContext object if present.
-CubeRecoContext *TessBaseAPI::GetCubeRecoContext() const {
-  return (tesseract_ == NULL) ? NULL : tesseract_->GetCubeRecoContext();
+CubeRecoContext *TessBaseAPI::GetCubeRecoContext() {
+  if (tesseract_ == NULL)
+    return NULL;
+  tesseract_->load_cube_objects();
+  return tesseract_->GetCubeRecoContext();
+}
+
+// Fills components with the file suffixes of the language data components
+// loaded so far.
+void TessBaseAPI::GetLoadedComponents(GenericVector<STRING>* components) const {
+  components->clear();
+  if (tesseract_ == NULL)
+    return;
+  for (int i = 0; i < TESSDATA_NUM_ENTRIES; ++i) {
+    TessdataType type = static_cast<TessdataType>(i);
+    if (tesseract_->tessdata_manager.IsLoaded(type))
+      components->push_back(STRING(kTessdataFileSuffixes[i]));
+  }
+}
+
+bool TessBaseAPI::GetPageStats(PageStats* stats) const {
+  if (tesseract_ == NULL)
+    return false;
+  tesseract_->GetPageStats(stats);
+  return true;
 }
 }  // namespace tesseract.
@@ -31,6 +31,8 @@
 
 class PAGE_RES;
 class PAGE_RES_IT;
+class BLOCK_RES;
+class ROW_RES;
 class BLOCK_LIST;
 class DENORM;
 class IMAGE;
@@ -63,10 +65,12 @@ struct TBLOB;
 
 namespace tesseract {
 
+class ApiResultIterator;
 class CubeRecoContext;
 class Dawg;
 class Dict;
 class PageIterator;
+struct PageStats;
 class ResultIterator;
 class Tesseract;
 class Trie;
@@ -79,6 +83,10 @@ typedef double (Dict::*ProbabilityInContextFunc)(const char* lang,
                                                  const char* character,
                                                  int character_bytes);
 typedef TessCallback2<int, PAGE_RES *> TruthCallback;
+class TessBaseAPI;
+typedef TessCallback2<int, TessBaseAPI *> BatchPageCallback;
+typedef TessCallback2<const ResultIterator *, PageIteratorLevel>
+    ResultCallback;
 
 /**
  * Base class for all tesseract APIs.
@@ -151,6 +159,9 @@ class TESSDLL_API TessBaseAPI {
    * The datapath must be the name of the parent directory of tessdata and
    * must end in / . Any name after the last / will be stripped.
    * The language is (usually) an ISO 639-3 string or NULL will default to eng.
+   * Several languages may be given separated by '+', eg "eng+deu+fra", in
+   * which case each word is recognized with all of them and the first one is
+   * the main language, which the page layout and Cube use.
    * It is entirely safe (and eventually will be efficient too) to call
    * Init multiple times on the same instance to change language, or just
    * to reset the classifier.
@@ -174,6 +185,25 @@ class TESSDLL_API TessBaseAPI {
     return Init(datapath, language, OEM_DEFAULT, NULL, 0, NULL, NULL, false);
   }
 
+  /**
+   * Start tesseract with the datapath, language and engine mode of master,
+   * which must already have been initialized with Init. The read-only
+   * classifier templates, normprotos, font tables and dawgs are shared with
+   * master instead of being loaded again, so only the cheap per-page state
+   * (results, adapted templates, document dictionary) belongs to this
+   * instance. Master must not be re-initialized or ended while any instance
+   * sharing its models is alive. Normally used through TessBaseAPIPool.
+   * Returns zero on success and -1 on failure.
+   */
+  int InitShared(TessBaseAPI* master,
+                 char **configs, int configs_size,
+                 const GenericVector<STRING> *vars_vec,
+                 const GenericVector<STRING> *vars_values,
+                 bool set_only_init_params);
+  int InitShared(TessBaseAPI* master) {
+    return InitShared(master, NULL, 0, NULL, NULL, false);
+  }
+
   /**
    * Init only the lang model component of Tesseract. The only functions
    * that work after this init are SetVariable and IsValidWord.
@@ -234,6 +264,33 @@ class TESSDLL_API TessBaseAPI {
    */
   void ClearAdaptiveClassifier();
 
+  /**
+   * Saves what the adaptive classifier has learned so far to filename, as a
+   * versioned binary snapshot of its adapted templates. Loading it into an
+   * instance of the same language with LoadAdaptiveClassifier warm-starts
+   * that instance, for instance per customer or font family, so the first
+   * pages of a document are not recognized with an empty adaptive
+   * classifier. The document dictionary is not saved.
+   * Returns false if it could not be saved.
+   */
+  bool SaveAdaptiveClassifier(const char* filename);
+
+  /**
+   * Replaces the adaptive classifier with a snapshot saved by
+   * SaveAdaptiveClassifier. Returns false, leaving the classifier as it was,
+   * if the file cannot be read or is for another language or version.
+   */
+  bool LoadAdaptiveClassifier(const char* filename);
+
+  /**
+   * Replaces the adaptive classifier with a copy of that of source, which
+   * must be initialized with the same language, so that several instances,
+   * such as the workers of a TessBaseAPIPool, can start from the same
+   * baseline without saving it or relearning it.
+   * Returns false if the classifier was not replaced.
+   */
+  bool CopyAdaptiveClassifier(const TessBaseAPI& source);
+
   /**
    * @defgroup AdvancedAPI Advanced API
    * The following methods break TesseractRect into pieces, so you can
@@ -247,6 +304,9 @@ class TESSDLL_API TessBaseAPI {
    * TesseractRect above. Does not copy the image buffer, or take
    * ownership. The source image may be destroyed after Recognize is called,
    * either explicitly or implicitly via one of the Get*Text functions.
+   * The buffer is read in place, with any bytes_per_line, to make the
+   * thresholded and greyscale images, so no full-page copy of the caller's
+   * image is made.
    * SetImage clears all recognition results, and sets the rectangle to the
    * full image, so it may be followed immediately by a GetUTF8Text, and it
    * will automatically perform recognition.
@@ -359,6 +419,27 @@ class TESSDLL_API TessBaseAPI {
    */
   int Recognize(ETEXT_DESC* monitor);
 
+  /**
+   * Recognize a batch of pages, such as the pages of a multi-page tiff.
+   * Thresholding and page layout analysis run in a separate thread up to
+   * queue_depth pages ahead of the page being recognized, so the stages
+   * of consecutive pages overlap. Each page in flight is held by a private
+   * TessBaseAPI that shares the models of this one (see InitShared) and
+   * gets a copy of its current parameters, so the extra memory is only the
+   * per-page state. The adaptive classifier of each of these instances
+   * learns from the pages it recognizes, instead of the one of this instance
+   * learning from all the pages. With queue_depth <= 0 the pages are simply
+   * recognized one after the other by this instance.
+   * page_cb is run in the calling thread for each page, in order, with the
+   * page index and the TessBaseAPI holding its results, or NULL if the page
+   * could not be recognized. The results are only valid during the call,
+   * and may be fetched with any of the Get* functions or iterators below.
+   * page_cb must be a permanent callback and is not deleted.
+   * Returns the number of pages recognized successfully.
+   */
+  int RecognizeBatch(Pix** pages, int num_pages, int queue_depth,
+                     BatchPageCallback* page_cb);
+
   /**
    * Methods to retrieve information after SetAndThresholdImage(),
    * Recognize() or TesseractRect(). (Recognize is called implicitly if needed.)
@@ -435,6 +516,15 @@ class TESSDLL_API TessBaseAPI {
    * and must be freed with the delete [] operator.
    */
   char* GetUNLVText();
+  /**
+   * Make a binary result of the page: the blocks, rows, words and symbols
+   * with their boxes, and at most max_choices classifier choices per symbol
+   * (all of them if max_choices <= 0) with their ratings and certainties.
+   * See binaryresult.h for the layout, which needs no parsing and may be
+   * memory-mapped from a file. The size in bytes is returned in size.
+   * Returns NULL on error. Use delete [] to free after use.
+   */
+  char* GetBinaryResult(int max_choices, int* size);
   /** Returns the (average) confidence value between 0 and 100. */
   int MeanTextConf();
   /**
@@ -546,8 +636,48 @@ class TESSDLL_API TessBaseAPI {
 
   void InitTruthCallback(TruthCallback *cb) { truth_cb_ = cb; }
 
-  // Return a pointer to underlying CubeRecoContext object if present.
-  CubeRecoContext *GetCubeRecoContext() const;
+  /**
+   * Sets a callback that Recognize runs for each text block, textline and
+   * word as soon as its recognition is done, so that the results can be
+   * used before the whole page is finished. The callback gets an iterator
+   * positioned at the start of the object and the level of the object
+   * (RIL_BLOCK, RIL_TEXTLINE or RIL_WORD) to read its text, box and
+   * confidence with. The iterator is only valid during the call and must
+   * not be moved. The objects are reported in page order, a textline with
+   * its words first, then the block if the line is its last one.
+   * The results are those of the word passes. The page-level passes that
+   * follow (fuzzy space fixing, document rejection, font recognition and
+   * cube combination) may still change them before Recognize returns, so
+   * the Get*Text functions and GetIterator remain the final output.
+   * Nothing is reported with OEM_CUBE_ONLY. The callback is not owned.
+   * NULL stops the reports.
+   */
+  void SetResultCallback(ResultCallback *cb) { result_cb_ = cb; }
+
+  // Return a pointer to underlying CubeRecoContext object if present,
+  // loading it if the engine mode uses cube and it was not used yet.
+  CubeRecoContext *GetCubeRecoContext();
+
+  /**
+   * Fills components with the file suffixes (e.g. "inttemp", "word-dawg") of
+   * the components of the language data loaded so far. The dawgs and the
+   * cube objects are only loaded on their first use, so after recognizing
+   * representative pages this tells which components a configuration really
+   * needs. The dawgs shared from another instance, e.g. by TessBaseAPIPool,
+   * are reported by the instance that owns them.
+   */
+  void GetLoadedComponents(GenericVector<STRING>* components) const;
+
+  /**
+   * Fills stats with the time spent and the calls made in each stage of the
+   * last page (thresholding, layout analysis, classifiers, chopper and dawg
+   * permutation, see pagestats.h), and with the number of allocations made
+   * through the tesseract allocators, counting those of all the threads of
+   * the page. The stats are reset by the layout analysis of each page and
+   * only recorded while the tessedit_page_stats variable is true, so they
+   * cost nothing otherwise. Returns false if there is no page.
+   */
+  bool GetPageStats(PageStats* stats) const;
 
   void set_min_orientation_margin(double margin);
 
@@ -584,9 +714,27 @@ class TESSDLL_API TessBaseAPI {
    */
   int FindLines();
 
+  /**
+   * Body of the layout thread of RecognizeBatch, which runs FindLines on
+   * the pages ahead of the one being recognized.
+   */
+  static void* BatchLayoutThread(void* pipeline);
+
+  /**
+   * Adds the allocations made by the calling thread since
+   * page_allocations_start_ to the page stats, and restarts the count.
+   */
+  void CountPageAllocations();
+
   /** Delete the pageres and block list ready for a new page. */
   void ClearResults();
 
+  /**
+   * Runs result_cb_ for the words of a textline finished by recog_all_words,
+   * the line and, if block_done, its block.
+   */
+  void ReportLine(BLOCK_RES* block, ROW_RES* row, bool block_done);
+
   /**
    * Return the length of the output text string, as UTF8, assuming
    * one newline per line and one per block, with a terminator,
@@ -643,6 +791,18 @@ class TESSDLL_API TessBaseAPI {
   OcrEngineMode last_oem_requested_;  ///< Last ocr language mode requested.
   bool          recognition_done_;   ///< page_res_ contains recognition data.
   TruthCallback *truth_cb_;           /// fxn for setting truth_* in WERD_RES
+  ResultCallback *result_cb_;         ///< Streamed results. Not owned.
+  /** Runs ReportLine. Given to tesseract_ while result_cb_ is set. */
+  TessCallback3<BLOCK_RES*, ROW_RES*, bool> *line_done_cb_;
+  /** At the last line reported by ReportLine, during recognition. */
+  ApiResultIterator *report_it_;
+  /** Before the first line of the block being reported. */
+  ApiResultIterator *report_block_it_;
+  /**
+   * alloc_count() at the start of the layout analysis or of the recognition
+   * of the page, for the page stats.
+   */
+  inT64 page_allocations_start_;
 
   /**
    * @defgroup ThresholderParams
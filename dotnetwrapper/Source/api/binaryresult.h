@@ -0,0 +1,124 @@
+///////////////////////////////////////////////////////////////////////
+// File:        binaryresult.h
+// Description: Layout of the binary page result of TessBaseAPI.
+//
+// (C) Copyright 2011, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_API_BINARYRESULT_H__
+#define TESSERACT_API_BINARYRESULT_H__
+
+#include "host.h"
+
+// The binary result made by TessBaseAPI::GetBinaryResult is a single
+// contiguous buffer, meant to be written to a file as it is and memory-mapped
+// by the consumer, which only needs this header to read it: there is nothing
+// to parse. It starts with a BinaryResultHeader, which gives the number and
+// offset from the start of the buffer of each table of records. The records
+// are the fixed-size structs below, made of 32-bit ints and floats in the
+// byte order of the machine that made the result, and all offsets are
+// multiples of 4. The records refer to each other by index in their tables:
+// a block holds a range of rows, a row a range of words, a word a range of
+// symbols and a symbol a range of choices. Strings are NUL-terminated UTF-8
+// held in the text pool, and referred to by their offset in the pool.
+// The boxes are in the coordinates of ResultIterator::BoundingBox, ie of the
+// original image with y going down.
+
+namespace tesseract {
+
+// First 4 bytes of a binary result.
+const char kBinaryResultMagic[4] = { 'T', 'R', 'E', 'S' };
+// Version of the layout below. Consumers should reject other versions.
+const inT32 kBinaryResultVersion = 1;
+
+// Flags of BinaryResultWord.
+const inT32 kBinaryResultDictWord = 1;  // The word is in a dictionary.
+const inT32 kBinaryResultNumeric = 2;   // The word is a number.
+
+struct BinaryResultBox {
+  inT32 left;
+  inT32 top;
+  inT32 right;
+  inT32 bottom;
+};
+
+struct BinaryResultHeader {
+  char magic[4];          // kBinaryResultMagic.
+  inT32 version;          // kBinaryResultVersion.
+  inT32 size;             // Size of the whole result in bytes.
+  inT32 image_width;
+  inT32 image_height;
+  inT32 num_blocks;
+  inT32 blocks_offset;    // BinaryResultBlock table.
+  inT32 num_rows;
+  inT32 rows_offset;      // BinaryResultRow table.
+  inT32 num_words;
+  inT32 words_offset;     // BinaryResultWord table.
+  inT32 num_symbols;
+  inT32 symbols_offset;   // BinaryResultSymbol table.
+  inT32 num_choices;
+  inT32 choices_offset;   // BinaryResultChoice table.
+  inT32 num_unichars;
+  inT32 unichars_offset;  // BinaryResultUnichar table.
+  inT32 text_size;
+  inT32 text_offset;      // Text pool.
+};
+
+// A block of the page layout. Non-text blocks have no rows.
+struct BinaryResultBlock {
+  BinaryResultBox box;
+  inT32 type;             // PolyBlockType, see publictypes.h.
+  inT32 first_row;
+  inT32 num_rows;
+};
+
+struct BinaryResultRow {
+  BinaryResultBox box;
+  inT32 first_word;
+  inT32 num_words;
+};
+
+struct BinaryResultWord {
+  BinaryResultBox box;
+  inT32 first_symbol;
+  inT32 num_symbols;
+  inT32 text;             // Offset of the text of the word in the text pool.
+  inT32 flags;            // kBinaryResultDictWord | kBinaryResultNumeric.
+  inT32 font_id;          // Index in the font table of the language, or -1.
+  float rating;           // Of the best choice, lower is better.
+  float certainty;        // Of the best choice, higher is better.
+  float confidence;       // As ResultIterator::Confidence, in [0, 100].
+};
+
+struct BinaryResultSymbol {
+  BinaryResultBox box;
+  inT32 unichar;          // Index of the best unichar in the unichar table.
+  inT32 rejected;         // Non-zero if the symbol is rejected.
+  inT32 first_choice;     // The choices of the classifier, best first.
+  inT32 num_choices;
+};
+
+struct BinaryResultChoice {
+  inT32 unichar;          // Index in the unichar table.
+  float rating;
+  float certainty;
+};
+
+// The unichars used by the result, each stored once.
+struct BinaryResultUnichar {
+  inT32 text;             // Offset of the unichar in the text pool.
+};
+
+}  // namespace tesseract.
+
+#endif  // TESSERACT_API_BINARYRESULT_H__
@@ -0,0 +1,123 @@
+///////////////////////////////////////////////////////////////////////
+// File:        tesspool.cpp
+// Description: Pool of TessBaseAPI instances sharing one set of models.
+//
+// (C) Copyright 2011, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "tesspool.h"
+#include "ccutil.h"
+
+namespace tesseract {
+
+TessBaseAPIPool::TessBaseAPIPool()
+  : master_(NULL),
+    set_only_init_params_(false),
+    mutex_(new CCUtilMutex) {
+}
+
+TessBaseAPIPool::~TessBaseAPIPool() {
+  End();
+  delete mutex_;
+}
+
+int TessBaseAPIPool::Init(const char* datapath, const char* language,
+                          OcrEngineMode oem,
+                          char **configs, int configs_size,
+                          const GenericVector<STRING> *vars_vec,
+                          const GenericVector<STRING> *vars_values,
+                          bool set_only_init_params) {
+  End();
+  master_ = new TessBaseAPI;
+  if (master_->Init(datapath, language, oem, configs, configs_size,
+                    vars_vec, vars_values, set_only_init_params) != 0) {
+    delete master_;
+    master_ = NULL;
+    return -1;
+  }
+  for (int i = 0; i < configs_size; ++i)
+    configs_.push_back(STRING(configs[i]));
+  if (vars_vec != NULL && vars_values != NULL) {
+    vars_vec_ = *vars_vec;
+    vars_values_ = *vars_values;
+  }
+  set_only_init_params_ = set_only_init_params;
+  return 0;
+}
+
+TessBaseAPI* TessBaseAPIPool::Acquire() {
+  mutex_->Lock();
+  TessBaseAPI* api = NULL;
+  if (!idle_.empty()) {
+    api = idle_[idle_.size() - 1];
+    idle_.truncate(idle_.size() - 1);
+  } else if (master_ != NULL) {
+    // Initializing a worker only reads the small per-instance data, so it
+    // is done under the lock rather than letting new workers race on the
+    // global params that a config file may set.
+    api = new TessBaseAPI;
+    char** configs = NULL;
+    if (!configs_.empty()) {
+      configs = new char*[configs_.size()];
+      for (int i = 0; i < configs_.size(); ++i)
+        configs[i] = const_cast<char*>(configs_[i].string());
+    }
+    bool have_vars = !vars_vec_.empty();
+    if (api->InitShared(master_, configs, configs_.size(),
+                        have_vars ? &vars_vec_ : NULL,
+                        have_vars ? &vars_values_ : NULL,
+                        set_only_init_params_) == 0) {
+      workers_.push_back(api);
+    } else {
+      delete api;
+      api = NULL;
+    }
+    delete [] configs;
+  }
+  mutex_->Unlock();
+  return api;
+}
+
+void TessBaseAPIPool::Release(TessBaseAPI* api) {
+  if (api == NULL)
+    return;
+  api->Clear();
+  api->ClearAdaptiveClassifier();
+  mutex_->Lock();
+  idle_.push_back(api);
+  mutex_->Unlock();
+}
+
+int TessBaseAPIPool::NumWorkers() const {
+  mutex_->Lock();
+  int num_workers = workers_.size();
+  mutex_->Unlock();
+  return num_workers;
+}
+
+void TessBaseAPIPool::End() {
+  mutex_->Lock();
+  // The workers borrow the models of the master, so they go first.
+  workers_.delete_data_pointers();
+  workers_.clear();
+  idle_.clear();
+  delete master_;
+  master_ = NULL;
+  configs_.clear();
+  vars_vec_.clear();
+  vars_values_.clear();
+  set_only_init_params_ = false;
+  mutex_->Unlock();
+}
+
+}  // namespace tesseract.
@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////////////////////////
+// File:        tesspool.h
+// Description: Pool of TessBaseAPI instances sharing one set of models.
+//
+// (C) Copyright 2011, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_API_TESSPOOL_H__
+#define TESSERACT_API_TESSPOOL_H__
+
+#include "baseapi.h"
+#include "genericvector.h"
+#include "strngs.h"
+
+namespace tesseract {
+
+class CCUtilMutex;
+
+/**
+ * Thread-safe pool of TessBaseAPI workers for one datapath/language/engine
+ * mode. The read-only models (int templates, normprotos, font tables, dawgs)
+ * are loaded once by a master instance and shared by all the workers, each
+ * of which only owns its per-page state, so N concurrent recognitions cost
+ * about the memory and start-up time of one plus N small contexts.
+ *
+ * Typical use, one Acquire/Release pair per page and thread:
+ *   TessBaseAPI* api = pool.Acquire();
+ *   api->SetImage(pix);
+ *   char* text = api->GetUTF8Text();
+ *   pool.Release(api);
+ *
+ * A worker must only be used by one thread between Acquire and Release.
+ * The caveat of TessBaseAPI about global params still applies: SetVariable
+ * on a worker may change the value for all instances.
+ */
+class TESSDLL_API TessBaseAPIPool {
+ public:
+  TessBaseAPIPool();
+  ~TessBaseAPIPool();
+
+  /**
+   * Loads the shared models. The arguments are the same as for
+   * TessBaseAPI::Init and are also used to initialize every worker.
+   * Returns zero on success and -1 on failure.
+   */
+  int Init(const char* datapath, const char* language, OcrEngineMode oem,
+           char **configs, int configs_size,
+           const GenericVector<STRING> *vars_vec,
+           const GenericVector<STRING> *vars_values,
+           bool set_only_init_params);
+  int Init(const char* datapath, const char* language, OcrEngineMode oem) {
+    return Init(datapath, language, oem, NULL, 0, NULL, NULL, false);
+  }
+  int Init(const char* datapath, const char* language) {
+    return Init(datapath, language, OEM_DEFAULT, NULL, 0, NULL, NULL, false);
+  }
+
+  /**
+   * Returns an idle worker, creating a new one sharing the models if none is
+   * available. Returns NULL if the pool is not initialized or if the worker
+   * could not be initialized. The worker is owned by the pool and must be
+   * given back with Release.
+   */
+  TessBaseAPI* Acquire();
+
+  /**
+   * Gives a worker obtained from Acquire back to the pool. Its results,
+   * image and adaptive classifier are cleared, so the next page starts from
+   * the same state whichever worker processes it.
+   */
+  void Release(TessBaseAPI* api);
+
+  /** Number of workers created so far, busy or idle. */
+  int NumWorkers() const;
+
+  /**
+   * Deletes all the workers and the shared models. No worker may be in use.
+   * Init may be called again afterwards.
+   */
+  void End();
+
+ private:
+  // Owner of the shared models. Never handed out by Acquire.
+  TessBaseAPI* master_;
+  // All the workers, and the ones that are not currently acquired.
+  GenericVector<TessBaseAPI*> workers_;
+  GenericVector<TessBaseAPI*> idle_;
+  // Copies of the Init arguments needed to initialize new workers.
+  GenericVector<STRING> configs_;
+  GenericVector<STRING> vars_vec_;
+  GenericVector<STRING> vars_values_;
+  bool set_only_init_params_;
+  // Protects workers_ and idle_.
+  CCUtilMutex* mutex_;
+};
+
+}  // namespace tesseract.
+
+#endif  // TESSERACT_API_TESSPOOL_H__
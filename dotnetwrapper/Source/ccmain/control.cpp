@@ -243,6 +243,15 @@ void Tesseract::recog_all_words(PAGE_RES* page_res,
     stats_.good_char_count = 0;
     stats_.doc_good_char_quality = 0;
 
+    // With tessedit_pass1_threads, the words are first recognized in
+    // parallel, and the loop below only learns from them, in page order.
+    // With tessedit_pass1_share_adaptation, the adaptive classifier has
+    // already learned from them too, and only the document dictionary is
+    // left to do.
+    bool par_pass1 = target_word_box == NULL &&
+                     recog_pass1_par(page_res, monitor);
+    bool par_adapted = par_pass1 && tessedit_pass1_share_adaptation;
+
     while (page_res_it.word() != NULL) {
       set_global_loc_code(LOC_PASS1);
       word_index++;
@@ -260,8 +269,18 @@ void Tesseract::recog_all_words(PAGE_RES* page_res,
         page_res_it.forward();
         continue;
       }
-      classify_word_pass1(page_res_it.word(), page_res_it.row()->row,
-                          page_res_it.block()->block);
+      if (par_pass1) {
+        WERD_RES* word = page_res_it.word();
+        if (!word->tess_failed && !word->word->flag(W_REP_CHAR)) {
+          if (!par_adapted)
+            learn_word_pass1(word, word->best_choice->blob_choices());
+          else if (tessedit_enable_doc_dict)
+            tess_add_doc_word(word->best_choice);
+        }
+      } else {
+        classify_word_pass1(page_res_it.word(), page_res_it.row()->row,
+                            page_res_it.block()->block);
+      }
       if (page_res_it.word()->word->flag(W_REP_CHAR)) {
         fix_rep_char(&page_res_it);
         page_res_it.forward();
@@ -322,7 +341,7 @@ void Tesseract::recog_all_words(PAGE_RES* page_res,
     if (target_word_box &&
         !ProcessTargetWord(page_res_it.word()->word->bounding_box(),
                            *target_word_box, word_config, 2)) {
-      page_res_it.forward();
+      pass2_forward(&page_res_it, false);
       continue;
     }
     // end jetsoft
@@ -332,7 +351,7 @@ void Tesseract::recog_all_words(PAGE_RES* page_res,
     if (page_res_it.word()->word->flag(W_REP_CHAR) &&
         !page_res_it.word()->done) {
       fix_rep_char(&page_res_it);
-      page_res_it.forward();
+      pass2_forward(&page_res_it, target_word_box == NULL);
       continue;
     }
     if (tessedit_dump_choices) {
@@ -342,7 +361,7 @@ void Tesseract::recog_all_words(PAGE_RES* page_res,
               page_res_it.word()->best_choice->
                 debug_string(unicharset).string());
     }
-    page_res_it.forward();
+    pass2_forward(&page_res_it, target_word_box == NULL);
   }
 
   // ****************** Pass 3 *******************
@@ -479,73 +498,106 @@ void Tesseract::classify_word_pass1(WERD_RES *word,  // word to do
                                     ROW *row,
                                     BLOCK* block) {
   BLOB_CHOICE_LIST_CLIST *blob_choices = new BLOB_CHOICE_LIST_CLIST();
-  BOOL8 adapt_ok;
-  const char *rejmap;
-  inT16 index;
-  STRING mapstr = "";
 
+  bool learn = recog_word_pass1(word, row, block, blob_choices);
+  // Save best choices in the WERD_CHOICE if needed
+  word->best_choice->set_blob_choices(blob_choices);
+  // The adaptive classifier only learns the words of the main language, as
+  // the features of the other ones are classified with other templates.
+  if (!sub_langs_.empty() && recog_word_sub_langs(1, word, row, block))
+    return;
+  if (learn)
+    learn_word_pass1(word, word->best_choice->blob_choices());
+}
+
+/**
+ * recog_word_pass1
+ *
+ * Recognize the word and make its reject map. Returns true if the word was
+ * recognized and is not a repeated char, ie if learn_word_pass1 applies.
+ */
+
+bool Tesseract::recog_word_pass1(WERD_RES *word,  // word to do
+                                 ROW *row,
+                                 BLOCK* block,
+                                 BLOB_CHOICE_LIST_CLIST *blob_choices) {
   check_debug_pt(word, 0);
   if (word->SetupForRecognition(unicharset, classify_bln_numeric_mode,
                                 row, block))
     tess_segment_pass1(word, blob_choices);
-  if (!word->tess_failed) {
-    /*
-       The adaption step used to be here. It has been moved to after
-       make_reject_map so that we know whether the word will be accepted in the
-       first pass or not.   This move will PREVENT adaption to words containing
-       double quotes because the word will not be identical to what tess thinks
-       its best choice is. (See CurrentBestChoiceIs in
-       stopper.cpp which is used by AdaptableWord in
-       adaptmatch.cpp)
-     */
-
-    if (!word->word->flag(W_REP_CHAR)) {
-      // TODO(daria) delete these hacks when replaced by more generic code.
-      // Convert '' (double single) to " (single double).
-      fix_quotes(word, blob_choices);
-      if (tessedit_fix_hyphens)  // turn -- to -
-        fix_hyphens(word, blob_choices);
+  if (word->tess_failed || word->word->flag(W_REP_CHAR))
+    return false;
+  /*
+     The adaption step used to be here. It has been moved to after
+     make_reject_map so that we know whether the word will be accepted in the
+     first pass or not.   This move will PREVENT adaption to words containing
+     double quotes because the word will not be identical to what tess thinks
+     its best choice is. (See CurrentBestChoiceIs in
+     stopper.cpp which is used by AdaptableWord in
+     adaptmatch.cpp)
+   */
+
+  // TODO(daria) delete these hacks when replaced by more generic code.
+  // Convert '' (double single) to " (single double).
+  fix_quotes(word, blob_choices);
+  if (tessedit_fix_hyphens)  // turn -- to -
+    fix_hyphens(word, blob_choices);
+
+  word->tess_accepted = tess_acceptable_word(word->best_choice,
+    word->raw_choice);
+
+  word->tess_would_adapt = word->best_choice && word->raw_choice &&
+      AdaptableWord(word->rebuild_word,
+                    *word->best_choice,
+                    *word->raw_choice);
+                               // Also sets word->done flag
+  make_reject_map(word, blob_choices, row, 1);
+  return true;
+}
 
-      word->tess_accepted = tess_acceptable_word(word->best_choice,
-        word->raw_choice);
+/**
+ * learn_word_pass1
+ *
+ * Adapt to a word recognized by recog_word_pass1 if it is good enough, and
+ * add it to the document dictionary.
+ */
 
-      word->tess_would_adapt = word->best_choice && word->raw_choice &&
-          AdaptableWord(word->rebuild_word,
-                        *word->best_choice,
-                        *word->raw_choice);
-                                 // Also sets word->done flag
-      make_reject_map(word, blob_choices, row, 1);
+void Tesseract::learn_word_pass1(WERD_RES *word,
+                                 BLOB_CHOICE_LIST_CLIST *blob_choices) {
+  adapt_to_word_pass1(word, blob_choices);
+  if (tessedit_enable_doc_dict)
+    tess_add_doc_word(word->best_choice);
+}
+
+void Tesseract::adapt_to_word_pass1(WERD_RES *word,
+                                    BLOB_CHOICE_LIST_CLIST *blob_choices) {
+  BOOL8 adapt_ok;
+  const char *rejmap;
+  inT16 index;
+  STRING mapstr = "";
 
-      adapt_ok = word_adaptable(word, tessedit_tess_adaption_mode);
+  adapt_ok = word_adaptable(word, tessedit_tess_adaption_mode);
 
-      if (adapt_ok || tessedit_tess_adapt_to_rejmap) {
-        if (!tessedit_tess_adapt_to_rejmap) {
-          rejmap = NULL;
-        } else {
-          ASSERT_HOST(word->reject_map.length() ==
-                      word->best_choice->length());
-
-          for (index = 0; index < word->reject_map.length(); index++) {
-            if (adapt_ok || word->reject_map[index].accepted())
-              mapstr += '1';
-            else
-              mapstr += '0';
-          }
-          rejmap = mapstr.string();
-        }
-        // Send word to adaptive classifier for training.
-        word->BestChoiceToCorrectText(unicharset);
-        set_word_fonts(word, blob_choices);
-        LearnWord(NULL, rejmap, word);
+  if (adapt_ok || tessedit_tess_adapt_to_rejmap) {
+    if (!tessedit_tess_adapt_to_rejmap) {
+      rejmap = NULL;
+    } else {
+      ASSERT_HOST(word->reject_map.length() ==
+                  word->best_choice->length());
+
+      for (index = 0; index < word->reject_map.length(); index++) {
+        if (adapt_ok || word->reject_map[index].accepted())
+          mapstr += '1';
+        else
+          mapstr += '0';
       }
-
-      if (tessedit_enable_doc_dict)
-        tess_add_doc_word(word->best_choice);
+      rejmap = mapstr.string();
     }
+    // Send word to adaptive classifier for training.
+    word->BestChoiceToCorrectText(unicharset);
+    set_word_fonts(word, blob_choices);
+    LearnWord(NULL, rejmap, word);
   }
-
-  // Save best choices in the WERD_CHOICE if needed
-  word->best_choice->set_blob_choices(blob_choices);
 }
 
 // Helper to switch between the original and new xht word or to discard
@@ -584,6 +636,117 @@ static void SwitchWordOrDiscard(bool accept_new_word, WERD_RES* word,
   }
 }
 
+// Helper returns the id in to_unicharset of the given unichar id of
+// from_unicharset.
+static UNICHAR_ID ConvertUnicharId(const UNICHARSET& from_unicharset,
+                                   const UNICHARSET& to_unicharset,
+                                   UNICHAR_ID unichar_id) {
+  if (unichar_id < 0 || unichar_id >= from_unicharset.size())
+    return unichar_id;
+  return to_unicharset.unichar_to_id(
+      from_unicharset.id_to_unichar(unichar_id));
+}
+
+// Helper returns the font id given by font_map for the given font id.
+static inT16 ConvertFontId(const GenericVector<int>& font_map, int font_id) {
+  if (font_id < 0 || font_id >= font_map.size())
+    return -1;
+  return font_map[font_id];
+}
+
+// Helper converts the results of a word recognized by a sub-language from
+// the unichar ids of sub_unicharset to those of unicharset and from the font
+// ids of the sub-language to those of the main language.
+static void ConvertSubLangWord(const UNICHARSET& sub_unicharset,
+                               const GenericVector<int>& font_map,
+                               const UNICHARSET& unicharset,
+                               WERD_RES* word) {
+  WERD_CHOICE* choices[] = { word->best_choice, word->raw_choice };
+  for (int c = 0; c < 2; ++c) {
+    if (choices[c] == NULL)
+      continue;
+    for (int i = 0; i < choices[c]->length(); ++i) {
+      choices[c]->set_unichar_id(
+          ConvertUnicharId(sub_unicharset, unicharset,
+                           choices[c]->unichar_id(i)), i);
+    }
+    choices[c]->populate_unichars(unicharset);
+  }
+  if (word->best_choice != NULL && word->best_choice->blob_choices() != NULL) {
+    BLOB_CHOICE_LIST_C_IT bc_it(word->best_choice->blob_choices());
+    for (bc_it.mark_cycle_pt(); !bc_it.cycled_list(); bc_it.forward()) {
+      BLOB_CHOICE_IT choice_it(bc_it.data());
+      for (choice_it.mark_cycle_pt(); !choice_it.cycled_list();
+           choice_it.forward()) {
+        BLOB_CHOICE* choice = choice_it.data();
+        choice->set_unichar_id(ConvertUnicharId(sub_unicharset, unicharset,
+                                                choice->unichar_id()));
+        if (choice->script_id() >= 0) {
+          choice->set_script(unicharset.get_script_id_from_name(
+              sub_unicharset.get_script_from_script_id(choice->script_id())));
+        }
+        choice->set_fontinfo_id(ConvertFontId(font_map,
+                                              choice->fontinfo_id()));
+        choice->set_fontinfo_id2(ConvertFontId(font_map,
+                                               choice->fontinfo_id2()));
+      }
+    }
+  }
+  word->fontinfo_id = ConvertFontId(font_map, word->fontinfo_id);
+  word->fontinfo_id2 = ConvertFontId(font_map, word->fontinfo_id2);
+}
+
+// Helper returns true if new_word, recognized by a sub-language, is a better
+// reading than word: a dictionary word beats a non-dictionary word, and
+// otherwise the more certain one wins.
+static bool IsBetterSubLangWord(Dict* dict, const WERD_RES& word,
+                                const WERD_RES& new_word) {
+  if (new_word.tess_failed || new_word.best_choice == NULL)
+    return false;
+  if (word.tess_failed || word.best_choice == NULL)
+    return true;
+  bool dict_word = dict->valid_word_permuter(word.best_choice->permuter(),
+                                             false);
+  bool new_dict_word =
+      dict->valid_word_permuter(new_word.best_choice->permuter(), false);
+  if (dict_word != new_dict_word)
+    return new_dict_word;
+  return new_word.best_choice->certainty() > word.best_choice->certainty();
+}
+
+bool Tesseract::recog_word_sub_langs(int pass, WERD_RES *word,
+                                     ROW *row, BLOCK* block) {
+  if (word->word->flag(W_REP_CHAR))
+    return false;
+  // An accepted dictionary word of the main language is kept as it is.
+  if (!word->tess_failed && word->tess_accepted &&
+      word->best_choice != NULL &&
+      getDict().valid_word_permuter(word->best_choice->permuter(), false))
+    return false;
+  bool switched = false;
+  for (int i = 0; i < sub_langs_.size(); ++i) {
+    Tesseract* sub_lang = sub_langs_[i];
+    WERD_RES lang_word(word->word);
+    lang_word.x_height = word->x_height;
+    lang_word.caps_height = word->caps_height;
+    if (pass == 1) {
+      BLOB_CHOICE_LIST_CLIST *blob_choices = new BLOB_CHOICE_LIST_CLIST();
+      sub_lang->recog_word_pass1(&lang_word, row, block, blob_choices);
+      lang_word.best_choice->set_blob_choices(blob_choices);
+    } else {
+      sub_lang->match_word_pass2(&lang_word, row, block);
+    }
+    bool accept = IsBetterSubLangWord(&getDict(), *word, lang_word);
+    if (accept) {
+      ConvertSubLangWord(sub_lang->unicharset, sub_lang_font_maps_[i],
+                         unicharset, &lang_word);
+    }
+    SwitchWordOrDiscard(accept, word, &lang_word);
+    switched = switched || accept;
+  }
+  return switched;
+}
+
 // Helper to report the result of the xheight fix.
 void Tesseract::ReportXhtFixResult(bool accept_new_word, float new_x_ht,
                                    WERD_RES* word, WERD_RES* new_word) {
@@ -645,6 +808,17 @@ bool Tesseract::TrainedXheightFix(WERD_RES *word, BLOCK* block, ROW *row) {
   return false;
 }
 
+void Tesseract::pass2_forward(PAGE_RES_IT* page_res_it, bool report) {
+  page_res_it->forward();
+  // A repeated char word may have been replaced by one word per char, but
+  // the iterator still knows the row and block it has left.
+  if (report && line_done_cb_ != NULL && page_res_it->prev_row() != NULL &&
+      page_res_it->row() != page_res_it->prev_row()) {
+    line_done_cb_->Run(page_res_it->prev_block(), page_res_it->prev_row(),
+                       page_res_it->block() != page_res_it->prev_block());
+  }
+}
+
 /**
  * classify_word_pass2
  *
@@ -660,6 +834,8 @@ void Tesseract::classify_word_pass2(WERD_RES *word, BLOCK* block, ROW *row) {
     if (word->x_height == 0.0f)
       word->x_height = row->x_height();
     match_word_pass2(word, row, block);
+    if (!sub_langs_.empty())
+      recog_word_sub_langs(2, word, row, block);
     done_this_pass = TRUE;
     check_debug_pt(word, 40);
   }
@@ -233,6 +233,34 @@ bool Tesseract::init_cube_objects(bool load_combiner,
   return true;
 }
 
+/**********************************************************************
+ * load_cube_objects
+ *
+ * Loads the cube objects the first time they are needed, reading the
+ * cube components of the traineddata file again. Returns false if
+ * tessedit_ocr_engine_mode does not use cube or if it failed to load.
+ **********************************************************************/
+bool Tesseract::load_cube_objects() {
+  if (cube_cntxt_ != NULL)
+    return true;
+  bool load_combiner;
+  if (tessedit_ocr_engine_mode == OEM_CUBE_ONLY)
+    load_combiner = false;
+  else if (tessedit_ocr_engine_mode == OEM_TESSERACT_CUBE_COMBINED)
+    load_combiner = true;
+  else
+    return false;
+  if (!tessdata_manager.Reopen())
+    return false;
+  bool loaded = init_cube_objects(load_combiner, &tessdata_manager);
+  tessdata_manager.End();
+  if (loaded && tessdata_manager_debug_level) {
+    tprintf("Loaded Cube %s combiner\n",
+            load_combiner ? "with" : "w/out");
+  }
+  return loaded;
+}
+
 /**********************************************************************
  * run_cube
  *
@@ -243,7 +271,18 @@ bool Tesseract::init_cube_objects(bool load_combiner,
 void Tesseract::run_cube(
                          PAGE_RES *page_res  // page structure
                          ) {
-  ASSERT_HOST(cube_cntxt_ != NULL);
+  if (!load_cube_objects()) {
+    tprintf("Warning: cube failed to load, its words are left unrecognized\n");
+    if (page_res != NULL) {
+      PAGE_RES_IT page_res_it(page_res);
+      for (page_res_it.restart_page(); page_res_it.word() != NULL;
+           page_res_it.forward()) {
+        if (page_res_it.word()->best_choice == NULL)
+          page_res_it.DeleteCurrentWord();  // Nobody has an answer.
+      }
+    }
+    return;
+  }
   if (!pix_binary_) {
     if (cube_debug_level > 0)
       tprintf("Tesseract::run_cube(): NULL binary image.\n");
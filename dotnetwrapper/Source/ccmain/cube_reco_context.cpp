@@ -96,6 +96,14 @@ bool CubeRecoContext::GetDataFilePath(string *path) const {
   return true;
 }
 
+PageStats *CubeRecoContext::TesseractPageStats() const {
+  return tess_obj_ != NULL ? tess_obj_->page_stats() : NULL;
+}
+
+bool CubeRecoContext::BatchSegments() const {
+  return tess_obj_ != NULL && tess_obj_->cube_batch_segments;
+}
+
 // The object initialization function that loads all the necessary
 // components of a RecoContext.  TessdataManager is used to load the
 // data from [lang].traineddata file.  If TESSDATA_CUBE_UNICHARSET
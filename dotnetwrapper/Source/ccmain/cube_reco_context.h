@@ -34,6 +34,7 @@
 #include "word_size_model.h"
 #include "char_bigrams.h"
 #include "word_unigrams.h"
+#include "pagestats.h"
 
 namespace tesseract {
 
@@ -120,6 +121,12 @@ class CubeRecoContext {
   inline tesseract::Tesseract *TesseractObject() const {
     return tess_obj_;
   }
+  // Returns the page stats of the tesseract object, or NULL if none.
+  PageStats *TesseractPageStats() const;
+  // Returns true if the segment ranges of a word are classified in one
+  // batch, as set by the cube_batch_segments parameter of the tesseract
+  // object.
+  bool BatchSegments() const;
 
   // Returns the path of the data files
   bool GetDataFilePath(string *path) const;
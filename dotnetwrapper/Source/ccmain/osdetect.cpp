@@ -287,6 +287,11 @@ bool os_detect_blob(BLOBNBOX* bbox, OrientationDetector* o,
   FCOORD current_rotation(1.0f, 0.0f);
   FCOORD rotation90(0.0f, 1.0f);
   BLOB_CHOICE_LIST ratings[4];
+  // The 4 orientations are classified in a single batch.
+  DENORM denorms[4];
+  TBLOB* rotated_blobs[4];
+  const DENORM* denorm_ptrs[4];
+  BLOB_CHOICE_LIST* ratings_ptrs[4];
   // Test the 4 orientations
   for (int i = 0; i < 4; ++i) {
     // Normalize the blob. Set the origin to the place we want to be the
@@ -303,17 +308,19 @@ bool os_detect_blob(BLOBNBOX* bbox, OrientationDetector* o,
       scaling = static_cast<float>(kBlnXHeight) / box.width();
       x_origin = i == 1 ? box.left() : box.right();
     }
-    DENORM denorm;
-    denorm.SetupNormalization(NULL, NULL, &current_rotation, NULL, NULL, 0,
-                              x_origin, y_origin, scaling, scaling,
-                              0.0f, static_cast<float>(kBlnBaselineOffset));
-    TBLOB* rotated_blob = new TBLOB(*tblob);
-    rotated_blob->Normalize(denorm);
-    tess->set_denorm(&denorm);
-    tess->AdaptiveClassifier(rotated_blob, ratings + i, NULL);
-    delete rotated_blob;
+    denorms[i].SetupNormalization(NULL, NULL, &current_rotation, NULL, NULL,
+                                  0, x_origin, y_origin, scaling, scaling,
+                                  0.0f,
+                                  static_cast<float>(kBlnBaselineOffset));
+    rotated_blobs[i] = new TBLOB(*tblob);
+    rotated_blobs[i]->Normalize(denorms[i]);
+    denorm_ptrs[i] = &denorms[i];
+    ratings_ptrs[i] = &ratings[i];
     current_rotation.rotate(rotation90);
   }
+  tess->AdaptiveClassifierBatch(4, rotated_blobs, denorm_ptrs, ratings_ptrs);
+  for (int i = 0; i < 4; ++i)
+    delete rotated_blobs[i];
   delete tblob;
 
   bool stop = o->detect_blob(ratings);
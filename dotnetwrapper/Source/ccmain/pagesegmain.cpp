@@ -224,6 +224,7 @@ int Tesseract::AutoPageSeg(int resolution, bool single_column,
                            bool osd, bool only_osd,
                            BLOCK_LIST* blocks, TO_BLOCK_LIST* to_blocks,
                            Tesseract* osd_tess, OSResults* osr) {
+  PageStageTimer timer(page_stats(), PAGE_STAGE_AUTO_PAGESEG);
   int vertical_x = 0;
   int vertical_y = 1;
   TabVector_LIST v_lines;
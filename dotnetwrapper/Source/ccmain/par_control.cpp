@@ -0,0 +1,207 @@
+///////////////////////////////////////////////////////////////////////
+// File:        par_control.cpp
+// Description: Parallel recognition of the words of pass 1.
+//
+// (C) Copyright 2011, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+// Include automatically generated configuration file if running autoconf.
+#ifdef HAVE_CONFIG_H
+#include "config_auto.h"
+#endif
+
+#include "memry.h"
+#include "ocrclass.h"
+#include "pageres.h"
+#include "params.h"
+#include "tesseractclass.h"
+#include "threadpool.h"
+#include "tprintf.h"
+
+namespace tesseract {
+
+// The words of the page are recognized by the helper instances, which share
+// the models of this one and borrow its adapted templates and document
+// dictionary as they are at the start of the page. The helpers do not learn:
+// recog_all_words does the learning afterwards, in page order, so the results
+// do not depend on the number of threads or on the order the words are done.
+// The only context carried from one word to the next in pass 1 is the
+// hyphenated word at the end of a line, so a word is only given to another
+// thread than the previous one if the previous one does not end a line.
+bool Tesseract::recog_pass1_par(PAGE_RES* page_res, ETEXT_DESC* monitor) {
+  int num_threads = tessedit_pass1_threads;
+  // The ngram model conditions each word on the previous one, and the
+  // sub-languages have no helper instances.
+  if (num_threads <= 1 || language_model_->language_model_ngram_on ||
+      !sub_langs_.empty())
+    return false;
+  if (pass1_pool_ != NULL && pass1_pool_->num_threads() != num_threads)
+    end_pass1_workers();
+  if (pass1_pool_ == NULL) {
+    const char* arg0 = init_arg0_.length() > 0 ? init_arg0_.string() : NULL;
+    for (int t = 0; t < num_threads; ++t) {
+      Tesseract* worker = new Tesseract;
+      if (worker->init_tesseract_shared(arg0, NULL, lang.string(),
+                                        OEM_TESSERACT_ONLY, NULL, 0,
+                                        NULL, NULL, false, this) != 0) {
+        tprintf("Warning: failed to make pass 1 worker, running serially\n");
+        delete worker;
+        end_pass1_workers();
+        return false;
+      }
+      pass1_workers_.push_back(worker);
+    }
+    pass1_pool_ = new ThreadPool(num_threads);
+  }
+
+  PAGE_RES_IT page_res_it(page_res);
+  for (page_res_it.restart_page(); page_res_it.word() != NULL;
+       page_res_it.forward()) {
+    int index = pass1_words_.size();
+    if (index == 0 || !pass1_words_[index - 1]->word->flag(W_EOL))
+      pass1_runs_.push_back(index);
+    pass1_words_.push_back(page_res_it.word());
+    pass1_rows_.push_back(page_res_it.row()->row);
+    pass1_blocks_.push_back(page_res_it.block()->block);
+  }
+
+  // The adapted templates are made on the first use, which must not happen
+  // in a worker.
+  if (AdaptedTemplates == NULL)
+    AdaptedTemplates = NewAdaptedTemplates(true);
+  // With shared adaptation, the workers read copies of the adapted
+  // templates published in the store instead of the templates themselves,
+  // which are adapted to the words as they are done.
+  bool share_adaptation = tessedit_pass1_share_adaptation;
+  AdaptedTemplatesStore store;
+  if (share_adaptation) {
+    pass1_store_ = &store;
+    store.Publish(CopyAdaptedTemplates(AdaptedTemplates));
+    pass1_run_done_.init_to_size(pass1_runs_.size(), false);
+    pass1_next_adapt_run_ = 0;
+    pass1_adapting_ = false;
+    pass1_words_unpublished_ = 0;
+  }
+  for (int t = 0; t < pass1_workers_.size(); ++t) {
+    Tesseract* worker = pass1_workers_[t];
+    ParamUtils::CopyParams(params(), worker->params());
+    worker->SetBlackAndWhitelist();
+    if (share_adaptation)
+      worker->ReadAdaptedTemplatesFrom(pass1_store_);
+    else
+      worker->BorrowAdaptedTemplates(this);
+    worker->getDict().BorrowDocumentDictionary(&getDict());
+    worker->page_stats()->Clear();
+    worker->page_stats()->enabled = page_stats()->enabled;
+  }
+  pass1_monitor_ = monitor;
+
+  ThreadPoolTask* task =
+      NewPermanentTessCallback(this, &Tesseract::recog_pass1_item);
+  // The allocations of the calling thread are already counted by the api,
+  // and the pool runs the items on it if none of its threads started.
+  inT64 allocations = alloc_count();
+  pass1_pool_->Run(pass1_runs_.size(), task);
+  page_stats()->allocations -= alloc_count() - allocations;
+  delete task;
+
+  for (int t = 0; t < pass1_workers_.size(); ++t) {
+    pass1_workers_[t]->ReadAdaptedTemplatesFrom(NULL);
+    pass1_workers_[t]->BorrowAdaptedTemplates(NULL);
+    pass1_workers_[t]->getDict().BorrowDocumentDictionary(NULL);
+    page_stats()->Add(*pass1_workers_[t]->page_stats());
+  }
+  pass1_monitor_ = NULL;
+  pass1_store_ = NULL;
+  pass1_run_done_.clear();
+  pass1_words_.clear();
+  pass1_rows_.clear();
+  pass1_blocks_.clear();
+  pass1_runs_.clear();
+  return true;
+}
+
+void Tesseract::recog_pass1_item(int thread_index, int item) {
+  Tesseract* worker = pass1_workers_[thread_index];
+  // Forget any hyphenated word left by the previous run of this thread:
+  // the first call clears last_word_on_line_, the second the hyphen word.
+  worker->getDict().reset_hyphen_vars(false);
+  worker->getDict().reset_hyphen_vars(false);
+  int end = item + 1 < pass1_runs_.size() ? pass1_runs_[item + 1]
+                                          : pass1_words_.size();
+  inT64 allocations = alloc_count();
+  for (int w = pass1_runs_[item]; w < end; ++w) {
+    // The words left undone are never looked at, as recog_all_words
+    // returns on the same test.
+    if (pass1_monitor_ != NULL && pass1_monitor_->deadline_exceeded())
+      break;
+    WERD_RES* word = pass1_words_[w];
+    // Moves to the newest published templates, if shared.
+    worker->RefreshAdaptedTemplates();
+    BLOB_CHOICE_LIST_CLIST *blob_choices = new BLOB_CHOICE_LIST_CLIST();
+    worker->recog_word_pass1(word, pass1_rows_[w], pass1_blocks_[w],
+                             blob_choices);
+    word->best_choice->set_blob_choices(blob_choices);
+  }
+  if (pass1_store_ != NULL)
+    adapt_pass1_runs(item);
+  worker->page_stats()->allocations += alloc_count() - allocations;
+}
+
+// The runs are adapted to in page order, as recog_all_words does without
+// shared adaptation, by whichever thread finishes the run that comes next,
+// so only the words recognized after a publication see its adaptation.
+// The adapted templates of this instance are only touched by the thread
+// that holds pass1_adapting_, and the workers never see them, only copies.
+void Tesseract::adapt_pass1_runs(int item) {
+  pass1_mutex_.Lock();
+  pass1_run_done_[item] = true;
+  if (pass1_adapting_) {
+    pass1_mutex_.Unlock();
+    return;
+  }
+  pass1_adapting_ = true;
+  while (pass1_next_adapt_run_ < pass1_runs_.size() &&
+         pass1_run_done_[pass1_next_adapt_run_]) {
+    int run = pass1_next_adapt_run_++;
+    pass1_mutex_.Unlock();
+    int end = run + 1 < pass1_runs_.size() ? pass1_runs_[run + 1]
+                                           : pass1_words_.size();
+    for (int w = pass1_runs_[run]; w < end; ++w) {
+      // The words left undone by the deadline are not adapted to either.
+      if (pass1_monitor_ != NULL && pass1_monitor_->deadline_exceeded())
+        break;
+      WERD_RES* word = pass1_words_[w];
+      if (word->tess_failed || word->word->flag(W_REP_CHAR))
+        continue;
+      adapt_to_word_pass1(word, word->best_choice->blob_choices());
+      if (++pass1_words_unpublished_ >= tessedit_pass1_publish_words) {
+        pass1_store_->Publish(CopyAdaptedTemplates(AdaptedTemplates));
+        pass1_words_unpublished_ = 0;
+      }
+    }
+    pass1_mutex_.Lock();
+  }
+  pass1_adapting_ = false;
+  pass1_mutex_.Unlock();
+}
+
+void Tesseract::end_pass1_workers() {
+  // The threads of the pool may still reference the workers.
+  delete pass1_pool_;
+  pass1_pool_ = NULL;
+  pass1_workers_.delete_data_pointers();
+  pass1_workers_.clear();
+}
+
+}  // namespace tesseract
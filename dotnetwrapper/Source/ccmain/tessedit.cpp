@@ -115,6 +115,7 @@ bool Tesseract::init_tesseract_lang_data(
 		main_setup(arg0, textbase);
 #endif
 
+  init_arg0_ = arg0 != NULL ? arg0 : "";
   // Set the language data path prefix
   lang = language != NULL ? language : "eng";
   language_data_path_prefix = datadir;
@@ -134,6 +135,7 @@ bool Tesseract::init_tesseract_lang_data(
         tessdata_manager.GetDataFilePtr(),
         tessdata_manager.GetEndOffset(TESSDATA_LANG_CONFIG),
         false, this->params());
+    tessdata_manager.SetLoaded(TESSDATA_LANG_CONFIG);
     if (tessdata_manager_debug_level) {
       tprintf("Loaded language config file\n");
     }
@@ -191,6 +193,7 @@ bool Tesseract::init_tesseract_lang_data(
     return false;
   }
   right_to_left_ = unicharset.any_right_to_left();
+  tessdata_manager.SetLoaded(TESSDATA_UNICHARSET);
   if (tessdata_manager_debug_level) tprintf("Loaded unicharset\n");
 
   if (!tessedit_ambigs_training &&
@@ -199,34 +202,104 @@ bool Tesseract::init_tesseract_lang_data(
         tessdata_manager.GetDataFilePtr(),
         tessdata_manager.GetEndOffset(TESSDATA_AMBIGS),
         ambigs_debug_level, use_ambigs_for_adaption, &unicharset);
+    tessdata_manager.SetLoaded(TESSDATA_AMBIGS);
     if (tessdata_manager_debug_level) tprintf("Loaded ambigs\n");
   }
 
-  // Load Cube objects if necessary.
-  if (tessedit_ocr_engine_mode == OEM_CUBE_ONLY) {
-    ASSERT_HOST(init_cube_objects(false, &tessdata_manager));
-    if (tessdata_manager_debug_level)
-      tprintf("Loaded Cube w/out combiner\n");
-  } else if (tessedit_ocr_engine_mode == OEM_TESSERACT_CUBE_COMBINED) {
-    ASSERT_HOST(init_cube_objects(true, &tessdata_manager));
-    if (tessdata_manager_debug_level)
-      tprintf("Loaded Cube with combiner\n");
-  }
-
+  // The Cube objects are only loaded when Cube is first run, by
+  // load_cube_objects, as layout analysis alone does not need them.
   return true;
 }
 
+// Splits a language string such as "eng+deu+fra" into its languages.
+static void ParseLanguageString(const char *language,
+                                GenericVector<STRING> *langs) {
+  STRING lang_str;
+  for (const char *s = language; ; ++s) {
+    if (*s == '+' || *s == '\0') {
+      if (lang_str.length() > 0)
+        langs->push_back(lang_str);
+      lang_str = "";
+      if (*s == '\0')
+        break;
+    } else {
+      lang_str += *s;
+    }
+  }
+}
+
+// The language may be a list of languages separated by '+', eg "eng+deu".
+// The first one is the main language, which the engine mode, cube and the
+// page layout apply to. The others are sub-languages, loaded for the
+// Tesseract engine only, whose unichars are added to the unicharset of the
+// main language and which each word is also recognized with.
 int Tesseract::init_tesseract(
     const char *arg0, const char *textbase, const char *language,
     OcrEngineMode oem, char **configs, int configs_size,
     const GenericVector<STRING> *vars_vec,
     const GenericVector<STRING> *vars_values,
     bool set_only_init_params) {
-  if (!init_tesseract_lang_data(arg0, textbase, language, oem, configs,
-                                configs_size, vars_vec, vars_values,
-                                set_only_init_params)) {
+  end_sub_langs();
+  GenericVector<STRING> langs;
+  if (language != NULL)
+    ParseLanguageString(language, &langs);
+  if (!init_tesseract_lang_data(arg0, textbase,
+                                langs.empty() ? NULL : langs[0].string(),
+                                oem, configs, configs_size, vars_vec,
+                                vars_values, set_only_init_params)) {
     return -1;
   }
+  for (int i = 1; i < langs.size(); ++i) {
+    Tesseract *sub_lang = new Tesseract;
+    if (!sub_lang->init_tesseract_lang_data(arg0, textbase, langs[i].string(),
+                                            OEM_TESSERACT_ONLY, configs,
+                                            configs_size, vars_vec,
+                                            vars_values,
+                                            set_only_init_params)) {
+      tprintf("Error: failed to load language %s\n", langs[i].string());
+      delete sub_lang;
+      end_sub_langs();
+      tessdata_manager.End();
+      return -1;
+    }
+    sub_langs_.push_back(sub_lang);
+    unicharset.AppendOtherUnicharset(sub_lang->unicharset);
+  }
+  if (unicharset.size() > MAX_NUM_CLASSES) {
+    tprintf("Error: Size of combined unicharset is greater than"
+            " MAX_NUM_CLASSES\n");
+    end_sub_langs();
+    tessdata_manager.End();
+    return -1;
+  }
+  init_tesseract_models(textbase);
+  for (int i = 0; i < sub_langs_.size(); ++i) {
+    Tesseract *sub_lang = sub_langs_[i];
+    // The punctuation and number dawgs are often the same for all the
+    // languages of a script, so the ones of the main language are used.
+    sub_lang->getDict().set_dawg_donor(&getDict());
+    sub_lang->init_tesseract_models(textbase);
+    // The font tables are not shared, as the spacing info of a font is
+    // indexed by the unichar ids of the language, so the fonts are matched
+    // by name instead.
+    const UnicityTable<FontInfo> &sub_fonts = sub_lang->get_fontinfo_table();
+    GenericVector<int> font_map;
+    for (int f = 0; f < sub_fonts.size(); ++f) {
+      int font_id = -1;
+      for (int m = 0; m < fontinfo_table_.size() && font_id < 0; ++m) {
+        if (strcmp(sub_fonts.get(f).name, fontinfo_table_.get(m).name) == 0)
+          font_id = m;
+      }
+      font_map.push_back(font_id);
+    }
+    sub_lang_font_maps_.push_back(font_map);
+  }
+  return 0;                      //Normal exit
+}
+
+// Loads the models of the language whose data was opened by
+// init_tesseract_lang_data, and closes the data file.
+void Tesseract::init_tesseract_models(const char *textbase) {
   // If only Cube will be used, skip loading Tesseract classifier's
   // pre-trained templates.
   bool init_tesseract_classifier =
@@ -239,6 +312,37 @@ int Tesseract::init_tesseract(
       tessdata_manager.SeekToStart(TESSDATA_CUBE_UNICHARSET));
   program_editup(textbase, init_tesseract_classifier, init_dict);
   tessdata_manager.End();
+}
+
+int Tesseract::init_tesseract_shared(
+    const char *arg0, const char *textbase, const char *language,
+    OcrEngineMode oem, char **configs, int configs_size,
+    const GenericVector<STRING> *vars_vec,
+    const GenericVector<STRING> *vars_values,
+    bool set_only_init_params, Tesseract* master) {
+  if (!master->sub_langs_.empty()) {
+    tprintf("Error: models of several languages cannot be shared\n");
+    return -1;
+  }
+  // The params, unicharset (which carries the per-instance white/blacklist)
+  // and ambigs are small and are still read for each instance, as are the
+  // cube objects.
+  if (!init_tesseract_lang_data(arg0, textbase, language, oem, configs,
+                                configs_size, vars_vec, vars_values,
+                                set_only_init_params)) {
+    return -1;
+  }
+  if (master->lang != lang ||
+      master->unicharset.size() != unicharset.size()) {
+    tprintf("Error: shared models were loaded for a different language\n");
+    tessdata_manager.End();
+    return -1;
+  }
+  bool init_dict =
+    !(tessedit_ocr_engine_mode == OEM_CUBE_ONLY &&
+      tessdata_manager.SeekToStart(TESSDATA_CUBE_UNICHARSET));
+  program_editup_shared(textbase, master, init_dict);
+  tessdata_manager.End();
   return 0;                      //Normal exit
 }
 
@@ -255,9 +359,29 @@ int Tesseract::init_tesseract_lm(const char *arg0,
 }
 
 void Tesseract::end_tesseract() {
+  if (tessdata_manager_debug_level) {
+    // Some components are only loaded on their first use, so this tells
+    // which ones the recognition needed.
+    tprintf("Language data components loaded:");
+    for (int i = 0; i < TESSDATA_NUM_ENTRIES; ++i) {
+      if (tessdata_manager.IsLoaded(static_cast<TessdataType>(i)))
+        tprintf(" %s", kTessdataFileSuffixes[i]);
+    }
+    tprintf("\n");
+  }
+  // The sub-languages borrow dawgs of this instance, so they go first.
+  for (int i = 0; i < sub_langs_.size(); ++i)
+    sub_langs_[i]->end_tesseract();
+  end_sub_langs();
   end_recog();
 }
 
+void Tesseract::end_sub_langs() {
+  sub_langs_.delete_data_pointers();
+  sub_langs_.clear();
+  sub_lang_font_maps_.clear();
+}
+
 /* Define command type identifiers */
 
 enum CMD_EVENTS
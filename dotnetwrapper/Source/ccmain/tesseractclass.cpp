@@ -155,6 +155,9 @@ Tesseract::Tesseract()
     double_MEMBER(test_pt_x, 99999.99, "xcoord", this->params()),
     double_MEMBER(test_pt_y, 99999.99, "ycoord", this->params()),
     INT_MEMBER(cube_debug_level, 1, "Print cube debug info.", this->params()),
+    BOOL_MEMBER(cube_batch_segments, true, "Classify all the segment ranges"
+                " of a cube word with one batch of the char classifier",
+                this->params()),
     STRING_MEMBER(outlines_odd, "%| ", "Non standard number of outlines",
                   this->params()),
     STRING_MEMBER(outlines_2, "ij!?%\":;",
@@ -346,6 +349,19 @@ Tesseract::Tesseract()
                 "Output text with boxes", this->params()),
     INT_MEMBER(tessedit_page_number, -1, "-1 -> All pages"
                " , else specifc page to process", this->params()),
+    INT_MEMBER(tessedit_pass1_threads, 0, "Number of threads recognizing"
+               " the words of pass 1 (0 or 1 = serial, adaptation is deferred"
+               " to the end of pass 1)", this->params()),
+    BOOL_MEMBER(tessedit_pass1_share_adaptation, false, "Adapt to the words"
+                " of a parallel pass 1 while it runs and share the adapted"
+                " templates with its threads (results then depend on the"
+                " timing of the threads)", this->params()),
+    INT_MEMBER(tessedit_pass1_publish_words, 16, "Number of words adapted to"
+               " between publications of the adapted templates to the"
+               " threads of pass 1", this->params()),
+    BOOL_MEMBER(tessedit_page_stats, false,
+                "Record the time spent in each stage of the page",
+                this->params()),
     BOOL_MEMBER(tessedit_write_images, false,
                 "Capture the image from the IPE", this->params()),
     BOOL_MEMBER(interactive_mode, false, "Run interactively?", this->params()),
@@ -364,12 +380,21 @@ Tesseract::Tesseract()
     right_to_left_(false),
     deskew_(1.0f, 0.0f),
     reskew_(1.0f, 0.0f),
+    pass1_pool_(NULL),
+    pass1_monitor_(NULL),
+    pass1_store_(NULL),
+    pass1_next_adapt_run_(0),
+    pass1_adapting_(false),
+    pass1_words_unpublished_(0),
+    line_done_cb_(NULL),
     cube_cntxt_(NULL),
     tess_cube_combiner_(NULL) {
 }
 
 Tesseract::~Tesseract() {
   Clear();
+  end_pass1_workers();
+  end_sub_langs();
   // Delete cube objects.
   if (cube_cntxt_ != NULL) {
     delete cube_cntxt_;
@@ -398,6 +423,30 @@ void Tesseract::SetBlackAndWhitelist() {
   // Set the white and blacklists (if any)
   unicharset.set_black_and_whitelist(tessedit_char_blacklist.string(),
                                      tessedit_char_whitelist.string());
+  // This is done before each page, when the lists and the other parameters
+  // of the classifier may have changed, so the blob classifications cached
+  // on the previous pages are dropped.
+  InvalidateBlobClassCache();
+  for (int i = 0; i < sub_langs_.size(); ++i) {
+    sub_langs_[i]->unicharset.set_black_and_whitelist(
+        tessedit_char_blacklist.string(), tessedit_char_whitelist.string());
+    sub_langs_[i]->InvalidateBlobClassCache();
+  }
+}
+
+void Tesseract::ResetPageStats() {
+  page_stats()->Clear();
+  page_stats()->enabled = tessedit_page_stats;
+  for (int i = 0; i < sub_langs_.size(); ++i) {
+    sub_langs_[i]->page_stats()->Clear();
+    sub_langs_[i]->page_stats()->enabled = tessedit_page_stats;
+  }
+}
+
+void Tesseract::GetPageStats(PageStats* stats) {
+  *stats = *page_stats();
+  for (int i = 0; i < sub_langs_.size(); ++i)
+    stats->Add(*sub_langs_[i]->page_stats());
 }
 
 // Perform steps to prepare underlying binary image/other data structures for
@@ -24,6 +24,7 @@
 #include "allheaders.h"
 #include "genericvector.h"
 #include "params.h"
+#include "tesscallback.h"
 #include "wordrec.h"
 #include "ocrclass.h"
 #include "control.h"
@@ -33,6 +34,8 @@
 
 class PAGE_RES;
 class PAGE_RES_IT;
+class BLOCK_RES;
+class ROW_RES;
 class BLOCK_LIST;
 class CharSamp;
 class TO_BLOCK_LIST;
@@ -96,6 +99,12 @@ class CubeLineObject;
 class CubeObject;
 class CubeRecoContext;
 class TesseractCubeCombiner;
+class ThreadPool;
+
+// Run by recog_all_words for each textline as soon as all its words are
+// through pass 2, with the block and row of the line and whether it is the
+// last line of its block.
+typedef TessCallback3<BLOCK_RES*, ROW_RES*, bool> LineDoneCallback;
 
 // A collection of various variables for statistics and debugging.
 struct TesseractStats {
@@ -180,6 +189,12 @@ class Tesseract : public Wordrec {
 
   void SetBlackAndWhitelist();
 
+  // Clears the page stats of this instance and of its sub-languages, and
+  // enables them if tessedit_page_stats is set.
+  void ResetPageStats();
+  // Sets stats to the page stats of this instance and its sub-languages.
+  void GetPageStats(PageStats* stats);
+
   // Perform steps to prepare underlying binary image/other data structures for
   // page segmentation. Uses the strategy specified in the global variable
   // pageseg_devanagari_split_strategy for perform splitting while preparing for
@@ -218,10 +233,49 @@ class Tesseract : public Wordrec {
                            WERD_RES *word,  //word to do
                            ROW *row,
                            BLOCK* block);
+  // The two halves of classify_word_pass1: recog_word_pass1 recognizes the
+  // word without changing the adaptive classifier or the document dictionary,
+  // and returns true if the word is one that learn_word_pass1 should then
+  // learn from.
+  bool recog_word_pass1(WERD_RES *word, ROW *row, BLOCK* block,
+                        BLOB_CHOICE_LIST_CLIST *blob_choices);
+  void learn_word_pass1(WERD_RES *word, BLOB_CHOICE_LIST_CLIST *blob_choices);
+  // The part of learn_word_pass1 that adapts the classifier to the word.
+  void adapt_to_word_pass1(WERD_RES *word,
+                           BLOB_CHOICE_LIST_CLIST *blob_choices);
+  // Recognizes the word, already recognized by this instance in the given
+  // pass, with each of the sub_langs_ too, and keeps the best result in the
+  // unichar and font ids of this instance. Returns true if the result of a
+  // sub-language was kept.
+  bool recog_word_sub_langs(int pass, WERD_RES *word, ROW *row, BLOCK* block);
   void recog_pseudo_word(PAGE_RES* page_res,  // blocks to check
                          TBOX &selection_box);
 
   void fix_rep_char(PAGE_RES_IT* page_res_it);
+  // Moves page_res_it to the next word of pass 2 and, if report is true,
+  // runs line_done_cb_ for the textline it leaves, if any.
+  void pass2_forward(PAGE_RES_IT* page_res_it, bool report);
+  // Sets the callback run by recog_all_words for each finished textline.
+  // The callback is not owned. NULL for none.
+  void set_line_done_callback(LineDoneCallback* cb) {
+    line_done_cb_ = cb;
+  }
+
+  //// par_control.cpp ///////////////////////////////////////////////////
+  // Runs recog_word_pass1 on all the words of the page with
+  // tessedit_pass1_threads helper instances that share the models and the
+  // current adapted templates of this one. Returns false, having done
+  // nothing, if the page has to be recognized serially.
+  bool recog_pass1_par(PAGE_RES* page_res, ETEXT_DESC* monitor);
+  // Task of the pass 1 thread pool: recognizes one run of words.
+  void recog_pass1_item(int thread_index, int item);
+  // With tessedit_pass1_share_adaptation, marks the given run of words as
+  // recognized, and adapts to the recognized runs that come next in page
+  // order unless another thread is already doing so, publishing the
+  // adapted templates to the helpers as it goes.
+  void adapt_pass1_runs(int item);
+  // Deletes the helper instances of recog_pass1_par.
+  void end_pass1_workers();
   void ExplodeRepeatedWord(BLOB_CHOICE* best_choice, PAGE_RES_IT* page_res_it);
 
   // Callback helper for fix_quotes returns a double quote if both
@@ -263,6 +317,9 @@ class Tesseract : public Wordrec {
   //// cube_control.cpp ///////////////////////////////////////////////////
   bool init_cube_objects(bool load_combiner,
                          TessdataManager *tessdata_manager);
+  // Loads the cube objects on their first use if tessedit_ocr_engine_mode
+  // needs them. Returns true if they are loaded.
+  bool load_cube_objects();
   void run_cube(PAGE_RES *page_res);
   void cube_recognize(CubeObject *cube_obj, PAGE_RES_IT *page_res_it);
   void fill_werd_res(const BoxWord& cube_box_word,
@@ -304,12 +361,28 @@ class Tesseract : public Wordrec {
                           NULL, 0, NULL, NULL, false);
   }
 
+  // Same as init_tesseract, but shares the read-only classifier templates,
+  // normprotos, font tables and dawgs of master, which must have been
+  // initialized with the same language and must outlive this instance.
+  int init_tesseract_shared(const char *arg0,
+                            const char *textbase,
+                            const char *language,
+                            OcrEngineMode oem,
+                            char **configs,
+                            int configs_size,
+                            const GenericVector<STRING> *vars_vec,
+                            const GenericVector<STRING> *vars_values,
+                            bool set_only_init_params,
+                            Tesseract* master);
+
   int init_tesseract_lm(const char *arg0,
                         const char *textbase,
                         const char *language);
 
   void recognize_page(STRING& image_name);
   void end_tesseract();
+  // Deletes the sub-languages of a multi-language init_tesseract.
+  void end_sub_langs();
 
   bool init_tesseract_lang_data(const char *arg0,
                                 const char *textbase,
@@ -320,6 +393,7 @@ class Tesseract : public Wordrec {
                                 const GenericVector<STRING> *vars_vec,
                                 const GenericVector<STRING> *vars_values,
                                 bool set_only_init_params);
+  void init_tesseract_models(const char *textbase);
 
   //// pgedit.h //////////////////////////////////////////////////////////
   SVMenuNode *build_menu_new();
@@ -656,6 +730,8 @@ class Tesseract : public Wordrec {
   double_VAR_H(test_pt_x, 99999.99, "xcoord");
   double_VAR_H(test_pt_y, 99999.99, "ycoord");
   INT_VAR_H(cube_debug_level, 1, "Print cube debug info.");
+  BOOL_VAR_H(cube_batch_segments, true, "Classify all the segment ranges"
+             " of a cube word with one batch of the char classifier");
   STRING_VAR_H(outlines_odd, "%| ", "Non standard number of outlines");
   STRING_VAR_H(outlines_2, "ij!?%\":;", "Non standard number of outlines");
   BOOL_VAR_H(docqual_excuse_outline_errs, false,
@@ -787,6 +863,18 @@ class Tesseract : public Wordrec {
   BOOL_VAR_H(tessedit_create_boxfile, false, "Output text with boxes");
   INT_VAR_H(tessedit_page_number, -1,
             "-1 -> All pages, else specifc page to process");
+  INT_VAR_H(tessedit_pass1_threads, 0,
+            "Number of threads recognizing the words of pass 1 (0 or 1 = "
+            "serial, adaptation is deferred to the end of pass 1)");
+  BOOL_VAR_H(tessedit_pass1_share_adaptation, false,
+             "Adapt to the words of a parallel pass 1 while it runs and share"
+             " the adapted templates with its threads (results then depend on"
+             " the timing of the threads)");
+  INT_VAR_H(tessedit_pass1_publish_words, 16,
+            "Number of words adapted to between publications of the adapted"
+            " templates to the threads of pass 1");
+  BOOL_VAR_H(tessedit_page_stats, false,
+             "Record the time spent in each stage of the page");
   BOOL_VAR_H(tessedit_write_images, false, "Capture the image from the IPE");
   BOOL_VAR_H(interactive_mode, false, "Run interactively?");
   STRING_VAR_H(file_type, ".tif", "Filename extension");
@@ -835,6 +923,35 @@ class Tesseract : public Wordrec {
   FCOORD deskew_;
   FCOORD reskew_;
   TesseractStats stats_;
+  // Program name or datapath given to init_tesseract, to initialize the
+  // helper instances of recog_pass1_par in the same way.
+  STRING init_arg0_;
+  // Helper instances of recog_pass1_par, one per thread of pass1_pool_.
+  GenericVector<Tesseract*> pass1_workers_;
+  ThreadPool* pass1_pool_;
+  // Words of the page being recognized by recog_pass1_par, and the index of
+  // the first word of each run of words given to one thread.
+  GenericVector<WERD_RES*> pass1_words_;
+  GenericVector<ROW*> pass1_rows_;
+  GenericVector<BLOCK*> pass1_blocks_;
+  GenericVector<int> pass1_runs_;
+  ETEXT_DESC* pass1_monitor_;
+  // With tessedit_pass1_share_adaptation, the adapted templates published
+  // to the helpers, and under pass1_mutex_, which runs are recognized, the
+  // next run to adapt to, and whether a thread is adapting.
+  AdaptedTemplatesStore* pass1_store_;
+  CCUtilMutex pass1_mutex_;
+  GenericVector<bool> pass1_run_done_;
+  int pass1_next_adapt_run_;
+  bool pass1_adapting_;
+  int pass1_words_unpublished_;
+  LineDoneCallback* line_done_cb_;
+  // The other languages of a multi-language init_tesseract, eg deu and fra
+  // for "eng+deu+fra". Their unichars are in the unicharset of this instance.
+  GenericVector<Tesseract*> sub_langs_;
+  // For each of sub_langs_, the font id in this instance of each font id of
+  // the sub-language, or -1 if this instance has no font of that name.
+  GenericVector<GenericVector<int> > sub_lang_font_maps_;
   // Cube objects.
   CubeRecoContext* cube_cntxt_;
   TesseractCubeCombiner *tess_cube_combiner_;
@@ -60,7 +60,11 @@ bool ImageThresholder::IsEmpty() const {
 // SetImage makes a copy of only the metadata, not the underlying
 // image buffer. It promises to treat the source as read-only in either case,
 // but in return assumes that the Pix or image buffer remain valid
-// throughout the life of the ImageThresholder.
+// throughout the life of the ImageThresholder, or until the next SetImage
+// or Clear.
+// The buffer is a view: ThresholdToPix, GetPixRect and GetPixRectGrey read
+// the rectangle straight from it, with any bytes_per_line, and only write
+// the Pix they return, so nothing is copied that does not need converting.
 // Greyscale of 8 and color of 24 or 32 bits per pixel may be given.
 // Palette color images will not work properly and must be converted to
 // 24 bit.
@@ -148,15 +152,10 @@ void ImageThresholder::ThresholdToPix(Pix** pix) {
         OtsuThresholdRectToPix(reinterpret_cast<const uinT8*>(data),
                                image_bytespp_, image_bytespl_, pix);
       } else {
-        // Convert 8-bit to IMAGE and then pass its
-        // buffer to the raw interface to complete the conversion.
-        IMAGE temp_image;
-        temp_image.FromPix(pix_);
-        OtsuThresholdRectToPix(temp_image.get_buffer(),
-                               image_bytespp_,
-                               COMPUTE_IMAGE_XDIM(temp_image.get_xsize(),
-                                                  temp_image.get_bpp()),
-                               pix);
+        // The bytes of an 8-bit Pix are not in pixel order within each
+        // word, so it is read with the Pix accessors rather than copied
+        // into a raw buffer first.
+        OtsuThresholdGreyPixRectToPix(pix);
       }
     }
     return;
@@ -204,6 +203,13 @@ Pix* ImageThresholder::GetPixRect() {
 // the layout analysis that uses it will only be available with Leptonica,
 // so there is no raw equivalent.
 Pix* ImageThresholder::GetPixRectGrey() {
+  if (pix_ == NULL && image_bytespp_ > 0) {
+    // Convert the raw rectangle straight to grey, without the full color
+    // copy that GetPixRect would make.
+    Pix* grey_pix;
+    RawRectToGreyPix(&grey_pix);
+    return grey_pix;
+  }
   Pix* pix = GetPixRect();  // May have to be reduced to grey.
   int depth = pixGetDepth(pix);
   if (depth != 8) {
@@ -234,6 +240,41 @@ void ImageThresholder::OtsuThresholdRectToPix(const unsigned char* imagedata,
   delete [] hi_values;
 }
 
+// Otsu threshold the rectangle of the 8-bit source pix_ to the output Pix,
+// reading the source in place.
+void ImageThresholder::OtsuThresholdGreyPixRectToPix(Pix** pix) const {
+  const uinT32* srcdata = pixGetData(pix_);
+  int src_wpl = pixGetWpl(pix_);
+  int histogram[kHistogramSize];
+  memset(histogram, 0, sizeof(histogram));
+  for (int y = 0; y < rect_height_; ++y) {
+    const uinT32* srcline = srcdata + (rect_top_ + y) * src_wpl;
+    for (int x = 0; x < rect_width_; ++x)
+      ++histogram[GET_DATA_BYTE(srcline, rect_left_ + x)];
+  }
+  int* thresholds;
+  int* hi_values;
+  OtsuThresholdHistograms(histogram, 1, &thresholds, &hi_values);
+
+  *pix = pixCreate(rect_width_, rect_height_, 1);
+  uinT32* pixdata = pixGetData(*pix);
+  int wpl = pixGetWpl(*pix);
+  for (int y = 0; y < rect_height_; ++y) {
+    const uinT32* srcline = srcdata + (rect_top_ + y) * src_wpl;
+    uinT32* pixline = pixdata + y * wpl;
+    for (int x = 0; x < rect_width_; ++x) {
+      int value = GET_DATA_BYTE(srcline, rect_left_ + x);
+      if (hi_values[0] >= 0 &&
+          (value > thresholds[0]) == (hi_values[0] == 0))
+        SET_DATA_BIT(pixline, x);
+      else
+        CLEAR_DATA_BIT(pixline, x);
+    }
+  }
+  delete [] thresholds;
+  delete [] hi_values;
+}
+
 // Threshold the rectangle, taking everything except the image buffer pointer
 // from the class, using thresholds/hi_values to the output IMAGE.
 void ImageThresholder::ThresholdRectToPix(const unsigned char* imagedata,
@@ -269,44 +310,71 @@ void ImageThresholder::ThresholdRectToPix(const unsigned char* imagedata,
 }
 
 // Copy the raw image rectangle, taking all data from the class, to the Pix.
+// The rectangle is read in place from the source buffer in a single pass.
 void ImageThresholder::RawRectToPix(Pix** pix) const {
-  if (image_bytespp_ < 4) {
-    // Go via a tesseract image structure (doesn't copy the data)
-    // and use ToPix.
-    IMAGE image;
-    int bits_per_pixel = image_bytespp_ * 8;
-    if (image_bytespp_ == 0)
-      bits_per_pixel = 1;
-    image.capture(const_cast<uinT8*>(image_data_),
-                  image_width_, rect_top_ + rect_height_, bits_per_pixel);
-    if (IsFullImage()) {
-      *pix = image.ToPix();
+  int depth = image_bytespp_ == 0 ? 1 : (image_bytespp_ == 1 ? 8 : 32);
+  *pix = pixCreate(rect_width_, rect_height_, depth);
+  uinT32* data = pixGetData(*pix);
+  int wpl = pixGetWpl(*pix);
+  const uinT8* imagedata = image_data_ + rect_top_ * image_bytespl_;
+  for (int y = 0; y < rect_height_; ++y) {
+    uinT32* line = data + y * wpl;
+    if (image_bytespp_ == 0) {
+      // In the source a one bit is white. In the Pix it is black.
+      for (int x = 0; x < rect_width_; ++x) {
+        int src_x = rect_left_ + x;
+        if (imagedata[src_x >> 3] & (0x80 >> (src_x & 7)))
+          CLEAR_DATA_BIT(line, x);
+        else
+          SET_DATA_BIT(line, x);
+      }
     } else {
-      IMAGE rect;
-      rect.create(rect_width_, rect_height_, bits_per_pixel);
-      // The capture chopped the image off at top+height, so copy
-      // the rectangle with y = 0 to get a rectangle of height
-      // starting at the bottom, since copy_sub_image uses bottom-up coords.
-      copy_sub_image(&image, rect_left_, 0, rect_width_, rect_height_,
-                     &rect, 0, 0, true);
-      *pix = rect.ToPix();
+      const uinT8* linedata = imagedata + rect_left_ * image_bytespp_;
+      if (image_bytespp_ == 1) {
+        for (int x = 0; x < rect_width_; ++x)
+          SET_DATA_BYTE(line, x, linedata[x]);
+      } else if (image_bytespp_ == 3) {
+        // Put the colors in the correct places in the pixel.
+        for (int x = 0; x < rect_width_; ++x, linedata += 3) {
+          SET_DATA_BYTE(line + x, COLOR_RED, linedata[RED_PIX]);
+          SET_DATA_BYTE(line + x, COLOR_GREEN, linedata[GREEN_PIX]);
+          SET_DATA_BYTE(line + x, COLOR_BLUE, linedata[BLUE_PIX]);
+        }
+      } else {
+        for (int x = 0; x < rect_width_; ++x, linedata += 4) {
+          line[x] = (linedata[0] << 24) | (linedata[1] << 16) |
+                    (linedata[2] << 8) | linedata[3];
+        }
+      }
     }
-  } else {
-    *pix = pixCreate(rect_width_, rect_height_, 32);
-    uinT32* data = pixGetData(*pix);
-    int wpl = pixGetWpl(*pix);
-    const uinT8* imagedata = image_data_ + rect_top_ * image_bytespl_ +
-                             rect_left_ * image_bytespp_;
-    for (int y = 0; y < rect_height_; ++y) {
-      const uinT8* linedata = imagedata;
-      uinT32* line = data + y * wpl;
-      for (int x = 0; x < rect_width_; ++x) {
-        line[x] = (linedata[0] << 24) | (linedata[1] << 16) |
-                  (linedata[2] << 8) | linedata[3];
-        linedata += 4;
+    imagedata += image_bytespl_;
+  }
+}
+
+// Convert the raw image rectangle of grey or color, taking all data from the
+// class, to an 8-bit grey Pix, reading the source buffer in place. Color is
+// reduced with the same weights as pixConvertRGBToLuminance.
+void ImageThresholder::RawRectToGreyPix(Pix** pix) const {
+  *pix = pixCreate(rect_width_, rect_height_, 8);
+  uinT32* data = pixGetData(*pix);
+  int wpl = pixGetWpl(*pix);
+  const uinT8* imagedata = image_data_ + rect_top_ * image_bytespl_ +
+                           rect_left_ * image_bytespp_;
+  for (int y = 0; y < rect_height_; ++y) {
+    const uinT8* linedata = imagedata;
+    uinT32* line = data + y * wpl;
+    if (image_bytespp_ == 1) {
+      for (int x = 0; x < rect_width_; ++x)
+        SET_DATA_BYTE(line, x, linedata[x]);
+    } else {
+      for (int x = 0; x < rect_width_; ++x, linedata += image_bytespp_) {
+        int grey = static_cast<int>(L_RED_WEIGHT * linedata[RED_PIX] +
+                                    L_GREEN_WEIGHT * linedata[GREEN_PIX] +
+                                    L_BLUE_WEIGHT * linedata[BLUE_PIX] + 0.5);
+        SET_DATA_BYTE(line, x, grey);
       }
-      imagedata += image_bytespl_;
     }
+    imagedata += image_bytespl_;
   }
 }
 
@@ -45,7 +45,11 @@ class ImageThresholder {
   /// SetImage makes a copy of only the metadata, not the underlying
   /// image buffer. It promises to treat the source as read-only in either case,
   /// but in return assumes that the Pix or image buffer remain valid
-  /// throughout the life of the ImageThresholder.
+  /// throughout the life of the ImageThresholder, or until the next SetImage
+  /// or Clear.
+  /// The buffer is a view: ThresholdToPix, GetPixRect and GetPixRectGrey read
+  /// the rectangle straight from it, with any bytes_per_line, and only write
+  /// the Pix they return, so nothing is copied that does not need converting.
   /// Greyscale of 8 and color of 24 or 32 bits per pixel may be given.
   /// Palette color images will not work properly and must be converted to
   /// 24 bit.
@@ -141,9 +145,17 @@ class ImageThresholder {
                           const int* thresholds, const int* hi_values,
                           Pix** pix) const;
 
+  /// Otsu threshold the rectangle of the 8-bit source pix_ to the output Pix,
+  /// reading the source in place.
+  void OtsuThresholdGreyPixRectToPix(Pix** pix) const;
+
   /// Copy the raw image rectangle, taking all data from the class, to the Pix.
   void RawRectToPix(Pix** pix) const;
 
+  /// Convert the raw grey or color image rectangle, taking all data from the
+  /// class, to an 8-bit grey Pix.
+  void RawRectToGreyPix(Pix** pix) const;
+
  protected:
   /// Clone or other copy of the source Pix.
   /// The pix will always be PixDestroy()ed on destruction of the class.
@@ -33,25 +33,38 @@ void OtsuThreshold(const unsigned char* imagedata,
                    int bytes_per_pixel, int bytes_per_line,
                    int left, int top, int width, int height,
                    int** thresholds, int** hi_values) {
+  int* histograms = new int[bytes_per_pixel * kHistogramSize];
+  for (int ch = 0; ch < bytes_per_pixel; ++ch) {
+    // Compute the histogram of the image rectangle.
+    HistogramRect(imagedata + ch, bytes_per_pixel, bytes_per_line,
+                  left, top, width, height, histograms + ch * kHistogramSize);
+  }
+  OtsuThresholdHistograms(histograms, bytes_per_pixel, thresholds, hi_values);
+  delete [] histograms;
+}
+
+// Compute the Otsu threshold(s) from the given histograms, one per channel,
+// as OtsuThreshold does for an image rectangle. Used by callers that read
+// the pixels themselves, such as from a Pix, without copying them first.
+// Delete thresholds and hi_values with delete [] after use.
+void OtsuThresholdHistograms(const int* histograms, int num_channels,
+                             int** thresholds, int** hi_values) {
   // Of all channels with no good hi_value, keep the best so we can always
   // produce at least one answer.
   int best_hi_value = 1;
   int best_hi_index = 0;
   bool any_good_hivalue = false;
   double best_hi_dist = 0.0;
-  *thresholds = new int[bytes_per_pixel];
-  *hi_values = new int[bytes_per_pixel];
+  *thresholds = new int[num_channels];
+  *hi_values = new int[num_channels];
 
-  for (int ch = 0; ch < bytes_per_pixel; ++ch) {
+  for (int ch = 0; ch < num_channels; ++ch) {
     (*thresholds)[ch] = -1;
     (*hi_values)[ch] = -1;
-    // Compute the histogram of the image rectangle.
-    int histogram[kHistogramSize];
-    HistogramRect(imagedata + ch, bytes_per_pixel, bytes_per_line,
-                  left, top, width, height, histogram);
     int H;
     int best_omega_0;
-    int best_t = OtsuStats(histogram, &H, &best_omega_0);
+    int best_t = OtsuStats(histograms + ch * kHistogramSize,
+                           &H, &best_omega_0);
     if (best_omega_0 == 0 || best_omega_0 == H) {
        // This channel is empty.
        continue;
@@ -36,6 +36,13 @@ void OtsuThreshold(const unsigned char* imagedata,
                    int left, int top, int width, int height,
                    int** thresholds, int** hi_values);
 
+// Compute the Otsu threshold(s) as OtsuThreshold above, but from
+// histograms already computed for each of the num_channels channels,
+// stored one after the other with kHistogramSize elements each.
+// Delete thresholds and hi_values with delete [] after use.
+void OtsuThresholdHistograms(const int* histograms, int num_channels,
+                             int** thresholds, int** hi_values);
+
 // Compute the histogram for the given image rectangle, and the given
 // channel. (Channel pointed to by imagedata.) Each channel is always
 // one byte per pixel.
@@ -667,6 +667,51 @@ WERD_RES *PAGE_RES_IT::forward_block() {
 }
 
 
+/*************************************************************************
+ * PAGE_RES_IT::forward_to_row
+ *
+ * Move forward to the first word of the given row, or of the given block if
+ * row is NULL, without touching the words on the way.
+ *************************************************************************/
+
+WERD_RES *PAGE_RES_IT::forward_to_row(BLOCK_RES *block, ROW_RES *row) {
+  bool new_block = false;
+  if (block == block_res &&
+      (block_res_it.cycled_list() || block_res_it.data() != block)) {
+    // Looking ahead has taken the iterators past the current block.
+    block_res_it.move_to_first();
+    block_res_it.mark_cycle_pt();
+    new_block = true;
+  }
+  while (!block_res_it.cycled_list() && block_res_it.data() != block) {
+    block_res_it.forward();
+    new_block = true;
+  }
+  ASSERT_HOST(!block_res_it.cycled_list());
+  if (row != NULL) {
+    if (new_block || (row == row_res &&
+                      (row_res_it.cycled_list() || row_res_it.data() != row))) {
+      row_res_it.set_to_list(&block->row_res_list);
+      row_res_it.mark_cycle_pt();
+    }
+    while (!row_res_it.cycled_list() && row_res_it.data() != row)
+      row_res_it.forward();
+    ASSERT_HOST(!row_res_it.cycled_list());
+    word_res_it.set_to_list(&row->word_res_list);
+    word_res_it.mark_cycle_pt();
+  }
+  // Forget the words seen so far, which may no longer exist.
+  block_res = NULL;
+  row_res = NULL;
+  word_res = NULL;
+  next_block_res = NULL;
+  next_row_res = NULL;
+  next_word_res = NULL;
+  internal_forward(row == NULL, false);
+  return internal_forward(false, false);
+}
+
+
 void PAGE_RES_IT::rej_stat_word() {
   inT16 chars_in_word;
   inT16 rejects_in_word = 0;
@@ -381,6 +381,12 @@ class PAGE_RES_IT {
 
   WERD_RES *forward_block();  // get first word in
   // next non-empty block
+  // Moves forward to the first word of the given row of the given block, or
+  // of the block if row is NULL, which must not be before the current word.
+  // Only the blocks and rows are walked and the words are read afresh from
+  // the row, so it is safe after another PAGE_RES_IT has replaced words that
+  // this one had looked ahead to, as long as the rows and blocks are intact.
+  WERD_RES *forward_to_row(BLOCK_RES *block, ROW_RES *row);
   WERD_RES *prev_word() const {  // previous word
     return prev_word_res;
   }
@@ -48,5 +48,70 @@ void CCUtilMutex::Unlock() {
 #endif
 }
 
+CCUtilSemaphore::CCUtilSemaphore() {
+#ifdef WIN32
+  semaphore_ = CreateSemaphore(0, 0, 10000000, 0);
+#else
+  sem_init(&semaphore_, 0, 0);
+#endif
+}
+
+CCUtilSemaphore::~CCUtilSemaphore() {
+#ifdef WIN32
+  CloseHandle(semaphore_);
+#else
+  sem_destroy(&semaphore_);
+#endif
+}
+
+void CCUtilSemaphore::Signal() {
+#ifdef WIN32
+  ReleaseSemaphore(semaphore_, 1, NULL);
+#else
+  sem_post(&semaphore_);
+#endif
+}
+
+void CCUtilSemaphore::Wait() {
+#ifdef WIN32
+  WaitForSingleObject(semaphore_, INFINITE);
+#else
+  sem_wait(&semaphore_);
+#endif
+}
+
+CCUtilThread::CCUtilThread() : running_(false) {
+}
+
+CCUtilThread::~CCUtilThread() {
+  Join();
+}
+
+bool CCUtilThread::Start(void *(*func)(void*), void* arg) {
+  if (running_)
+    return false;
+#ifdef WIN32
+  DWORD threadid;
+  thread_ = CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE) func, arg, 0,
+                         &threadid);
+  running_ = thread_ != NULL;
+#else
+  running_ = pthread_create(&thread_, NULL, func, arg) == 0;
+#endif
+  return running_;
+}
+
+void CCUtilThread::Join() {
+  if (!running_)
+    return;
+#ifdef WIN32
+  WaitForSingleObject(thread_, INFINITE);
+  CloseHandle(thread_);
+#else
+  pthread_join(thread_, NULL);
+#endif
+  running_ = false;
+}
+
 CCUtilMutex tprintfMutex;  // should remain global
 } // namespace tesseract
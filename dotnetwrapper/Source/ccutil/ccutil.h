@@ -21,6 +21,7 @@
 
 #include "ambigs.h"
 #include "errcode.h"
+#include "pagestats.h"
 #include "strngs.h"
 #include "tessdatamanager.h"
 #include "params.h"
@@ -50,6 +51,42 @@ class CCUtilMutex {
 #endif
 };
 
+class CCUtilSemaphore {
+ public:
+  CCUtilSemaphore();
+  ~CCUtilSemaphore();
+
+  void Signal();
+
+  void Wait();
+ private:
+#ifdef WIN32
+  HANDLE semaphore_;
+#else
+  sem_t semaphore_;
+#endif
+};
+
+// A thread that can be joined, for the parallel parts of the api.
+class CCUtilThread {
+ public:
+  CCUtilThread();
+  ~CCUtilThread();
+
+  // Runs func(arg) in a new thread. Returns false if it could not be created.
+  bool Start(void *(*func)(void*), void* arg);
+
+  // Waits for the thread run by Start to finish. Does nothing if none is.
+  void Join();
+ private:
+  bool running_;
+#ifdef WIN32
+  HANDLE thread_;
+#else
+  pthread_t thread_;
+#endif
+};
+
 
 class CCUtil {
  public:
@@ -63,6 +100,9 @@ class CCUtil {
                   const char *basename      // name of image
                  );
   ParamsVectors *params() { return &params_; }
+  // Times and counts of the stages of the current page, recorded by the
+  // PageStageTimers of this instance.
+  PageStats *page_stats() { return &page_stats_; }
 
   STRING datadir;        // dir for data files
   STRING imagebasename;  // name of image
@@ -76,6 +116,7 @@ class CCUtil {
 
  private:
   ParamsVectors params_;
+  PageStats page_stats_;
 
  public:
   // Member parameters.
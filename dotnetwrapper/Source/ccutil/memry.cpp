@@ -29,6 +29,15 @@
 
 //#define COUNTING_CLASS_STRUCTURES
 
+// Number of allocations made by the calling thread through the allocators
+// of this file and Emalloc, so that the allocations of a page can be
+// counted without locking while other threads recognize other pages.
+#ifdef _MSC_VER
+static __declspec(thread) inT64 thread_alloc_count = 0;
+#else
+static __thread inT64 thread_alloc_count = 0;
+#endif
+
 /**********************************************************************
  * new
  *
@@ -56,6 +65,28 @@ void*						addr						//mem to free
   free_big_mem(addr);
 }*/
 
+/**********************************************************************
+ * count_alloc
+ *
+ * Count an allocation made by the calling thread.
+ **********************************************************************/
+
+DLLSYM void count_alloc() {
+  thread_alloc_count++;
+}
+
+
+/**********************************************************************
+ * alloc_count
+ *
+ * Return the number of allocations made by the calling thread.
+ **********************************************************************/
+
+DLLSYM inT64 alloc_count() {
+  return thread_alloc_count;
+}
+
+
 /**********************************************************************
  * check_mem
  *
@@ -85,6 +116,7 @@ DLLSYM void check_mem(                     //check consistency
 DLLSYM char *alloc_string(             //allocate string
                           inT32 count  //no of chars required
                          ) {
+  count_alloc();
 #ifdef RAYS_MALLOC
   char *string;                  //allocated string
 
@@ -170,6 +202,7 @@ const char *name                 //name of type
 const char *                     //name of type
 #endif
 ) {
+  count_alloc();
 #ifdef RAYS_MALLOC
   MEMUNION *element;             //current element
   MEMUNION *returnelement;       //return value
@@ -389,6 +422,7 @@ const char *                     //name of type
 DLLSYM void *alloc_mem_p(             //allocate permanent space
                          inT32 count  //block size to allocate
                         ) {
+  count_alloc();
   #ifdef RAYS_MALLOC
   #ifdef TESTING_BIGSTUFF
   if (main_mem.biggestblock == 0)
@@ -418,6 +452,7 @@ DLLSYM void *alloc_mem_p(             //allocate permanent space
 DLLSYM void *alloc_mem(             //get some memory
                        inT32 count  //no of bytes to get
                       ) {
+  count_alloc();
   #ifdef RAYS_MALLOC
   #ifdef TESTING_BIGSTUFF
   if (main_mem.biggestblock == 0)
@@ -447,6 +482,7 @@ DLLSYM void *alloc_mem(             //get some memory
 DLLSYM void *alloc_big_mem(             //get some memory
                            inT32 count  //no of bytes to get
                           ) {
+  count_alloc();
   #ifdef TESTING_BIGSTUFF
   if (big_mem.biggestblock == 0)
     big_mem.init ((void *(*)(inT32)) malloc, free,
@@ -470,6 +506,7 @@ DLLSYM void *alloc_big_mem(             //get some memory
 DLLSYM void *alloc_big_zeros(             //get some memory
                              inT32 count  //no of bytes to get
                             ) {
+  count_alloc();
   #ifdef TESTING_BIGSTUFF
   if (big_mem.biggestblock == 0)
     big_mem.init ((void *(*)(inT32)) malloc, free,
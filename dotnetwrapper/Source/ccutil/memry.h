@@ -120,4 +120,8 @@ extern DLLSYM void free_mem(                //free mem from alloc_mem
 extern DLLSYM void free_big_mem(                //free mem from alloc_mem
                                 void *oldchunk  //chunk to free
                                );
+                                 //count an allocation
+extern DLLSYM void count_alloc();
+                                 //allocations by this thread
+extern DLLSYM inT64 alloc_count();
 #endif
@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////
+// File:        mmapfile.cpp
+// Description: Read-only memory mapping of a whole file.
+//
+// (C) Copyright 2011, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "mmapfile.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tesseract {
+
+MemoryMappedFile::MemoryMappedFile()
+  : data_(NULL), size_(0) {
+#ifdef WIN32
+  file_handle_ = INVALID_HANDLE_VALUE;
+  mapping_handle_ = NULL;
+#endif
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+  Close();
+}
+
+#ifdef WIN32
+bool MemoryMappedFile::Open(const char* filename) {
+  Close();
+  file_handle_ = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file_handle_ == INVALID_HANDLE_VALUE)
+    return false;
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file_handle_, &file_size) || file_size.QuadPart == 0) {
+    Close();
+    return false;
+  }
+  mapping_handle_ = CreateFileMapping(file_handle_, NULL, PAGE_READONLY,
+                                      0, 0, NULL);
+  if (mapping_handle_ == NULL) {
+    Close();
+    return false;
+  }
+  data_ = static_cast<const char*>(
+      MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+  if (data_ == NULL) {
+    Close();
+    return false;
+  }
+  size_ = file_size.QuadPart;
+  return true;
+}
+
+void MemoryMappedFile::Close() {
+  if (data_ != NULL)
+    UnmapViewOfFile(data_);
+  if (mapping_handle_ != NULL)
+    CloseHandle(mapping_handle_);
+  if (file_handle_ != INVALID_HANDLE_VALUE)
+    CloseHandle(file_handle_);
+  data_ = NULL;
+  size_ = 0;
+  mapping_handle_ = NULL;
+  file_handle_ = INVALID_HANDLE_VALUE;
+}
+#else
+bool MemoryMappedFile::Open(const char* filename) {
+  Close();
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+    close(fd);
+    return false;
+  }
+  void* data = mmap(NULL, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping keeps its own reference to the file.
+  close(fd);
+  if (data == MAP_FAILED)
+    return false;
+  data_ = static_cast<const char*>(data);
+  size_ = file_stat.st_size;
+  return true;
+}
+
+void MemoryMappedFile::Close() {
+  if (data_ != NULL)
+    munmap(const_cast<char*>(data_), size_);
+  data_ = NULL;
+  size_ = 0;
+}
+#endif
+
+}  // namespace tesseract
@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////////////////
+// File:        mmapfile.h
+// Description: Read-only memory mapping of a whole file.
+//
+// (C) Copyright 2011, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCUTIL_MMAPFILE_H__
+#define TESSERACT_CCUTIL_MMAPFILE_H__
+
+#include "host.h"
+
+namespace tesseract {
+
+// A read-only mapping of a whole file into memory. The pages are read on
+// demand and, being backed by the file, are shared through the page cache
+// by all the processes that map the same file, so data that is only read
+// can be used in place instead of being copied to the heap.
+class MemoryMappedFile {
+ public:
+  MemoryMappedFile();
+  ~MemoryMappedFile();
+
+  // Maps the given file, unmapping any previous one. Returns false if the
+  // file cannot be mapped, for instance if it is empty or does not exist,
+  // in which case the caller should fall back to reading it with stdio.
+  bool Open(const char* filename);
+  // Unmaps the file. Any pointer obtained from data() becomes invalid.
+  void Close();
+
+  bool IsOpen() const {
+    return data_ != NULL;
+  }
+  // Start of the mapped file, or NULL if none is mapped.
+  const char* data() const {
+    return data_;
+  }
+  inT64 size() const {
+    return size_;
+  }
+
+ private:
+  // Not copyable: the copies would unmap the same pages.
+  MemoryMappedFile(const MemoryMappedFile&);
+  void operator=(const MemoryMappedFile&);
+
+  const char* data_;
+  inT64 size_;
+#ifdef WIN32
+  // The HANDLEs of the file and of the mapping.
+  void* file_handle_;
+  void* mapping_handle_;
+#endif
+};
+
+}  // namespace tesseract
+
+#endif  // TESSERACT_CCUTIL_MMAPFILE_H__
@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////////////
+// File:        pagestats.cpp
+// Description: Time spent and calls made in each stage of a page.
+//
+// (C) Copyright 2011, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "pagestats.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+namespace tesseract {
+
+void PageStats::Clear() {
+  for (int s = 0; s < PAGE_STAGE_COUNT; ++s) {
+    seconds[s] = 0.0;
+    calls[s] = 0;
+  }
+  allocations = 0;
+}
+
+void PageStats::Add(const PageStats& other) {
+  for (int s = 0; s < PAGE_STAGE_COUNT; ++s) {
+    seconds[s] += other.seconds[s];
+    calls[s] += other.calls[s];
+  }
+  allocations += other.allocations;
+}
+
+const char* PageStats::StageName(PageStage stage) {
+  switch (stage) {
+    case PAGE_STAGE_THRESHOLD: return "threshold";
+    case PAGE_STAGE_FIND_COMPONENTS: return "find_components";
+    case PAGE_STAGE_TEXTORD: return "textord";
+    case PAGE_STAGE_AUTO_PAGESEG: return "auto_pageseg";
+    case PAGE_STAGE_ADAPTIVE_CLASSIFIER: return "adaptive_classifier";
+    case PAGE_STAGE_CHAR_NORM_CLASSIFIER: return "char_norm_classifier";
+    case PAGE_STAGE_CUBE_CLASSIFIER: return "cube_classifier";
+    case PAGE_STAGE_CHOP_WORD: return "chop_word";
+    case PAGE_STAGE_DAWG_PERMUTE: return "dawg_permute";
+    default: return "unknown";
+  }
+}
+
+double PageStageTimer::Now() {
+#ifdef WIN32
+  LARGE_INTEGER frequency, counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return static_cast<double>(counter.QuadPart) / frequency.QuadPart;
+#else
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return now.tv_sec + now.tv_usec * 1e-6;
+#endif
+}
+
+}  // namespace tesseract
@@ -0,0 +1,95 @@
+///////////////////////////////////////////////////////////////////////
+// File:        pagestats.h
+// Description: Time spent and calls made in each stage of a page.
+//
+// (C) Copyright 2011, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCUTIL_PAGESTATS_H__
+#define TESSERACT_CCUTIL_PAGESTATS_H__
+
+#include "host.h"
+
+namespace tesseract {
+
+// The stages of the recognition of a page timed by PageStageTimer.
+// The stages nest: the classifiers are called by chop_word_main and by
+// the adaptive classifier, and find_components by textord, so the time of
+// a stage includes that of the stages it calls.
+enum PageStage {
+  PAGE_STAGE_THRESHOLD,          // TessBaseAPI::Threshold.
+  PAGE_STAGE_FIND_COMPONENTS,    // Textord::find_components.
+  PAGE_STAGE_TEXTORD,            // Textord::TextordPage.
+  PAGE_STAGE_AUTO_PAGESEG,       // Tesseract::AutoPageSeg.
+  PAGE_STAGE_ADAPTIVE_CLASSIFIER,   // Classify::AdaptiveClassifier[Batch].
+  PAGE_STAGE_CHAR_NORM_CLASSIFIER,  // Classify::CharNormClassifier.
+  PAGE_STAGE_CUBE_CLASSIFIER,    // The cube char classifier of a segment.
+  PAGE_STAGE_CHOP_WORD,          // Wordrec::chop_word_main.
+  PAGE_STAGE_DAWG_PERMUTE,       // Dict::dawg_permute_and_select.
+
+  PAGE_STAGE_COUNT
+};
+
+// The time spent and the number of calls made in each stage of a page,
+// and the number of allocations made through alloc_mem and the other
+// allocators of memry.h and Emalloc. Nothing is recorded unless enabled
+// is set. The times are wall-clock seconds summed over the calls, so with
+// several threads they may add up to more than the time of the page.
+struct PageStats {
+  PageStats() : enabled(false) {
+    Clear();
+  }
+
+  // Clears the times and counts, keeping enabled.
+  void Clear();
+  // Adds the times and counts of other to this.
+  void Add(const PageStats& other);
+  // Returns a short name of the stage, for printing.
+  static const char* StageName(PageStage stage);
+
+  bool enabled;
+  double seconds[PAGE_STAGE_COUNT];
+  inT32 calls[PAGE_STAGE_COUNT];
+  inT64 allocations;
+};
+
+// Adds the time of its scope and one call to a stage of a PageStats,
+// if it is not NULL and is enabled. When it is not, it costs no more than
+// a test.
+class PageStageTimer {
+ public:
+  PageStageTimer(PageStats* stats, PageStage stage)
+    : stats_(stats != NULL && stats->enabled ? stats : NULL),
+      stage_(stage), start_(0.0) {
+    if (stats_ != NULL)
+      start_ = Now();
+  }
+  ~PageStageTimer() {
+    if (stats_ != NULL) {
+      stats_->seconds[stage_] += Now() - start_;
+      ++stats_->calls[stage_];
+    }
+  }
+
+  // Returns a wall-clock time in seconds, only meaningful in differences.
+  static double Now();
+
+ private:
+  PageStats* stats_;
+  PageStage stage_;
+  double start_;
+};
+
+}  // namespace tesseract
+
+#endif  // TESSERACT_CCUTIL_PAGESTATS_H__
@@ -206,4 +206,34 @@ void ParamUtils::PrintParams(FILE *fp, const ParamsVectors *member_params) {
   }
 }
 
+void ParamUtils::CopyParams(const ParamsVectors *src, ParamsVectors *dst) {
+  GenericVector<IntParam *> no_int_params;
+  GenericVector<BoolParam *> no_bool_params;
+  GenericVector<StringParam *> no_string_params;
+  GenericVector<DoubleParam *> no_double_params;
+  int i;
+  for (i = 0; i < src->int_params.size(); ++i) {
+    IntParam *p = FindParam<IntParam>(src->int_params[i]->name_str(),
+                                      no_int_params, dst->int_params);
+    if (p != NULL) p->set_value((inT32)(*src->int_params[i]));
+  }
+  for (i = 0; i < src->bool_params.size(); ++i) {
+    BoolParam *p = FindParam<BoolParam>(src->bool_params[i]->name_str(),
+                                        no_bool_params, dst->bool_params);
+    if (p != NULL) p->set_value((BOOL8)(*src->bool_params[i]));
+  }
+  for (i = 0; i < src->string_params.size(); ++i) {
+    StringParam *p = FindParam<StringParam>(src->string_params[i]->name_str(),
+                                            no_string_params,
+                                            dst->string_params);
+    if (p != NULL) p->set_value(STRING(src->string_params[i]->string()));
+  }
+  for (i = 0; i < src->double_params.size(); ++i) {
+    DoubleParam *p = FindParam<DoubleParam>(src->double_params[i]->name_str(),
+                                            no_double_params,
+                                            dst->double_params);
+    if (p != NULL) p->set_value((double)(*src->double_params[i]));
+  }
+}
+
 }  // namespace tesseract
@@ -95,6 +95,10 @@ class ParamUtils {
 
   // Print parameters to the given file.
   static void PrintParams(FILE *fp, const ParamsVectors *member_params);
+
+  // Sets the member params in dst to the values of the member params of the
+  // same name in src. Used to give a helper instance the current settings.
+  static void CopyParams(const ParamsVectors *src, ParamsVectors *dst);
 };
 
 // Definition of various parameter types.
@@ -0,0 +1,49 @@
+///////////////////////////////////////////////////////////////////////
+// File:        simddetect.cpp
+// Description: Run-time detection of the SIMD instruction sets.
+//
+// (C) Copyright 2011, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "simddetect.h"
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#include <intrin.h>
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#include <cpuid.h>
+#endif
+
+namespace tesseract {
+
+// Bit of SSE2 in edx of cpuid function 1.
+static const int kCpuidSSE2Bit = 1 << 26;
+
+bool SIMDDetect::IsSSE2Available() {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 1)
+    return false;
+  __cpuid(info, 1);
+  return (info[3] & kCpuidSSE2Bit) != 0;
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+  unsigned int eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return false;
+  return (edx & kCpuidSSE2Bit) != 0;
+#else
+  return false;
+#endif
+}
+
+}  // namespace tesseract
@@ -0,0 +1,42 @@
+///////////////////////////////////////////////////////////////////////
+// File:        simddetect.h
+// Description: Run-time detection of the SIMD instruction sets.
+//
+// (C) Copyright 2011, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCUTIL_SIMDDETECT_H__
+#define TESSERACT_CCUTIL_SIMDDETECT_H__
+
+// SSE2 intrinsics can be compiled: always with MSVC on x86, and with gcc
+// when the target has SSE2, which is the default on x86-64.
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#define HAVE_SSE2_INTRINSICS
+#elif defined(__GNUC__) && defined(__SSE2__)
+#define HAVE_SSE2_INTRINSICS
+#endif
+
+namespace tesseract {
+
+// Tells which SIMD instruction sets the cpu running the program has, so
+// that the vectorized kernels are selected at run time and the same binary
+// still runs, with the scalar code, on cpus without them.
+class SIMDDetect {
+ public:
+  // Returns true if the cpu has SSE2. Always false on other architectures.
+  static bool IsSSE2Available();
+};
+
+}  // namespace tesseract
+
+#endif  // TESSERACT_CCUTIL_SIMDDETECT_H__
@@ -24,6 +24,7 @@
 #include "tessdatamanager.h"
 
 #include <stdio.h>
+#include <string.h>
 
 #include "serialis.h"
 #include "strngs.h"
@@ -35,6 +36,10 @@ namespace tesseract {
 bool TessdataManager::Init(const char *data_file_name, int debug_level) {
   int i;
   debug_level_ = debug_level;
+  data_file_name_ = data_file_name;
+  for (i = 0; i < TESSDATA_NUM_ENTRIES; ++i) {
+    loaded_[i] = false;
+  }
   data_file_ = fopen(data_file_name, "rb");
   if (data_file_ == NULL) {
     tprintf("Error opening data file %s\n", data_file_name);
@@ -60,9 +65,49 @@ bool TessdataManager::Init(const char *data_file_name, int debug_level) {
       tprintf("Offset for type %d is %lld\n", i, offset_table_[i]);
     }
   }
+  if (!mapped_file_.Open(data_file_name) && debug_level_) {
+    tprintf("TessdataManager could not map %s, reading it instead\n",
+            data_file_name);
+  }
   return true;
 }
 
+bool TessdataManager::Reopen() {
+  if (data_file_ != NULL)
+    return true;
+  data_file_ = fopen(data_file_name_.string(), "rb");
+  if (data_file_ == NULL) {
+    tprintf("Error reopening data file %s\n", data_file_name_.string());
+    return false;
+  }
+  return true;
+}
+
+const char *TessdataManager::GetDataPtr(TessdataType tessdata_type) const {
+  if (!mapped_file_.IsOpen() || offset_table_[tessdata_type] < 0)
+    return NULL;
+  return mapped_file_.data() + offset_table_[tessdata_type];
+}
+
+inT64 TessdataManager::GetDataSize(TessdataType tessdata_type) const {
+  if (GetDataPtr(tessdata_type) == NULL)
+    return 0;
+  inT64 end_offset = GetEndOffset(tessdata_type);
+  if (end_offset < 0)
+    end_offset = mapped_file_.size() - 1;
+  return end_offset + 1 - offset_table_[tessdata_type];
+}
+
+bool TessdataManager::SameData(TessdataType tessdata_type,
+                               const TessdataManager &other) const {
+  const char *data = GetDataPtr(tessdata_type);
+  const char *other_data = other.GetDataPtr(tessdata_type);
+  inT64 size = GetDataSize(tessdata_type);
+  return data != NULL && other_data != NULL &&
+         size == other.GetDataSize(tessdata_type) &&
+         memcmp(data, other_data, static_cast<size_t>(size)) == 0;
+}
+
 void TessdataManager::CopyFile(FILE *input_file, FILE *output_file,
                                bool newline_end, inT64 num_bytes_to_copy) {
   if (num_bytes_to_copy == 0) return;
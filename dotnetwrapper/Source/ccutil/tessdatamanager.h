@@ -22,6 +22,8 @@
 
 #include <stdio.h>
 #include "host.h"
+#include "mmapfile.h"
+#include "strngs.h"
 #include "tprintf.h"
 
 static const char kTrainedDataSuffix[] = "traineddata";
@@ -119,6 +121,7 @@ class TessdataManager {
     actual_tessdata_num_entries_ = 0;
     for (int i = 0; i < TESSDATA_NUM_ENTRIES; ++i) {
       offset_table_[i] = -1;
+      loaded_[i] = false;
     }
   }
   ~TessdataManager() {}
@@ -126,13 +129,59 @@ class TessdataManager {
 
   /**
    * Opens the given data file and reads the offset table.
+   * The file is also memory mapped if possible, see GetDataPtr.
    * Returns true on success.
    */
   bool Init(const char *data_file_name, int debug_level);
 
+  /**
+   * Opens the data file again after End(), so that a component which is
+   * only loaded on its first use can be read after the initialization.
+   * The caller should call End() again when done. Returns true on success.
+   */
+  bool Reopen();
+
   /** Returns data file pointer. */
   inline FILE *GetDataFilePtr() const { return data_file_; }
 
+  /**
+   * Records that the component of the given type has been loaded, whether
+   * at initialization or on its first use.
+   */
+  inline void SetLoaded(TessdataType tessdata_type) {
+    loaded_[tessdata_type] = true;
+  }
+  /**
+   * Returns true if the component of the given type has been loaded since
+   * the last Init. Together, these tell which components of the data file
+   * were actually needed so far.
+   */
+  inline bool IsLoaded(TessdataType tessdata_type) const {
+    return loaded_[tessdata_type];
+  }
+
+  /**
+   * Returns a pointer to the start of the data of the given type in the
+   * memory mapped data file, or NULL if there is no data of that type or if
+   * the file could not be mapped, in which case it has to be read from
+   * GetDataFilePtr. The data is read-only and shared by all the processes
+   * using the same file. It stays valid after End(), until the next Init or
+   * the destruction of the TessdataManager, so immutable components may be
+   * used in place for as long as the TessdataManager lives.
+   */
+  const char *GetDataPtr(TessdataType tessdata_type) const;
+  /**
+   * Returns the size in bytes of the data of the given type in the memory
+   * mapped data file, or 0 if GetDataPtr returns NULL.
+   */
+  inT64 GetDataSize(TessdataType tessdata_type) const;
+  /**
+   * Returns true if the data of the given type is the same in this and the
+   * other memory mapped data file. Returns false if either is not mapped.
+   */
+  bool SameData(TessdataType tessdata_type,
+                const TessdataManager &other) const;
+
   /**
    * Returns false if there is no data of the given type.
    * Otherwise does a seek on the data_file_ to position the pointer
@@ -167,7 +216,10 @@ class TessdataManager {
     }
     return (index == actual_tessdata_num_entries_) ? -1 : offset_table_[index] - 1;
   }
-  /** Closes data_file_ (if it was opened by Init()). */
+  /**
+   * Closes data_file_ (if it was opened by Init()). The memory mapping is
+   * kept for the components used in place.
+   */
   inline void End() {
     if (data_file_ != NULL) {
       fclose(data_file_);
@@ -259,6 +311,10 @@ class TessdataManager {
    */
   inT32 actual_tessdata_num_entries_;
   FILE *data_file_;  ///< pointer to the data file.
+  STRING data_file_name_;  ///< name of the data file, for Reopen.
+  /** loaded_[i] is true if the component of TessdataType i was loaded. */
+  bool loaded_[TESSDATA_NUM_ENTRIES];
+  MemoryMappedFile mapped_file_;  ///< the data file mapped into memory.
   int debug_level_;
 };
 
@@ -0,0 +1,136 @@
+///////////////////////////////////////////////////////////////////////
+// File:        threadpool.cpp
+// Description: Fixed set of threads running a task over a range of items.
+//
+// (C) Copyright 2011, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "threadpool.h"
+#include "tprintf.h"
+
+namespace tesseract {
+
+ThreadPool::ThreadPool(int num_threads)
+  : num_threads_(num_threads > 0 ? num_threads : 1),
+    num_started_(0),
+    task_(NULL),
+    exiting_(false) {
+  threads_ = new CCUtilThread[num_threads_];
+  args_ = new ThreadArg[num_threads_];
+  shares_ = new Share[num_threads_];
+  start_ = new CCUtilSemaphore[num_threads_];
+  for (int t = 0; t < num_threads_; ++t) {
+    shares_[t].begin = 0;
+    shares_[t].end = 0;
+    args_[t].pool = this;
+    args_[t].index = t;
+    if (threads_[t].Start(&ThreadPool::ThreadMain, &args_[t])) {
+      ++num_started_;
+    } else {
+      // The items of a thread that did not start are still done, as they
+      // are stolen by the other threads.
+      tprintf("Warning: failed to start thread %d of the pool\n", t);
+    }
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  exiting_ = true;
+  for (int t = 0; t < num_threads_; ++t)
+    start_[t].Signal();
+  for (int t = 0; t < num_threads_; ++t)
+    threads_[t].Join();
+  delete [] threads_;
+  delete [] args_;
+  delete [] shares_;
+  delete [] start_;
+}
+
+void ThreadPool::Run(int num_items, ThreadPoolTask* task) {
+  if (num_items <= 0)
+    return;
+  if (num_started_ == 0) {
+    for (int item = 0; item < num_items; ++item)
+      task->Run(0, item);
+    return;
+  }
+  task_ = task;
+  for (int t = 0; t < num_threads_; ++t) {
+    shares_[t].mutex.Lock();
+    shares_[t].begin = num_items * t / num_threads_;
+    shares_[t].end = num_items * (t + 1) / num_threads_;
+    shares_[t].mutex.Unlock();
+  }
+  for (int t = 0; t < num_threads_; ++t)
+    start_[t].Signal();
+  for (int t = 0; t < num_started_; ++t)
+    done_.Wait();
+  task_ = NULL;
+}
+
+void* ThreadPool::ThreadMain(void* arg) {
+  ThreadArg* thread_arg = static_cast<ThreadArg*>(arg);
+  thread_arg->pool->RunThread(thread_arg->index);
+  return NULL;
+}
+
+void ThreadPool::RunThread(int index) {
+  while (true) {
+    start_[index].Wait();
+    if (exiting_)
+      return;
+    int item;
+    while (TakeItem(index, &item))
+      task_->Run(index, item);
+    done_.Signal();
+  }
+}
+
+bool ThreadPool::TakeItem(int index, int* item) {
+  Share* own = &shares_[index];
+  own->mutex.Lock();
+  if (own->begin < own->end) {
+    *item = own->begin++;
+    own->mutex.Unlock();
+    return true;
+  }
+  own->mutex.Unlock();
+  // Steal from the back of the largest share, which is the least likely
+  // to be reached soon by its own thread.
+  while (true) {
+    int victim = -1;
+    int victim_size = 0;
+    for (int t = 0; t < num_threads_; ++t) {
+      shares_[t].mutex.Lock();
+      int size = shares_[t].end - shares_[t].begin;
+      shares_[t].mutex.Unlock();
+      if (size > victim_size) {
+        victim = t;
+        victim_size = size;
+      }
+    }
+    if (victim < 0)
+      return false;
+    Share* share = &shares_[victim];
+    share->mutex.Lock();
+    if (share->begin < share->end) {
+      *item = --share->end;
+      share->mutex.Unlock();
+      return true;
+    }
+    share->mutex.Unlock();
+    // Someone else took it first. Look again.
+  }
+}
+
+}  // namespace tesseract
@@ -0,0 +1,90 @@
+///////////////////////////////////////////////////////////////////////
+// File:        threadpool.h
+// Description: Fixed set of threads running a task over a range of items.
+//
+// (C) Copyright 2011, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CCUTIL_THREADPOOL_H__
+#define TESSERACT_CCUTIL_THREADPOOL_H__
+
+#include "ccutil.h"
+#include "tesscallback.h"
+
+namespace tesseract {
+
+// Task run by a ThreadPool with the index of the thread running it, in
+// [0, num_threads), and the index of the item to process.
+typedef TessCallback2<int, int> ThreadPoolTask;
+
+// A fixed set of threads that run a task over a range of items.
+// Each thread starts with a contiguous share of the items and takes them
+// from the front of its share. When its share is empty, it steals from the
+// back of the largest remaining share, so that items of uneven cost still
+// keep all the threads busy until the end.
+// The thread index given to the task lets each thread use its own private
+// data, for instance its own Tesseract instance.
+class ThreadPool {
+ public:
+  explicit ThreadPool(int num_threads);
+  ~ThreadPool();
+
+  int num_threads() const {
+    return num_threads_;
+  }
+
+  // Runs task->Run(thread_index, item) for each item in [0, num_items) on
+  // the threads of the pool, and returns when all the items are done.
+  // The calling thread only waits, unless none of the threads could be
+  // started, in which case it runs all the items as thread 0.
+  // The task must be permanent and is not deleted.
+  // Run must not be called again before it returns.
+  void Run(int num_items, ThreadPoolTask* task);
+
+ private:
+  // The items still to be processed by a thread: [begin, end).
+  struct Share {
+    CCUtilMutex mutex;
+    int begin;
+    int end;
+  };
+  // Argument of ThreadMain.
+  struct ThreadArg {
+    ThreadPool* pool;
+    int index;
+  };
+
+  static void* ThreadMain(void* arg);
+  // Body of the thread of the given index: runs the task for each item it
+  // can take, until the pool is deleted.
+  void RunThread(int index);
+  // Takes the next item for the thread of the given index, from its own
+  // share or from another one. Returns false if all the items are taken.
+  bool TakeItem(int index, int* item);
+
+  int num_threads_;
+  int num_started_;
+  CCUtilThread* threads_;
+  ThreadArg* args_;
+  Share* shares_;
+  // One semaphore per thread to start it on a Run, and one for all the
+  // threads to report that they are done.
+  CCUtilSemaphore* start_;
+  CCUtilSemaphore done_;
+  ThreadPoolTask* task_;
+  bool exiting_;
+};
+
+}  // namespace tesseract
+
+#endif  // TESSERACT_CCUTIL_THREADPOOL_H__
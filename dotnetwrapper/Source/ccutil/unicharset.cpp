@@ -410,6 +410,35 @@ bool UNICHARSET::any_right_to_left() const {
   return false;
 }
 
+// Adds the unichars of src that are not in this unicharset, with their
+// properties, after the existing ones, so the existing ids are unchanged.
+void UNICHARSET::AppendOtherUnicharset(const UNICHARSET& src) {
+  int initial_used = size_used;
+  for (UNICHAR_ID ch = 0; ch < src.size_used; ++ch) {
+    const char* utf8 = src.id_to_unichar(ch);
+    if (contains_unichar(utf8))
+      continue;
+    unichar_insert(utf8);
+    UNICHAR_ID id = size_used - 1;
+    // The fragment is made by unichar_insert and the script and other case
+    // are ids that differ between the two sets.
+    CHAR_FRAGMENT* fragment = unichars[id].properties.fragment;
+    unichars[id].properties = src.unichars[ch].properties;
+    unichars[id].properties.fragment = fragment;
+    set_script(id, src.get_script_from_script_id(src.get_script(ch)));
+  }
+  // The other cases can only be mapped once all the unichars are in.
+  for (UNICHAR_ID id = initial_used; id < size_used; ++id) {
+    UNICHAR_ID src_id = src.unichar_to_id(id_to_unichar(id));
+    UNICHAR_ID other_case = src.get_other_case(src_id);
+    unichars[id].properties.other_case =
+        src.contains_unichar_id(other_case) ?
+        unichar_to_id(src.id_to_unichar(other_case)) : id;
+  }
+  if (size_used > initial_used)
+    post_load_setup();
+}
+
 // Set a whitelist and/or blacklist of characters to recognize.
 // An empty or NULL whitelist enables everything (minus any blacklist).
 // An empty or NULL blacklist disables nothing.
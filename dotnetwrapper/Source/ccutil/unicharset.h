@@ -265,6 +265,10 @@ class UNICHARSET {
   // right_to_left language.
   bool any_right_to_left() const;
 
+  // Adds the unichars of src that are not in this unicharset, with their
+  // properties, after the existing ones, so the existing ids are unchanged.
+  void AppendOtherUnicharset(const UNICHARSET& src);
+
   // Set a whitelist and/or blacklist of characters to recognize.
   // An empty or NULL whitelist enables everything (minus any blacklist).
   // An empty or NULL blacklist disables nothing.
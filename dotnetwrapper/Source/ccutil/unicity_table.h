@@ -81,6 +81,12 @@ class UnicityTable {
   /// its argument, and finally invalidate its argument.
   void move(UnicityTable<T>* from);
 
+  /// This method clears the current object, then does a shallow copy of the
+  /// elements of its argument without taking their ownership: the clear
+  /// callback is dropped, so other must outlive this table. The compare
+  /// callback must be set again by the caller if needed.
+  void share(const UnicityTable<T>& other);
+
   /// Read/Write the table to a file. This does _NOT_ read/write the callbacks.
   /// The Callback given must be permanent since they will be called more than
   /// once. The given callback will be deleted at the end.
@@ -205,4 +211,15 @@ void UnicityTable<T>::move(UnicityTable<T>* from) {
   table_.move(&from->table_);
 }
 
+// This method clears the current object, then does a shallow copy of the
+// elements of its argument without taking their ownership.
+template <typename T>
+void UnicityTable<T>::share(const UnicityTable<T>& other) {
+  clear();
+  compare_cb_ = NULL;
+  table_.reserve(other.size());
+  for (int i = 0; i < other.size(); ++i)
+    table_.push_back(other.get(i));
+}
+
 #endif  // TESSERACT_CCUTIL_UNICITY_TABLE_H_
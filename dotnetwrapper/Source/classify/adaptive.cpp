@@ -29,6 +29,7 @@
 #include <assert.h>
 #endif
 #include <stdio.h>
+#include <string.h>
 
 /*----------------------------------------------------------------------------
               Public Code
@@ -568,3 +569,475 @@ void WriteTempConfig(FILE *File, TEMP_CONFIG Config) {
     Config->ProtoVectorSize, File);
 
 }                                /* WriteTempConfig */
+
+
+/*---------------------------------------------------------------------------*/
+// Snapshots of adapted templates.
+//
+// A snapshot holds the adapted templates of a Classify in a compact binary
+// form, without the font tables that WriteAdaptedTemplates also writes, so
+// that it can be read back into any instance of the same language and
+// traineddata to warm-start it. The fields are written one by one in the
+// byte order of the machine, after a header with a magic number, a version
+// and the size of the unicharset, which are all checked on reading.
+
+// Magic number and version of the snapshots.
+const uinT32 kAdaptedSnapshotMagic = 0x41534e50;  // "PNSA"
+const inT32 kAdaptedSnapshotVersion = 1;
+
+// Kinds of the configs of the classes in snapshots.
+enum SnapshotConfigKind {
+  SNAPSHOT_NO_CONFIG,
+  SNAPSHOT_TEMP_CONFIG,
+  SNAPSHOT_PERM_CONFIG
+};
+
+template <typename T>
+static bool WriteSnapshotItems(FILE *File, const T *items, int count) {
+  return count <= 0 ||
+         fwrite(items, sizeof(*items), count, File) ==
+             static_cast<size_t>(count);
+}
+
+template <typename T>
+static bool ReadSnapshotItems(FILE *File, T *items, int count) {
+  return count <= 0 ||
+         fread(items, sizeof(*items), count, File) ==
+             static_cast<size_t>(count);
+}
+
+// Returns the number of ambigs of a permanent config, not counting the -1
+// that ends them.
+static int NumPermConfigAmbigs(PERM_CONFIG Config) {
+  int NumAmbigs = 0;
+  while (Config->Ambigs[NumAmbigs] >= 0) ++NumAmbigs;
+  return NumAmbigs;
+}
+
+/*---------------------------------------------------------------------------*/
+// Returns a deep copy of an integer class of adapted templates.
+static INT_CLASS CopyIntClass(INT_CLASS Class) {
+  INT_CLASS Copy = (INT_CLASS) Emalloc(sizeof(INT_CLASS_STRUCT));
+  *Copy = *Class;
+  for (int i = 0; i < Class->NumProtoSets; i++) {
+    Copy->ProtoSets[i] = (PROTO_SET) Emalloc(sizeof(PROTO_SET_STRUCT));
+    memcpy(Copy->ProtoSets[i], Class->ProtoSets[i], sizeof(PROTO_SET_STRUCT));
+  }
+  Copy->ProtoLengths = NULL;
+  if (MaxNumIntProtosIn(Class) > 0) {
+    Copy->ProtoLengths = (uinT8 *) Emalloc(MaxNumIntProtosIn(Class));
+    memcpy(Copy->ProtoLengths, Class->ProtoLengths, MaxNumIntProtosIn(Class));
+  }
+  return Copy;
+}
+
+// Returns a deep copy of the first NumConfigs configs, the protos and the
+// bits of an adapted class.
+static ADAPT_CLASS CopyAdaptedClass(ADAPT_CLASS Class, int NumConfigs) {
+  ADAPT_CLASS Copy = NewAdaptedClass();
+  Copy->NumPermConfigs = Class->NumPermConfigs;
+  Copy->MaxNumTimesSeen = Class->MaxNumTimesSeen;
+  copy_all_bits(Class->PermProtos, Copy->PermProtos,
+                WordsInVectorOfSize(MAX_NUM_PROTOS));
+  copy_all_bits(Class->PermConfigs, Copy->PermConfigs,
+                WordsInVectorOfSize(MAX_NUM_CONFIGS));
+
+  LIST TempProtos = Class->TempProtos;
+  iterate(TempProtos) {
+    TEMP_PROTO Proto = NewTempProto();
+    *Proto = *((TEMP_PROTO) first_node(TempProtos));
+    Copy->TempProtos = push_last(Copy->TempProtos, Proto);
+  }
+
+  for (int i = 0; i < NumConfigs; i++) {
+    if (ConfigIsPermanent(Class, i)) {
+      PERM_CONFIG Config = PermConfigFor(Class, i);
+      if (Config == NULL)
+        continue;
+      int NumAmbigs = NumPermConfigAmbigs(Config);
+      PERM_CONFIG ConfigCopy =
+        (PERM_CONFIG) alloc_struct(sizeof(PERM_CONFIG_STRUCT),
+                                   "PERM_CONFIG_STRUCT");
+      ConfigCopy->Ambigs =
+        (UNICHAR_ID *) Emalloc(sizeof(UNICHAR_ID) * (NumAmbigs + 1));
+      memcpy(ConfigCopy->Ambigs, Config->Ambigs,
+             sizeof(UNICHAR_ID) * (NumAmbigs + 1));
+      ConfigCopy->FontinfoId = Config->FontinfoId;
+      PermConfigFor(Copy, i) = ConfigCopy;
+    } else {
+      TEMP_CONFIG Config = TempConfigFor(Class, i);
+      if (Config == NULL)
+        continue;
+      assert(Config->ContextsSeen == NULL);
+      TEMP_CONFIG ConfigCopy =
+        NewTempConfig(Config->MaxProtoId, Config->FontinfoId);
+      ConfigCopy->NumTimesSeen = Config->NumTimesSeen;
+      copy_all_bits(Config->Protos, ConfigCopy->Protos,
+                    Config->ProtoVectorSize);
+      TempConfigFor(Copy, i) = ConfigCopy;
+    }
+  }
+  return Copy;
+}
+
+/**
+ * This routine returns a deep copy of a set of adapted templates,
+ * which must not be packed.
+ *
+ * @param Templates adapted templates to copy
+ * @return Ptr to the new copy of Templates.
+ */
+ADAPT_TEMPLATES CopyAdaptedTemplates(ADAPT_TEMPLATES Templates) {
+  INT_TEMPLATES IntTemplates = Templates->Templates;
+  assert(IntTemplates->PackedBlock == NULL);
+
+  ADAPT_TEMPLATES Copy =
+    (ADAPT_TEMPLATES) Emalloc(sizeof(ADAPT_TEMPLATES_STRUCT));
+  *Copy = *Templates;
+  Copy->Templates = NewIntTemplates();
+  INT_TEMPLATES IntCopy = Copy->Templates;
+  for (int i = 0; i < IntTemplates->NumClassPruners; i++) {
+    IntCopy->ClassPruner[i] =
+      (CLASS_PRUNER) Emalloc(sizeof(CLASS_PRUNER_STRUCT));
+    memcpy(IntCopy->ClassPruner[i], IntTemplates->ClassPruner[i],
+           sizeof(CLASS_PRUNER_STRUCT));
+  }
+  IntCopy->NumClassPruners = IntTemplates->NumClassPruners;
+  for (int i = 0; i < IntTemplates->NumClasses; i++) {
+    IntCopy->Class[i] = CopyIntClass(IntTemplates->Class[i]);
+    Copy->Class[i] = CopyAdaptedClass(Templates->Class[i],
+                                      IntTemplates->Class[i]->NumConfigs);
+  }
+  IntCopy->NumClasses = IntTemplates->NumClasses;
+  return Copy;
+}                                /* CopyAdaptedTemplates */
+
+/*---------------------------------------------------------------------------*/
+// Writes a class of adapted templates to a snapshot: its integer class,
+// then its adapted class.
+static bool WriteSnapshotClass(FILE *File, INT_CLASS IClass,
+                               ADAPT_CLASS AClass) {
+  if (!WriteSnapshotItems(File, &IClass->NumProtos, 1) ||
+      !WriteSnapshotItems(File, &IClass->NumProtoSets, 1) ||
+      !WriteSnapshotItems(File, &IClass->NumConfigs, 1) ||
+      !WriteSnapshotItems(File, IClass->ConfigLengths, IClass->NumConfigs) ||
+      !WriteSnapshotItems(File, IClass->ProtoLengths,
+                          MaxNumIntProtosIn(IClass)))
+    return false;
+  for (int i = 0; i < IClass->NumProtoSets; i++) {
+    if (!WriteSnapshotItems(File, IClass->ProtoSets[i], 1))
+      return false;
+  }
+  inT32 FontSetId = IClass->font_set_id;
+  if (!WriteSnapshotItems(File, &FontSetId, 1))
+    return false;
+
+  inT32 NumTempProtos = count(AClass->TempProtos);
+  if (!WriteSnapshotItems(File, &AClass->NumPermConfigs, 1) ||
+      !WriteSnapshotItems(File, &AClass->MaxNumTimesSeen, 1) ||
+      !WriteSnapshotItems(File, AClass->PermProtos,
+                          WordsInVectorOfSize(MAX_NUM_PROTOS)) ||
+      !WriteSnapshotItems(File, AClass->PermConfigs,
+                          WordsInVectorOfSize(MAX_NUM_CONFIGS)) ||
+      !WriteSnapshotItems(File, &NumTempProtos, 1))
+    return false;
+  LIST TempProtos = AClass->TempProtos;
+  iterate(TempProtos) {
+    TEMP_PROTO Proto = (TEMP_PROTO) first_node(TempProtos);
+    if (!WriteSnapshotItems(File, &Proto->ProtoId, 1) ||
+        !WriteSnapshotItems(File, &Proto->Proto, 1))
+      return false;
+  }
+  for (int i = 0; i < IClass->NumConfigs; i++) {
+    uinT8 Kind = SNAPSHOT_NO_CONFIG;
+    if (ConfigIsPermanent(AClass, i)) {
+      if (PermConfigFor(AClass, i) != NULL)
+        Kind = SNAPSHOT_PERM_CONFIG;
+    } else if (TempConfigFor(AClass, i) != NULL) {
+      Kind = SNAPSHOT_TEMP_CONFIG;
+    }
+    if (!WriteSnapshotItems(File, &Kind, 1))
+      return false;
+    if (Kind == SNAPSHOT_PERM_CONFIG) {
+      PERM_CONFIG Config = PermConfigFor(AClass, i);
+      inT32 NumAmbigs = NumPermConfigAmbigs(Config);
+      inT32 FontinfoId = Config->FontinfoId;
+      if (!WriteSnapshotItems(File, &NumAmbigs, 1) ||
+          !WriteSnapshotItems(File, Config->Ambigs, NumAmbigs) ||
+          !WriteSnapshotItems(File, &FontinfoId, 1))
+        return false;
+    } else if (Kind == SNAPSHOT_TEMP_CONFIG) {
+      TEMP_CONFIG Config = TempConfigFor(AClass, i);
+      assert(Config->ContextsSeen == NULL);
+      inT32 FontinfoId = Config->FontinfoId;
+      if (!WriteSnapshotItems(File, &Config->NumTimesSeen, 1) ||
+          !WriteSnapshotItems(File, &Config->MaxProtoId, 1) ||
+          !WriteSnapshotItems(File, &FontinfoId, 1) ||
+          !WriteSnapshotItems(File, Config->Protos, Config->ProtoVectorSize))
+        return false;
+    }
+  }
+  return true;
+}
+
+// Returns true if FontinfoId is a font of a table of NumFontinfos fonts, or
+// one of the negative ids that stand for no font.
+static bool ValidSnapshotFontinfoId(inT32 FontinfoId, int NumFontinfos) {
+  return FontinfoId >= kBlankFontinfoId && FontinfoId < NumFontinfos;
+}
+
+// Reads a class written by WriteSnapshotClass into a new integer class
+// and a new adapted class. The ids of the unichars, fonts and font sets it
+// refers to are checked against the sizes of the tables of the reader.
+// Returns false, with the classes left as far as they were read but safe
+// to free, if the snapshot is bad or truncated.
+static bool ReadSnapshotClass(FILE *File, int NumUnichars, int NumFontinfos,
+                              int NumFontsets, INT_CLASS *IClassPtr,
+                              ADAPT_CLASS *AClassPtr) {
+  INT_CLASS IClass = (INT_CLASS) Emalloc(sizeof(INT_CLASS_STRUCT));
+  IClass->NumProtoSets = 0;
+  IClass->ProtoLengths = NULL;
+  *IClassPtr = IClass;
+  ADAPT_CLASS AClass = NewAdaptedClass();
+  *AClassPtr = AClass;
+
+  uinT16 NumProtos;
+  uinT8 NumProtoSets, NumConfigs;
+  if (!ReadSnapshotItems(File, &NumProtos, 1) ||
+      !ReadSnapshotItems(File, &NumProtoSets, 1) ||
+      !ReadSnapshotItems(File, &NumConfigs, 1) ||
+      NumProtoSets > MAX_NUM_PROTO_SETS || NumConfigs > MAX_NUM_CONFIGS ||
+      NumProtos > NumProtoSets * PROTOS_PER_PROTO_SET)
+    return false;
+  IClass->NumProtos = NumProtos;
+  IClass->NumConfigs = NumConfigs;
+  if (!ReadSnapshotItems(File, IClass->ConfigLengths, NumConfigs))
+    return false;
+  int MaxNumProtos = NumProtoSets * PROTOS_PER_PROTO_SET;
+  if (MaxNumProtos > 0) {
+    IClass->ProtoLengths = (uinT8 *) Emalloc(MaxNumProtos);
+    if (!ReadSnapshotItems(File, IClass->ProtoLengths, MaxNumProtos))
+      return false;
+  }
+  for (int i = 0; i < NumProtoSets; i++) {
+    IClass->ProtoSets[i] = (PROTO_SET) Emalloc(sizeof(PROTO_SET_STRUCT));
+    IClass->NumProtoSets = i + 1;
+    if (!ReadSnapshotItems(File, IClass->ProtoSets[i], 1))
+      return false;
+  }
+  inT32 FontSetId;
+  if (!ReadSnapshotItems(File, &FontSetId, 1) ||
+      FontSetId < -1 || FontSetId >= NumFontsets)
+    return false;
+  IClass->font_set_id = FontSetId;
+
+  inT32 NumTempProtos;
+  if (!ReadSnapshotItems(File, &AClass->NumPermConfigs, 1) ||
+      !ReadSnapshotItems(File, &AClass->MaxNumTimesSeen, 1) ||
+      !ReadSnapshotItems(File, AClass->PermProtos,
+                         WordsInVectorOfSize(MAX_NUM_PROTOS)) ||
+      !ReadSnapshotItems(File, AClass->PermConfigs,
+                         WordsInVectorOfSize(MAX_NUM_CONFIGS)) ||
+      !ReadSnapshotItems(File, &NumTempProtos, 1) ||
+      NumTempProtos < 0 || NumTempProtos > MaxNumProtos)
+    return false;
+  for (int i = 0; i < NumTempProtos; i++) {
+    TEMP_PROTO Proto = NewTempProto();
+    AClass->TempProtos = push_last(AClass->TempProtos, Proto);
+    if (!ReadSnapshotItems(File, &Proto->ProtoId, 1) ||
+        !ReadSnapshotItems(File, &Proto->Proto, 1) ||
+        Proto->ProtoId >= NumProtos)
+      return false;
+  }
+  // The configs beyond NumConfigs are NULL, whatever the bits say.
+  for (int i = 0; i < MAX_NUM_CONFIGS; i++) {
+    uinT8 Kind = SNAPSHOT_NO_CONFIG;
+    if (i < NumConfigs && !ReadSnapshotItems(File, &Kind, 1))
+      return false;
+    if (Kind == SNAPSHOT_NO_CONFIG) {
+      reset_bit(AClass->PermConfigs, i);
+    } else if (Kind == SNAPSHOT_PERM_CONFIG) {
+      inT32 NumAmbigs;
+      if (!ReadSnapshotItems(File, &NumAmbigs, 1) ||
+          NumAmbigs < 0 || NumAmbigs > MAX_NUM_CLASSES)
+        return false;
+      PERM_CONFIG Config =
+        (PERM_CONFIG) alloc_struct(sizeof(PERM_CONFIG_STRUCT),
+                                   "PERM_CONFIG_STRUCT");
+      Config->Ambigs =
+        (UNICHAR_ID *) Emalloc(sizeof(UNICHAR_ID) * (NumAmbigs + 1));
+      Config->Ambigs[NumAmbigs] = -1;
+      MakeConfigPermanent(AClass, i);
+      PermConfigFor(AClass, i) = Config;
+      inT32 FontinfoId;
+      if (!ReadSnapshotItems(File, Config->Ambigs, NumAmbigs) ||
+          !ReadSnapshotItems(File, &FontinfoId, 1) ||
+          !ValidSnapshotFontinfoId(FontinfoId, NumFontinfos))
+        return false;
+      for (int a = 0; a < NumAmbigs; a++) {
+        if (Config->Ambigs[a] < 0 || Config->Ambigs[a] >= NumUnichars)
+          return false;
+      }
+      Config->FontinfoId = FontinfoId;
+    } else if (Kind == SNAPSHOT_TEMP_CONFIG) {
+      uinT8 NumTimesSeen;
+      PROTO_ID MaxProtoId;
+      inT32 FontinfoId;
+      if (!ReadSnapshotItems(File, &NumTimesSeen, 1) ||
+          !ReadSnapshotItems(File, &MaxProtoId, 1) ||
+          !ReadSnapshotItems(File, &FontinfoId, 1) ||
+          MaxProtoId < 0 || MaxProtoId >= NumProtos ||
+          !ValidSnapshotFontinfoId(FontinfoId, NumFontinfos))
+        return false;
+      reset_bit(AClass->PermConfigs, i);
+      TEMP_CONFIG Config = NewTempConfig(MaxProtoId, FontinfoId);
+      Config->NumTimesSeen = NumTimesSeen;
+      TempConfigFor(AClass, i) = Config;
+      if (!ReadSnapshotItems(File, Config->Protos, Config->ProtoVectorSize))
+        return false;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+namespace tesseract {
+/**
+ * This routine writes a snapshot of the current adapted templates to
+ * File, for ReadAdaptedSnapshot.
+ *
+ * @param File  open binary file to write the snapshot to
+ * @return false if the snapshot could not be written.
+ */
+bool Classify::WriteAdaptedSnapshot(FILE *File) {
+  if (AdaptedTemplates == NULL)
+    AdaptedTemplates = NewAdaptedTemplates(true);
+  INT_TEMPLATES IntTemplates = AdaptedTemplates->Templates;
+  inT32 Header[7] = {
+    static_cast<inT32>(kAdaptedSnapshotMagic), kAdaptedSnapshotVersion,
+    unicharset.size(), IntTemplates->NumClasses,
+    IntTemplates->NumClassPruners, AdaptedTemplates->NumNonEmptyClasses,
+    AdaptedTemplates->NumPermClasses
+  };
+  if (!WriteSnapshotItems(File, Header, 7))
+    return false;
+  for (int i = 0; i < IntTemplates->NumClassPruners; i++) {
+    if (!WriteSnapshotItems(File, IntTemplates->ClassPruner[i], 1))
+      return false;
+  }
+  for (int i = 0; i < IntTemplates->NumClasses; i++) {
+    if (!WriteSnapshotClass(File, IntTemplates->Class[i],
+                            AdaptedTemplates->Class[i]))
+      return false;
+  }
+  return WriteSnapshotItems(File, &kAdaptedSnapshotMagic, 1);
+}                                /* WriteAdaptedSnapshot */
+
+/**
+ * This routine replaces the adapted templates with those of a snapshot
+ * written by WriteAdaptedSnapshot for the same unicharset. The current
+ * templates are kept if the snapshot is bad, or if the templates are
+ * borrowed from another instance.
+ *
+ * @param File  open binary file to read the snapshot from
+ * @return false if the adapted templates were not replaced.
+ */
+bool Classify::ReadAdaptedSnapshot(FILE *File) {
+  if (own_adapted_templates_ != NULL)
+    return false;
+  inT32 Header[7];
+  if (!ReadSnapshotItems(File, Header, 7))
+    return false;
+  if (static_cast<uinT32>(Header[0]) != kAdaptedSnapshotMagic ||
+      Header[1] != kAdaptedSnapshotVersion) {
+    tprintf("Error: not an adapted templates snapshot of version %d\n",
+            kAdaptedSnapshotVersion);
+    return false;
+  }
+  if (Header[2] != unicharset.size()) {
+    tprintf("Error: adapted templates snapshot for a unicharset of size %d,"
+            " not %d\n", Header[2], unicharset.size());
+    return false;
+  }
+  // The adapted templates have a class for each unichar and the class
+  // pruners that hold them.
+  int NumClasses = Header[3];
+  int NumClassPruners = Header[4];
+  if (NumClasses != unicharset.size() ||
+      NumClassPruners != (NumClasses + CLASSES_PER_CP - 1) / CLASSES_PER_CP ||
+      Header[5] < 0 || Header[5] > NumClasses ||
+      Header[6] < 0 || Header[6] > NumClasses) {
+    tprintf("Error: bad adapted templates snapshot header\n");
+    return false;
+  }
+
+  ADAPT_TEMPLATES Templates = NewAdaptedTemplates(false);
+  Templates->NumNonEmptyClasses = Header[5];
+  Templates->NumPermClasses = Header[6];
+  INT_TEMPLATES IntTemplates = Templates->Templates;
+  bool ok = true;
+  for (int i = 0; ok && i < NumClassPruners; i++) {
+    IntTemplates->ClassPruner[i] =
+      (CLASS_PRUNER) Emalloc(sizeof(CLASS_PRUNER_STRUCT));
+    IntTemplates->NumClassPruners = i + 1;
+    ok = ReadSnapshotItems(File, IntTemplates->ClassPruner[i], 1);
+  }
+  for (int i = 0; ok && i < NumClasses; i++) {
+    ok = ReadSnapshotClass(File, unicharset.size(), fontinfo_table_.size(),
+                           fontset_table_.size(), &IntTemplates->Class[i],
+                           &Templates->Class[i]);
+    IntTemplates->NumClasses = i + 1;
+  }
+  uinT32 Magic = 0;
+  if (ok && (!ReadSnapshotItems(File, &Magic, 1) ||
+             Magic != kAdaptedSnapshotMagic))
+    ok = false;
+  if (!ok) {
+    tprintf("Error: bad or truncated adapted templates snapshot\n");
+    free_adapted_templates(Templates);
+    return false;
+  }
+  ReplaceAdaptedTemplates(Templates);
+  return true;
+}                                /* ReadAdaptedSnapshot */
+
+/**
+ * This routine replaces the adapted templates with a copy of those of
+ * source, which must be an instance of the same language, so that the copy
+ * goes on learning from the state of source without any relearning.
+ * Nothing is done if the templates are borrowed from another instance.
+ *
+ * @param source  classifier to copy the adapted templates of
+ * @return false if the adapted templates were not replaced.
+ */
+bool Classify::CopyAdaptedTemplatesFrom(const Classify& source) {
+  if (own_adapted_templates_ != NULL || &source == this ||
+      source.unicharset.size() != unicharset.size())
+    return false;
+  ReplaceAdaptedTemplates(source.AdaptedTemplates != NULL
+                          ? CopyAdaptedTemplates(source.AdaptedTemplates)
+                          : NewAdaptedTemplates(true));
+  return true;
+}                                /* CopyAdaptedTemplatesFrom */
+
+// Frees the adapted templates and replaces them with Templates, setting
+// the baseline cutoffs of their classes as InitAdaptedClass does for the
+// classes it makes, and forgetting what was derived from the old ones.
+void Classify::ReplaceAdaptedTemplates(ADAPT_TEMPLATES Templates) {
+  if (AdaptedTemplates != NULL)
+    free_adapted_templates(AdaptedTemplates);
+  AdaptedTemplates = Templates;
+  SetAdaptedClassCutoffs();
+  NumAdaptationsFailed = 0;
+  InvalidateBlobClassCache();
+}
+
+// Sets the baseline cutoffs of the classes of the adapted templates.
+void Classify::SetAdaptedClassCutoffs() {
+  for (int i = 0; i < AdaptedTemplates->Templates->NumClasses; i++) {
+    if (!IsEmptyAdaptedClass(AdaptedTemplates->Class[i]))
+      BaselineCutoffs[i] = CharNormCutoffs[i];
+  }
+}
+}  // namespace tesseract
@@ -172,12 +172,28 @@ namespace tesseract {
 void Classify::AdaptiveClassifier(TBLOB *Blob,
                                   BLOB_CHOICE_LIST *Choices,
                                   CLASS_PRUNER_RESULTS CPResults) {
+  PageStageTimer timer(page_stats(), PAGE_STAGE_ADAPTIVE_CLASSIFIER);
   assert(Choices != NULL);
-  ADAPT_RESULTS *Results = new ADAPT_RESULTS();
 
   if (AdaptedTemplates == NULL)
     AdaptedTemplates = NewAdaptedTemplates (true);
 
+  // The cache cannot give the class pruner results.
+  bool use_cache = classify_cache_size > 0 && CPResults == NULL;
+  inT64 generation = 0;
+  if (use_cache) {
+    if (blob_class_cache_.max_entries() != classify_cache_size)
+      blob_class_cache_.Resize(classify_cache_size);
+    // The matching flags choose the classifiers used.
+    generation = blob_class_generation_ * 4 + (tess_cn_matching ? 2 : 0) +
+                 (tess_bn_matching ? 1 : 0);
+    if (blob_class_cache_.Lookup(Blob, generation, Choices)) {
+      NumClassesOutput += Choices->length();
+      return;
+    }
+  }
+
+  ADAPT_RESULTS *Results = new ADAPT_RESULTS();
   Results->Initialize();
 
   DoAdaptiveMatch(Blob, Results);
@@ -185,6 +201,104 @@ void Classify::AdaptiveClassifier(TBLOB *Blob,
     memcpy(CPResults, Results->CPResults,
            sizeof(CPResults[0]) * Results->NumMatches);
 
+  ConvertAdaptiveResults(Blob, Results, Choices);
+  delete Results;
+  if (use_cache)
+    blob_class_cache_.Store(Blob, generation, Choices);
+}                                /* AdaptiveClassifier */
+
+/*---------------------------------------------------------------------------*/
+/**
+ * This routine classifies a batch of blobs with the adaptive
+ * classifier, sharing the results array, the class pruner scratch
+ * space and the choice of classifier between the blobs.  When only
+ * the char norm classifier is used, which is the case until enough
+ * classes are adapted to, the features of all the blobs are
+ * extracted in a first loop and the blobs are pruned and matched in
+ * a second one, so that each loop keeps its own code and tables in
+ * the caches.  The choices are the same as those of
+ * AdaptiveClassifier called on each blob.
+ *
+ * @param num_blobs number of blobs to classify
+ * @param blobs blobs to classify
+ * @param denorms normalization of each blob, or NULL to use denorm_
+ * @param[out] choices list to add the choices of each blob to
+ */
+void Classify::AdaptiveClassifierBatch(int num_blobs, TBLOB** blobs,
+                                       const DENORM* const* denorms,
+                                       BLOB_CHOICE_LIST** choices) {
+  PageStageTimer timer(page_stats(), PAGE_STAGE_ADAPTIVE_CLASSIFIER);
+  if (num_blobs <= 0)
+    return;
+  ADAPT_RESULTS *Results = new ADAPT_RESULTS();
+  DENORM saved_denorm(denorm_);
+
+  if (AdaptedTemplates == NULL)
+    AdaptedTemplates = NewAdaptedTemplates (true);
+
+  if (AdaptedTemplates->NumPermClasses < matcher_permanent_classes_min ||
+      tess_cn_matching) {
+    struct BlobFeatures {
+      int num_features;
+      inT32 blob_length;
+      INT_FEATURE_ARRAY features;
+      CLASS_NORMALIZATION_ARRAY char_norm_array;
+    };
+    BlobFeatures *blob_features = new BlobFeatures[num_blobs];
+    for (int b = 0; b < num_blobs; ++b) {
+      if (denorms != NULL)
+        denorm_ = *denorms[b];
+      InitIntFX();
+      blob_features[b].num_features = GetCharNormFeatures(
+          blobs[b], PreTrainedTemplates, blob_features[b].features,
+          blob_features[b].char_norm_array, &blob_features[b].blob_length,
+          NULL);
+    }
+    for (int b = 0; b < num_blobs; ++b) {
+      PageStageTimer cn_timer(page_stats(), PAGE_STAGE_CHAR_NORM_CLASSIFIER);
+      assert(choices[b] != NULL);
+      AdaptiveMatcherCalls++;
+      CharNormClassifierCalls++;
+      Results->Initialize();
+      Results->BlobLength = blob_features[b].blob_length;
+      if (blob_features[b].num_features > 0) {
+        CharNormMatch(blobs[b], PreTrainedTemplates,
+                      blob_features[b].num_features,
+                      blob_features[b].features,
+                      blob_features[b].char_norm_array, Results);
+      }
+      FinishAdaptiveMatch(Results);
+      ConvertAdaptiveResults(blobs[b], Results, choices[b]);
+    }
+    delete [] blob_features;
+  } else {
+    for (int b = 0; b < num_blobs; ++b) {
+      assert(choices[b] != NULL);
+      if (denorms != NULL)
+        denorm_ = *denorms[b];
+      Results->Initialize();
+      DoAdaptiveMatch(blobs[b], Results);
+      ConvertAdaptiveResults(blobs[b], Results, choices[b]);
+    }
+  }
+
+  denorm_ = saved_denorm;
+  delete Results;
+}                                /* AdaptiveClassifierBatch */
+
+/*---------------------------------------------------------------------------*/
+/**
+ * This routine removes the bad matches from the results of the
+ * adaptive matcher of Blob, sorts the others and adds them to
+ * Choices.
+ *
+ * @param Blob blob that was classified
+ * @param Results results of DoAdaptiveMatch for Blob
+ * @param[out] Choices list to add the choices to
+ */
+void Classify::ConvertAdaptiveResults(TBLOB *Blob,
+                                      ADAPT_RESULTS *Results,
+                                      BLOB_CHOICE_LIST *Choices) {
   RemoveBadMatches(Results);
   qsort((void *)Results->match, Results->NumMatches,
         sizeof(ScoredClass), CompareByRating);
@@ -213,9 +327,7 @@ void Classify::AdaptiveClassifier(TBLOB *Blob,
     temp_it.set_to_list(Choices);
     temp_it.add_to_end(new BLOB_CHOICE(0, 50.0f, -20.0f, -1, -1, NULL));
   }
-
-  delete Results;
-}                                /* AdaptiveClassifier */
+}                                /* ConvertAdaptiveResults */
 
 // If *win is NULL, sets it to a new ScrollView() object with title msg.
 // Clears the window and draws baselines.
@@ -436,6 +548,8 @@ void Classify::EndAdaptiveClassifier() {
   STRING Filename;
   FILE *File;
 
+  ReadAdaptedTemplatesFrom(NULL);
+  BorrowAdaptedTemplates(NULL);
   #ifndef SECURE_NAMES
   if (AdaptedTemplates != NULL &&
       classify_enable_adaptive_matcher && classify_save_adapted_templates) {
@@ -457,7 +571,16 @@ void Classify::EndAdaptiveClassifier() {
     free_adapted_templates(AdaptedTemplates);
     AdaptedTemplates = NULL;
   }
+  blob_class_cache_.Clear();
+  InvalidateBlobClassCache();
 
+  if (shared_templates_) {
+    // Borrowed from the master Classify, which will free them.
+    PreTrainedTemplates = NULL;
+    NormProtos = NULL;
+    ResetFontTables();
+    shared_templates_ = false;
+  }
   if (PreTrainedTemplates != NULL) {
     free_int_templates(PreTrainedTemplates);
     PreTrainedTemplates = NULL;
@@ -512,18 +635,22 @@ void Classify::InitAdaptiveClassifier(bool load_pre_trained_templates) {
     ASSERT_HOST(tessdata_manager.SeekToStart(TESSDATA_INTTEMP));
     PreTrainedTemplates =
       ReadIntTemplates(tessdata_manager.GetDataFilePtr());
+    PackIntTemplates(PreTrainedTemplates);
+    tessdata_manager.SetLoaded(TESSDATA_INTTEMP);
     if (tessdata_manager.DebugLevel() > 0) tprintf("Loaded inttemp\n");
 
     ASSERT_HOST(tessdata_manager.SeekToStart(TESSDATA_PFFMTABLE));
     ReadNewCutoffs(tessdata_manager.GetDataFilePtr(),
                    tessdata_manager.GetEndOffset(TESSDATA_PFFMTABLE),
                    CharNormCutoffs);
+    tessdata_manager.SetLoaded(TESSDATA_PFFMTABLE);
     if (tessdata_manager.DebugLevel() > 0) tprintf("Loaded pffmtable\n");
 
     ASSERT_HOST(tessdata_manager.SeekToStart(TESSDATA_NORMPROTO));
     NormProtos =
       ReadNormProtos(tessdata_manager.GetDataFilePtr(),
                      tessdata_manager.GetEndOffset(TESSDATA_NORMPROTO));
+    tessdata_manager.SetLoaded(TESSDATA_NORMPROTO);
     if (tessdata_manager.DebugLevel() > 0) tprintf("Loaded normproto\n");
   }
 
@@ -577,6 +704,82 @@ void Classify::InitAdaptiveClassifier(bool load_pre_trained_templates) {
   }
 }                                /* InitAdaptiveClassifier */
 
+/*---------------------------------------------------------------------------*/
+/**
+ * This routine initializes the adaptive classifier of a worker that shares
+ * the read-only training information of master (see TessBaseAPIPool).
+ * The pre-trained templates, normprotos and font tables are borrowed, and
+ * only the adapted templates and the proto/config masks are allocated.
+ *  Parameters:
+ *      master  Classify whose InitAdaptiveClassifier has already been called.
+ *              It must not be ended or deleted before this Classify.
+ */
+void Classify::InitSharedAdaptiveClassifier(const Classify& master) {
+  if (!classify_enable_adaptive_matcher)
+    return;
+  // Everything but the pre-trained data is private to this Classify.
+  // The cutoffs are copied first as they are used by pre-adapted templates.
+  memcpy(CharNormCutoffs, master.CharNormCutoffs, sizeof(CharNormCutoffs));
+  InitAdaptiveClassifier(false);
+  PreTrainedTemplates = master.PreTrainedTemplates;
+  NormProtos = master.NormProtos;
+  ShareFontTables(master);
+  shared_templates_ = true;
+}                                /* InitSharedAdaptiveClassifier */
+
+void Classify::BorrowAdaptedTemplates(const Classify* master) {
+  InvalidateBlobClassCache();
+  if (master != NULL) {
+    if (own_adapted_templates_ == NULL) {
+      own_adapted_templates_ = AdaptedTemplates;
+      own_enable_learning_ = EnableLearning;
+    }
+    AdaptedTemplates = master->AdaptedTemplates;
+    memcpy(BaselineCutoffs, master->BaselineCutoffs, sizeof(BaselineCutoffs));
+    EnableLearning = false;
+  } else if (own_adapted_templates_ != NULL) {
+    AdaptedTemplates = own_adapted_templates_;
+    own_adapted_templates_ = NULL;
+    EnableLearning = own_enable_learning_;
+  }
+}
+
+void Classify::ReadAdaptedTemplatesFrom(AdaptedTemplatesStore* store) {
+  if (templates_store_ != NULL) {
+    templates_store_->Release(store_version_);
+    store_version_ = NULL;
+    templates_store_ = NULL;
+    AdaptedTemplates = own_adapted_templates_;
+    own_adapted_templates_ = NULL;
+    EnableLearning = own_enable_learning_;
+    InvalidateBlobClassCache();
+  }
+  if (store != NULL) {
+    own_adapted_templates_ = AdaptedTemplates;
+    own_enable_learning_ = EnableLearning;
+    EnableLearning = false;
+    templates_store_ = store;
+    RefreshAdaptedTemplates();
+  }
+}
+
+void Classify::RefreshAdaptedTemplates() {
+  if (templates_store_ == NULL)
+    return;
+  AdaptedTemplatesStore::Version* version =
+      templates_store_->Update(store_version_);
+  if (version == store_version_)
+    return;
+  store_version_ = version;
+  if (version != NULL) {
+    AdaptedTemplates = version->templates;
+    SetAdaptedClassCutoffs();
+  } else {
+    AdaptedTemplates = own_adapted_templates_;
+  }
+  InvalidateBlobClassCache();
+}
+
 void Classify::ResetAdaptiveClassifier() {
   if (classify_learning_debug_level > 0) {
     tprintf("Resetting adaptive classifier (NumAdaptationsFailed=%d)\n",
@@ -585,6 +788,7 @@ void Classify::ResetAdaptiveClassifier() {
   free_adapted_templates(AdaptedTemplates);
   AdaptedTemplates = NULL;
   NumAdaptationsFailed = 0;
+  InvalidateBlobClassCache();
 }
 
 
@@ -622,6 +826,9 @@ void Classify::PrintAdaptiveStatistics(FILE *File) {
     ((AmbigClassifierCalls == 0) ? (0.0) :
   ((float) NumAmbigClassesTried / AmbigClassifierCalls)));
 
+  fprintf (File, "\t\tBlob class cache: %d hits, %d misses\n",
+    blob_class_cache_.hits(), blob_class_cache_.misses());
+
   fprintf (File, "\nADAPTIVE LEARNER STATISTICS:\n");
   fprintf (File, "\tNumber of words adapted to: %d\n", NumWordsAdaptedTo);
   fprintf (File, "\tNumber of chars adapted to: %d\n", NumCharsAdaptedTo);
@@ -888,6 +1095,7 @@ void Classify::AdaptToChar(TBLOB *Blob,
   NumCharsAdaptedTo++;
   if (!LegalClassId (ClassId))
     return;
+  InvalidateBlobClassCache();
 
   Class = AdaptedTemplates->Class[ClassId];
   assert(Class != NULL);
@@ -1379,9 +1587,9 @@ int Classify::CharNormClassifier(TBLOB *Blob,
                                  INT_TEMPLATES Templates,
                                  ADAPT_RESULTS *Results) {
   int NumFeatures;
-  int NumClasses;
   INT_FEATURE_ARRAY IntFeatures;
   CLASS_NORMALIZATION_ARRAY CharNormArray;
+  PageStageTimer timer(page_stats(), PAGE_STAGE_CHAR_NORM_CLASSIFIER);
 
   CharNormClassifierCalls++;
 
@@ -1390,6 +1598,32 @@ int Classify::CharNormClassifier(TBLOB *Blob,
   if (NumFeatures <= 0)
     return 0;
 
+  CharNormMatch(Blob, Templates, NumFeatures, IntFeatures, CharNormArray,
+                Results);
+  return NumFeatures;
+}                                /* CharNormClassifier */
+
+/*---------------------------------------------------------------------------*/
+/**
+ * This routine prunes and matches the char norm features of Blob
+ * against the specified set of templates.  The classes which match
+ * are added to Results, whose BlobLength must be set.
+ *
+ * @param Blob blob to be classified
+ * @param Templates templates to classify unknown against
+ * @param NumFeatures number of features in IntFeatures
+ * @param IntFeatures char norm features of Blob
+ * @param CharNormArray char norm adjustments of Blob
+ * @param Results place to put match results
+ */
+void Classify::CharNormMatch(TBLOB *Blob,
+                             INT_TEMPLATES Templates,
+                             int NumFeatures,
+                             INT_FEATURE_ARRAY IntFeatures,
+                             CLASS_NORMALIZATION_ARRAY CharNormArray,
+                             ADAPT_RESULTS *Results) {
+  int NumClasses;
+
   NumClasses = ClassPruner(Templates, NumFeatures, IntFeatures, CharNormArray,
                            CharNormCutoffs, Results->CPResults);
 
@@ -1401,8 +1635,7 @@ int Classify::CharNormClassifier(TBLOB *Blob,
   MasterMatcher(Templates, NumFeatures, IntFeatures, CharNormArray,
                 NULL, matcher_debug_flags, NumClasses,
                 Blob->bounding_box(), Results->CPResults, Results);
-  return NumFeatures;
-}                                /* CharNormClassifier */
+}                                /* CharNormMatch */
 
 
 /*---------------------------------------------------------------------------*/
@@ -1633,6 +1866,12 @@ void Classify::DoAdaptiveMatch(TBLOB *Blob,
     }
   }
 
+  FinishAdaptiveMatch(Results);
+}   /* DoAdaptiveMatch */
+
+/// Classifies the blob of Results as noise if the results contain only
+/// fragments or nothing.
+void Classify::FinishAdaptiveMatch(ADAPT_RESULTS *Results) {
   // Force the blob to be classified as noise
   // if the results contain only fragments.
   // TODO(daria): verify that this is better than
@@ -1642,7 +1881,7 @@ void Classify::DoAdaptiveMatch(TBLOB *Blob,
   }
   if (Results->NumMatches == 0)
     ClassifyAsNoise(Results);
-}   /* DoAdaptiveMatch */
+}
 
 /*---------------------------------------------------------------------------*/
 /**
@@ -2283,6 +2522,7 @@ void Classify::MakePermanent(ADAPT_TEMPLATES Templates,
   Class = Templates->Class[ClassId];
   Config = TempConfigFor(Class, ConfigId);
 
+  InvalidateBlobClassCache();
   MakeConfigPermanent(Class, ConfigId);
   if (Class->NumPermConfigs == 0)
     Templates->NumPermClasses++;
@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////
+// File:        adaptstore.cpp
+// Description: Published versions of adapted templates for readers in
+//              other threads.
+//
+// (C) Copyright 2011, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "adaptstore.h"
+
+namespace tesseract {
+
+AdaptedTemplatesStore::AdaptedTemplatesStore()
+  : newest_(NULL), num_published_(0) {
+}
+
+AdaptedTemplatesStore::~AdaptedTemplatesStore() {
+  if (newest_ != NULL && Unref(newest_))
+    Delete(newest_);
+}
+
+void AdaptedTemplatesStore::Publish(ADAPT_TEMPLATES templates) {
+  Version* version = new Version;
+  version->templates = templates;
+  version->refs = 1;
+  mutex_.Lock();
+  version->number = ++num_published_;
+  Version* old = newest_;
+  newest_ = version;
+  bool delete_old = old != NULL && Unref(old);
+  mutex_.Unlock();
+  // The templates are freed outside the lock, not to hold up the readers.
+  if (delete_old)
+    Delete(old);
+}
+
+AdaptedTemplatesStore::Version* AdaptedTemplatesStore::Update(
+    Version* held) {
+  mutex_.Lock();
+  Version* newest = newest_;
+  if (newest == held) {
+    mutex_.Unlock();
+    return held;
+  }
+  if (newest != NULL)
+    ++newest->refs;
+  bool delete_held = held != NULL && Unref(held);
+  mutex_.Unlock();
+  if (delete_held)
+    Delete(held);
+  return newest;
+}
+
+void AdaptedTemplatesStore::Release(Version* version) {
+  if (version == NULL)
+    return;
+  mutex_.Lock();
+  bool delete_version = Unref(version);
+  mutex_.Unlock();
+  if (delete_version)
+    Delete(version);
+}
+
+bool AdaptedTemplatesStore::Unref(Version* version) {
+  return --version->refs == 0;
+}
+
+void AdaptedTemplatesStore::Delete(Version* version) {
+  free_adapted_templates(version->templates);
+  delete version;
+}
+
+}  // namespace tesseract
@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////
+// File:        adaptstore.h
+// Description: Published versions of adapted templates for readers in
+//              other threads.
+//
+// (C) Copyright 2011, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CLASSIFY_ADAPTSTORE_H__
+#define TESSERACT_CLASSIFY_ADAPTSTORE_H__
+
+#include "adaptive.h"
+#include "ccutil.h"
+#include "host.h"
+
+namespace tesseract {
+
+// Adapted templates shared between one writer and many reader threads.
+// The writer learns into templates of its own and publishes a copy of them
+// from time to time, which becomes the newest version. A version is never
+// modified once published, so a reader matches against the version it holds
+// without any lock, and only takes the lock of the store between words to
+// move to the newest version. A version is freed when it has been replaced
+// and the last reader holding it has moved on.
+class AdaptedTemplatesStore {
+ public:
+  struct Version {
+    ADAPT_TEMPLATES templates;
+    // Number of the version, counting from 1 in the order of publication.
+    inT64 number;
+    // Number of readers holding the version, plus 1 while it is the newest.
+    int refs;
+  };
+
+  AdaptedTemplatesStore();
+  // All the readers must have released their versions.
+  ~AdaptedTemplatesStore();
+
+  // Makes templates, which the store takes ownership of and which must not
+  // be modified again, the newest version.
+  void Publish(ADAPT_TEMPLATES templates);
+  // Returns the newest version, or NULL if none was published, for a reader
+  // that holds the given version, or NULL. The version held is released if
+  // it is not the newest, and kept otherwise, so that Update can be called
+  // again with the result.
+  Version* Update(Version* held);
+  // Releases a version returned by Update.
+  void Release(Version* version);
+
+ private:
+  // Drops a reference to version and returns true if it must be deleted.
+  // Must be called with mutex_ locked.
+  static bool Unref(Version* version);
+  // Frees a version that no one references.
+  static void Delete(Version* version);
+
+  CCUtilMutex mutex_;
+  Version* newest_;
+  inT64 num_published_;
+};
+
+}  // namespace tesseract
+
+#endif  // TESSERACT_CLASSIFY_ADAPTSTORE_H__
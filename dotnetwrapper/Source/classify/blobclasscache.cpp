@@ -0,0 +1,215 @@
+///////////////////////////////////////////////////////////////////////
+// File:        blobclasscache.cpp
+// Description: Cache of the choices of the adaptive classifier for blobs.
+//
+// (C) Copyright 2011, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "blobclasscache.h"
+
+#include "blobs.h"
+
+namespace tesseract {
+
+BlobClassCache::BlobClassCache()
+  : max_entries_(0), num_entries_(0), entries_(NULL), buckets_(NULL),
+    bucket_mask_(0), newest_(-1), oldest_(-1), hits_(0), misses_(0) {
+}
+
+BlobClassCache::~BlobClassCache() {
+  Resize(0);
+}
+
+void BlobClassCache::Resize(int max_entries) {
+  Clear();
+  delete [] entries_;
+  delete [] buckets_;
+  entries_ = NULL;
+  buckets_ = NULL;
+  bucket_mask_ = 0;
+  max_entries_ = max_entries > 0 ? max_entries : 0;
+  if (max_entries_ == 0)
+    return;
+  entries_ = new Entry[max_entries_];
+  for (int e = 0; e < max_entries_; ++e)
+    entries_[e].choices = NULL;
+  // At least twice as many buckets as entries keeps the chains short.
+  int num_buckets = 1;
+  while (num_buckets < 2 * max_entries_)
+    num_buckets *= 2;
+  bucket_mask_ = num_buckets - 1;
+  buckets_ = new int[num_buckets];
+  for (int b = 0; b < num_buckets; ++b)
+    buckets_[b] = -1;
+}
+
+void BlobClassCache::Clear() {
+  for (int e = 0; e < num_entries_; ++e) {
+    delete entries_[e].choices;
+    entries_[e].choices = NULL;
+    entries_[e].outlines.clear();
+  }
+  if (buckets_ != NULL) {
+    for (uinT32 b = 0; b <= bucket_mask_; ++b)
+      buckets_[b] = -1;
+  }
+  num_entries_ = 0;
+  newest_ = -1;
+  oldest_ = -1;
+}
+
+bool BlobClassCache::Lookup(TBLOB* blob, inT64 generation,
+                            BLOB_CHOICE_LIST* choices) {
+  if (max_entries_ == 0)
+    return false;
+  int index = Find(MakeKey(blob, generation), generation);
+  if (index < 0) {
+    ++misses_;
+    return false;
+  }
+  ++hits_;
+  MakeNewest(index);
+  BLOB_CHOICE_IT src_it(entries_[index].choices);
+  BLOB_CHOICE_IT dest_it(choices);
+  for (src_it.mark_cycle_pt(); !src_it.cycled_list(); src_it.forward())
+    dest_it.add_to_end(BLOB_CHOICE::deep_copy(src_it.data()));
+  return true;
+}
+
+void BlobClassCache::Store(TBLOB* blob, inT64 generation,
+                           BLOB_CHOICE_LIST* choices) {
+  if (max_entries_ == 0)
+    return;
+  uinT32 hash = MakeKey(blob, generation);
+  if (Find(hash, generation) >= 0)
+    return;
+  int index;
+  if (num_entries_ < max_entries_) {
+    index = num_entries_++;
+  } else {
+    index = oldest_;
+    Unlink(index);
+    delete entries_[index].choices;
+  }
+  Entry& entry = entries_[index];
+  entry.hash = hash;
+  entry.generation = generation;
+  entry.outlines = key_;
+  entry.choices = new BLOB_CHOICE_LIST;
+  entry.choices->deep_copy(choices, &BLOB_CHOICE::deep_copy);
+  entry.next_in_bucket = buckets_[hash & bucket_mask_];
+  buckets_[hash & bucket_mask_] = index;
+  entry.newer = -1;
+  entry.older = newest_;
+  if (newest_ >= 0)
+    entries_[newest_].newer = index;
+  newest_ = index;
+  if (oldest_ < 0)
+    oldest_ = index;
+}
+
+// The key holds, for each outline, the number of points, the points with
+// x in the low 16 bits and y in the high 16 bits, the number of points that
+// start a hidden edge and their indices.
+uinT32 BlobClassCache::MakeKey(TBLOB* blob, inT64 generation) {
+  key_.truncate(0);
+  for (TESSLINE* outline = blob->outlines; outline != NULL;
+       outline = outline->next) {
+    int count_index = key_.size();
+    key_.push_back(0);
+    int num_points = 0;
+    EDGEPT* pt = outline->loop;
+    if (pt != NULL) {
+      do {
+        uinT32 xy = static_cast<uinT16>(pt->pos.x) |
+                    static_cast<uinT32>(static_cast<uinT16>(pt->pos.y)) << 16;
+        key_.push_back(static_cast<inT32>(xy));
+        ++num_points;
+        pt = pt->next;
+      } while (pt != NULL && pt != outline->loop);
+    }
+    key_[count_index] = num_points;
+    int hidden_index = key_.size();
+    key_.push_back(0);
+    int num_hidden = 0;
+    pt = outline->loop;
+    for (int i = 0; i < num_points; ++i, pt = pt->next) {
+      if (pt->IsHidden()) {
+        key_.push_back(i);
+        ++num_hidden;
+      }
+    }
+    key_[hidden_index] = num_hidden;
+  }
+  // FNV-1a over the words of the key and the generation.
+  uinT32 hash = 2166136261U;
+  for (int i = 0; i < key_.size(); ++i) {
+    hash ^= static_cast<uinT32>(key_[i]);
+    hash *= 16777619U;
+  }
+  hash ^= static_cast<uinT32>(generation);
+  hash *= 16777619U;
+  hash ^= static_cast<uinT32>(generation >> 32);
+  hash *= 16777619U;
+  return hash;
+}
+
+int BlobClassCache::Find(uinT32 hash, inT64 generation) const {
+  for (int index = buckets_[hash & bucket_mask_]; index >= 0;
+       index = entries_[index].next_in_bucket) {
+    const Entry& entry = entries_[index];
+    if (entry.hash != hash || entry.generation != generation ||
+        entry.outlines.size() != key_.size())
+      continue;
+    int i = 0;
+    while (i < key_.size() && entry.outlines[i] == key_[i])
+      ++i;
+    if (i == key_.size())
+      return index;
+  }
+  return -1;
+}
+
+void BlobClassCache::Unlink(int index) {
+  Entry& entry = entries_[index];
+  int* link = &buckets_[entry.hash & bucket_mask_];
+  while (*link != index)
+    link = &entries_[*link].next_in_bucket;
+  *link = entry.next_in_bucket;
+  if (entry.newer >= 0)
+    entries_[entry.newer].older = entry.older;
+  else
+    newest_ = entry.older;
+  if (entry.older >= 0)
+    entries_[entry.older].newer = entry.newer;
+  else
+    oldest_ = entry.newer;
+}
+
+void BlobClassCache::MakeNewest(int index) {
+  if (index == newest_)
+    return;
+  Entry& entry = entries_[index];
+  // Take the entry out of the used list, which it is not the head of.
+  entries_[entry.newer].older = entry.older;
+  if (entry.older >= 0)
+    entries_[entry.older].newer = entry.newer;
+  else
+    oldest_ = entry.newer;
+  entry.newer = -1;
+  entry.older = newest_;
+  entries_[newest_].newer = index;
+  newest_ = index;
+}
+
+}  // namespace tesseract
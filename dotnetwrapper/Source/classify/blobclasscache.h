@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////////
+// File:        blobclasscache.h
+// Description: Cache of the choices of the adaptive classifier for blobs.
+//
+// (C) Copyright 2011, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CLASSIFY_BLOBCLASSCACHE_H__
+#define TESSERACT_CLASSIFY_BLOBCLASSCACHE_H__
+
+#include "genericvector.h"
+#include "host.h"
+#include "ratngs.h"
+
+struct TBLOB;
+
+namespace tesseract {
+
+// A least recently used cache of the choices of the classifier for blobs.
+// An entry is keyed by the outlines of the normalized blob, which are all the
+// classifier looks at, and by a generation number of the state of the
+// classifier given by the caller, so that entries made before the adapted
+// templates or the enabled characters changed are never returned.
+// The outlines are stored in full, so that a hit is never a hash collision:
+// the choices returned are the ones the classifier gave for the same input.
+class BlobClassCache {
+ public:
+  BlobClassCache();
+  ~BlobClassCache();
+
+  // Empties the cache and makes it hold at most max_entries entries.
+  // A size of 0 disables the cache.
+  void Resize(int max_entries);
+  // Deletes all the entries, keeping the size and the counts.
+  void Clear();
+
+  int max_entries() const {
+    return max_entries_;
+  }
+  int hits() const {
+    return hits_;
+  }
+  int misses() const {
+    return misses_;
+  }
+
+  // If the choices for blob at the given generation are in the cache, adds
+  // a copy of them to choices and returns true, else returns false.
+  bool Lookup(TBLOB* blob, inT64 generation, BLOB_CHOICE_LIST* choices);
+  // Stores a copy of the choices for blob at the given generation,
+  // replacing the least recently used entry if the cache is full.
+  void Store(TBLOB* blob, inT64 generation, BLOB_CHOICE_LIST* choices);
+
+ private:
+  struct Entry {
+    uinT32 hash;
+    inT64 generation;
+    GenericVector<inT32> outlines;
+    BLOB_CHOICE_LIST* choices;
+    // Next entry of the same hash bucket, or -1.
+    int next_in_bucket;
+    // Neighbours in the list of the used entries, most recent first, or -1.
+    int newer;
+    int older;
+  };
+
+  // Fills key_ with the outlines of blob and returns their hash.
+  uinT32 MakeKey(TBLOB* blob, inT64 generation);
+  // Returns the index of the entry of key_ and the given hash and
+  // generation, or -1.
+  int Find(uinT32 hash, inT64 generation) const;
+  // Removes the given entry from its bucket and from the used list.
+  void Unlink(int index);
+  // Makes the given entry the most recently used.
+  void MakeNewest(int index);
+
+  int max_entries_;
+  int num_entries_;
+  Entry* entries_;
+  // Heads of the buckets, indexed by hash & bucket_mask_.
+  int* buckets_;
+  uinT32 bucket_mask_;
+  int newest_;
+  int oldest_;
+  // Key of the last blob given to Lookup or Store.
+  GenericVector<inT32> key_;
+  int hits_;
+  int misses_;
+};
+
+}  // namespace tesseract
+
+#endif  // TESSERACT_CLASSIFY_BLOBCLASSCACHE_H__
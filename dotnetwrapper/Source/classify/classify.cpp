@@ -160,17 +160,13 @@ Classify::Classify()
     EnableLearning(true),
     INT_MEMBER(il1_adaption_test, 0, "Dont adapt to i/I at beginning of word",
                this->params()),
+    INT_MEMBER(classify_cache_size, 0,
+               "Number of blob classifications kept by the adaptive classifier"
+               " for reuse within a page, 0 for none", this->params()),
     BOOL_MEMBER(classify_bln_numeric_mode, 0,
                 "Assume the input is numbers [0-9].", this->params()),
     dict_(&image_) {
-  fontinfo_table_.set_compare_callback(
-      NewPermanentTessCallback(compare_fontinfo));
-  fontinfo_table_.set_clear_callback(
-      NewPermanentTessCallback(delete_callback));
-  fontset_table_.set_compare_callback(
-      NewPermanentTessCallback(compare_font_set));
-  fontset_table_.set_clear_callback(
-      NewPermanentTessCallback(delete_callback_fs));
+  ResetFontTables();
   AdaptedTemplates = NULL;
   PreTrainedTemplates = NULL;
   AllProtosOn = NULL;
@@ -180,6 +176,11 @@ Classify::Classify()
   AllConfigsOff = NULL;
   TempProtoMask = NULL;
   NormProtos = NULL;
+  shared_templates_ = false;
+  own_adapted_templates_ = NULL;
+  own_enable_learning_ = true;
+  templates_store_ = NULL;
+  store_version_ = NULL;
 
   AdaptiveMatcherCalls = 0;
   BaselineClassifierCalls = 0;
@@ -198,6 +199,33 @@ Classify::Classify()
   learn_debug_win_ = NULL;
   learn_fragmented_word_debug_win_ = NULL;
   learn_fragments_debug_win_ = NULL;
+  class_pruner_data_ = NULL;
+  blob_class_generation_ = 0;
+}
+
+// Empties the font tables and makes them own their elements again.
+void Classify::ResetFontTables() {
+  fontinfo_table_.clear();
+  fontinfo_table_.set_compare_callback(
+      NewPermanentTessCallback(compare_fontinfo));
+  fontinfo_table_.set_clear_callback(
+      NewPermanentTessCallback(delete_callback));
+  fontset_table_.clear();
+  fontset_table_.set_compare_callback(
+      NewPermanentTessCallback(compare_font_set));
+  fontset_table_.set_clear_callback(
+      NewPermanentTessCallback(delete_callback_fs));
+}
+
+// Replaces the font tables with shallow copies of the tables of master.
+// The copies do not own the font names, spacing info or font set configs.
+void Classify::ShareFontTables(const Classify& master) {
+  fontinfo_table_.share(master.fontinfo_table_);
+  fontinfo_table_.set_compare_callback(
+      NewPermanentTessCallback(compare_fontinfo));
+  fontset_table_.share(master.fontset_table_);
+  fontset_table_.set_compare_callback(
+      NewPermanentTessCallback(compare_font_set));
 }
 
 Classify::~Classify() {
@@ -205,6 +233,7 @@ Classify::~Classify() {
   delete learn_debug_win_;
   delete learn_fragmented_word_debug_win_;
   delete learn_fragments_debug_win_;
+  delete class_pruner_data_;
 }
 
 }  // namespace tesseract
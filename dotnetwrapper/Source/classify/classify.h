@@ -20,6 +20,8 @@
 #define TESSERACT_CLASSIFY_CLASSIFY_H__
 
 #include "adaptive.h"
+#include "adaptstore.h"
+#include "blobclasscache.h"
 #include "ccstruct.h"
 #include "classify.h"
 #include "dict.h"
@@ -78,6 +80,23 @@ class Classify : public CCStruct {
   void PrintAdaptedTemplates(FILE *File, ADAPT_TEMPLATES Templates);
   void WriteAdaptedTemplates(FILE *File, ADAPT_TEMPLATES Templates);
   ADAPT_TEMPLATES ReadAdaptedTemplates(FILE *File);
+  // Writes the adapted templates to File as a versioned binary snapshot
+  // that ReadAdaptedSnapshot can read into any instance of the same
+  // language to warm-start it. Returns false on a write error.
+  bool WriteAdaptedSnapshot(FILE *File);
+  // Replaces the adapted templates with those of a snapshot. Returns false,
+  // keeping the current templates, if the snapshot is bad or is for another
+  // unicharset, or if the templates are borrowed.
+  bool ReadAdaptedSnapshot(FILE *File);
+  // Replaces the adapted templates with a deep copy of those of source,
+  // which must be of the same language, to fork its adaptive state.
+  // Returns false if the templates were not replaced.
+  bool CopyAdaptedTemplatesFrom(const Classify& source);
+  // Frees the adapted templates and takes ownership of Templates instead.
+  void ReplaceAdaptedTemplates(ADAPT_TEMPLATES Templates);
+  // Sets the baseline cutoffs of the classes of the adapted templates, as
+  // InitAdaptedClass does for the classes it makes.
+  void SetAdaptedClassCutoffs();
   /* normmatch.cpp ************************************************************/
   FLOAT32 ComputeNormMatch(CLASS_ID ClassId, FEATURE Feature, BOOL8 DebugMatch);
   void FreeNormProtos();
@@ -110,6 +129,23 @@ class Classify : public CCStruct {
                    float threshold, CharSegmentationType segmentation,
                    const char* correct_text, WERD_RES *word);
   void InitAdaptiveClassifier(bool load_pre_trained_templates);
+  // Initializes the adaptive classifier like InitAdaptiveClassifier, but
+  // borrows the pre-trained templates, cutoffs, normprotos and font tables
+  // of master instead of reading them. The borrowed data is never modified
+  // or freed by this Classify, so master must outlive it.
+  void InitSharedAdaptiveClassifier(const Classify& master);
+  // Makes this Classify match against the adapted templates of master, with
+  // learning disabled, until it is called again with NULL to get its own
+  // templates back. Used to run words in parallel helper instances with the
+  // exact adaptive state of master, which must not adapt meanwhile.
+  void BorrowAdaptedTemplates(const Classify* master);
+  // Makes this Classify match against the newest adapted templates published
+  // in store by another thread, with learning disabled, until it is called
+  // again with NULL to get its own templates back. The templates are only
+  // changed to a newer version by RefreshAdaptedTemplates, which must be
+  // called between words, so that the classify hot path takes no lock.
+  void ReadAdaptedTemplatesFrom(AdaptedTemplatesStore* store);
+  void RefreshAdaptedTemplates();
   void InitAdaptedClass(TBLOB *Blob,
                         CLASS_ID ClassId,
                         int FontinfoId,
@@ -186,10 +222,20 @@ class Classify : public CCStruct {
   int CharNormClassifier(TBLOB *Blob,
                          INT_TEMPLATES Templates,
                          ADAPT_RESULTS *Results);
+  void CharNormMatch(TBLOB *Blob,
+                     INT_TEMPLATES Templates,
+                     int NumFeatures,
+                     INT_FEATURE_ARRAY IntFeatures,
+                     CLASS_NORMALIZATION_ARRAY CharNormArray,
+                     ADAPT_RESULTS *Results);
   UNICHAR_ID *GetAmbiguities(TBLOB *Blob,
                              CLASS_ID CorrectClass);
   void DoAdaptiveMatch(TBLOB *Blob,
                        ADAPT_RESULTS *Results);
+  void FinishAdaptiveMatch(ADAPT_RESULTS *Results);
+  void ConvertAdaptiveResults(TBLOB *Blob,
+                              ADAPT_RESULTS *Results,
+                              BLOB_CHOICE_LIST *Choices);
   void AdaptToChar(TBLOB *Blob,
                    CLASS_ID ClassId,
                    int FontinfoId,
@@ -205,8 +251,24 @@ class Classify : public CCStruct {
   void AdaptiveClassifier(TBLOB *Blob,
                           BLOB_CHOICE_LIST *Choices,
                           CLASS_PRUNER_RESULTS cp_results);
+  // Classifies each of the num_blobs blobs and puts the choices for
+  // blobs[b] in choices[b], as AdaptiveClassifier would, but with the setup
+  // and the scratch space of the classifier shared by all the blobs. When
+  // only the char norm classifier is used, the features of all the blobs
+  // are extracted first, then the blobs are pruned and matched in turn.
+  // If denorms is not NULL, blobs[b] is classified with denorms[b], else
+  // all are classified with the current denorm, which is kept either way.
+  void AdaptiveClassifierBatch(int num_blobs, TBLOB** blobs,
+                               const DENORM* const* denorms,
+                               BLOB_CHOICE_LIST** choices);
   void ClassifyAsNoise(ADAPT_RESULTS *Results);
   void ResetAdaptiveClassifier();
+  // Makes the blob classifications cached so far unusable. Must be called
+  // whenever something that the classification of a blob depends on
+  // changes, other than the blob itself.
+  void InvalidateBlobClassCache() {
+    ++blob_class_generation_;
+  }
 
   int GetBaselineFeatures(TBLOB *Blob,
                           INT_TEMPLATES Templates,
@@ -363,18 +425,41 @@ class Classify : public CCStruct {
   /* font detection ***********************************************************/
   UnicityTable<FontInfo> fontinfo_table_;
   UnicityTable<FontSet> fontset_table_;
+  // True if PreTrainedTemplates, NormProtos and the font tables are
+  // borrowed from another Classify by InitSharedAdaptiveClassifier.
+  bool shared_templates_;
+  // Own adapted templates and learning flag of this Classify while those of
+  // another one are borrowed by BorrowAdaptedTemplates.
+  ADAPT_TEMPLATES own_adapted_templates_;
+  bool own_enable_learning_;
+  // Store and version of the adapted templates used while reading them
+  // from another thread with ReadAdaptedTemplatesFrom.
+  AdaptedTemplatesStore* templates_store_;
+  AdaptedTemplatesStore::Version* store_version_;
 
   INT_VAR_H(il1_adaption_test, 0, "Dont adapt to i/I at beginning of word");
+  INT_VAR_H(classify_cache_size, 0,
+            "Number of blob classifications kept by the adaptive classifier"
+            " for reuse within a page, 0 for none");
   BOOL_VAR_H(classify_bln_numeric_mode, 0,
              "Assume the input is numbers [0-9].");
  protected:
   IntegerMatcher im_;
+  // Scratch space of ClassPruner, made on the first call.
+  ClassPrunerData* class_pruner_data_;
+  // Choices of AdaptiveClassifier for the recently classified blobs, and
+  // the state of the classifier they were made in.
+  BlobClassCache blob_class_cache_;
+  inT64 blob_class_generation_;
   FEATURE_DEFS_STRUCT feature_defs_;
   // Must be set for the classifier to operate. Ususally set in
   // Tesseract::recog_word_recursive, being the main word-level entry point.
   DENORM denorm_;
 
  private:
+  // Font table ownership, see InitSharedAdaptiveClassifier.
+  void ResetFontTables();
+  void ShareFontTables(const Classify& master);
 
   Dict dict_;
 
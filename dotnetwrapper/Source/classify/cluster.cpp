@@ -18,6 +18,7 @@
 #include "oldheap.h"
 #include "const.h"
 #include "cluster.h"
+#include "ccutil.h"
 #include "emalloc.h"
 #include "helpers.h"
 #include "tprintf.h"
@@ -233,6 +234,10 @@ static const uinT16 kBucketsTable[LOOKUPTABLESIZE] = {
   MINBUCKETS, 16, 20, 24, 27, 30, 35, MAXBUCKETS
 };  // number of buckets
 
+// guards the chi-squared values cached by ComputeChiSquared, which are
+// shared by the clusterers of all threads
+static tesseract::CCUtilMutex ChiWithMutex;
+
 /*-------------------------------------------------------------------------
           Private Function Prototypes
 --------------------------------------------------------------------------*/
@@ -1906,6 +1911,7 @@ ComputeChiSquared (uinT16 DegreesOfFreedom, FLOAT64 Alpha)
 
   CHISTRUCT *OldChiSquared;
   CHISTRUCT SearchKey;
+  FLOAT64 ChiSquared;
 
   // limit the minimum alpha that can be used - if alpha is too small
   //      it may not be possible to compute chi-squared.
@@ -1917,6 +1923,7 @@ ComputeChiSquared (uinT16 DegreesOfFreedom, FLOAT64 Alpha)
      for the specified number of degrees of freedom.  Search the list for
      the desired chi-squared. */
   SearchKey.Alpha = Alpha;
+  ChiWithMutex.Lock();
   OldChiSquared = (CHISTRUCT *) first_node (search (ChiWith[DegreesOfFreedom],
     &SearchKey, AlphaMatch));
 
@@ -1931,8 +1938,10 @@ ComputeChiSquared (uinT16 DegreesOfFreedom, FLOAT64 Alpha)
   else {
     // further optimization might move OldChiSquared to front of list
   }
+  ChiSquared = OldChiSquared->ChiSquared;
+  ChiWithMutex.Unlock();
 
-  return (OldChiSquared->ChiSquared);
+  return (ChiSquared);
 
 }                                // ComputeChiSquared
 
@@ -2602,8 +2611,9 @@ CLUSTER * Cluster, FLOAT32 MaxIllegal)
  */
 #define ILLEGAL_CHAR    2
 {
-  static BOOL8 *CharFlags = NULL;
-  static inT32 NumFlags = 0;
+  BOOL8 *CharFlags;
+  inT32 NumFlags;
+  BOOL8 Multiple = FALSE;
   int i;
   LIST SearchState;
   SAMPLE *Sample;
@@ -2616,13 +2626,10 @@ CLUSTER * Cluster, FLOAT32 MaxIllegal)
   NumCharInCluster = Cluster->SampleCount;
   NumIllegalInCluster = 0;
 
-  if (Clusterer->NumChar > NumFlags) {
-    if (CharFlags != NULL)
-      memfree(CharFlags);
-    NumFlags = Clusterer->NumChar;
-    CharFlags = (BOOL8 *) Emalloc (NumFlags * sizeof (BOOL8));
-  }
-
+  // the flags are not kept from one call to the next, so that clusterers
+  // can be used on several threads at once
+  NumFlags = Clusterer->NumChar;
+  CharFlags = (BOOL8 *) Emalloc (MAX (NumFlags, 1) * sizeof (BOOL8));
   for (i = 0; i < NumFlags; i++)
     CharFlags[i] = FALSE;
 
@@ -2640,11 +2647,15 @@ CLUSTER * Cluster, FLOAT32 MaxIllegal)
       }
       NumCharInCluster--;
       PercentIllegal = (FLOAT32) NumIllegalInCluster / NumCharInCluster;
-      if (PercentIllegal > MaxIllegal)
-        return (TRUE);
+      if (PercentIllegal > MaxIllegal) {
+        Multiple = TRUE;
+        break;
+      }
     }
   }
-  return (FALSE);
+  destroy(SearchState);
+  memfree(CharFlags);
+  return (Multiple);
 
 }                                // MultipleCharSamples
 
@@ -97,15 +97,42 @@ void InitIntegerFX() {
 //   We align the grapheme's centroid at the origin and scale it asymmetrically
 //   in x and y so that the result is vaguely square.
 //
-int ExtractIntFeat(TBLOB *Blob,
-                   const DENORM& denorm,
-                   INT_FEATURE_ARRAY BLFeat,
-                   INT_FEATURE_ARRAY CNFeat,
-                   INT_FX_RESULT Results,
-                   inT32 *FeatureOutlineArray) {
-
-  TESSLINE *OutLine;
-  EDGEPT *Loop, *LoopStart, *Segment;
+// The outlines are first copied to flat arrays of points, each outline
+// closed by a copy of its first point, which the three passes below walk
+// instead of the lists of EDGEPTs: the centroid pass, the baseline pass,
+// which reuses the segments, lengths and counts of the centroid pass as the
+// baseline features are the same segments shifted by Xmean, and the char
+// norm pass, whose scaled coordinates are computed for all the points in a
+// single loop that the compiler can vectorize.
+//
+// Flags of the points.
+const int kFXHiddenEdge = 1;     // The edge from the point is hidden.
+const int kFXOutlineStart = 2;   // The point starts an outline.
+// Number of arrays of points used by ExtractIntFeatFromPoints.
+const int kFXNumArrays = 10;
+// Largest number of points that ExtractIntFeat keeps on the stack.
+const int kFXMaxStackPoints = 512;
+
+// Does the work of ExtractIntFeat on the num_points points of the outlines
+// of a blob, given in the first 3 of the kFXNumArrays arrays of buffer:
+// x, y and flags. The other arrays are scratch space.
+static int ExtractIntFeatFromPoints(int num_points, inT32 *buffer,
+                                    INT_FEATURE_ARRAY BLFeat,
+                                    INT_FEATURE_ARRAY CNFeat,
+                                    INT_FX_RESULT Results,
+                                    inT32 *FeatureOutlineArray) {
+  const inT32 *Xs = buffer;
+  const inT32 *Ys = Xs + num_points;
+  const inT32 *Flags = Ys + num_points;
+  // The segments that make features, in outline order.
+  inT32 *SegX = buffer + 3 * num_points;
+  inT32 *SegY = SegX + num_points;
+  inT32 *SegDX = SegY + num_points;
+  inT32 *SegDY = SegDX + num_points;
+  inT32 *SegN = SegDY + num_points;
+  // The char norm coordinates of the points.
+  inT32 *CNXs = SegN + num_points;
+  inT32 *CNYs = CNXs + num_points;
   inT16 LastX, LastY, Xmean, Ymean;
   inT32 NormX, NormY, DeltaX, DeltaY;
   inT32 Xsum, Ysum;
@@ -122,59 +149,50 @@ int ExtractIntFeat(TBLOB *Blob,
                                  /* sxxxxxxxxxxxxxxxxxxxxxxx.xxxxxxxx */
   register inT32 pfX, pfY, dX, dY;
   uinT16 Length;
-  register int i;
-
-  Results->Length = 0;
-  Results->Xmean = 0;
-  Results->Ymean = 0;
-  Results->Rx = 0;
-  Results->Ry = 0;
-  Results->NumBL = 0;
-  Results->NumCN = 0;
+  int NumSegments;
+  register int i, p;
 
   // Calculate the centroid (Xmean, Ymean) for the blob.
   //   We use centroid (instead of center of bounding box or center of smallest
   //   enclosing circle) so the algorithm will not be too greatly influenced by
   //   small amounts of information at the edge of a character's bounding box.
-  NumBLFeatures = 0;
-  NumCNFeatures = 0;
-  OutLine = Blob->outlines;
   Xsum = 0;
   Ysum = 0;
   LengthSum = 0;
-  while (OutLine != NULL) {
-    LoopStart = OutLine->loop;
-    Loop = LoopStart;
-    LastX = Loop->pos.x;
-    LastY = Loop->pos.y;
-    /* Check for bad loops */
-    if ((Loop == NULL) || (Loop->next == NULL) || (Loop->next == LoopStart))
-      return FALSE;
-    do {
-      Segment = Loop;
-      Loop = Loop->next;
-      NormX = Loop->pos.x;
-      NormY = Loop->pos.y;
-
-      n = 1;
-      if (!Segment->IsHidden()) {
-        DeltaX = NormX - LastX;
-        DeltaY = NormY - LastY;
-        Length = MySqrt(DeltaX, DeltaY);
-        n = ((Length << 2) + Length + 32) >> 6;
-        if (n != 0) {
-          Xsum += ((LastX << 1) + DeltaX) * (int) Length;
-          Ysum += ((LastY << 1) + DeltaY) * (int) Length;
-          LengthSum += Length;
-        }
-      }
-      if (n != 0) {              /* Throw away a point that is too close */
-        LastX = NormX;
-        LastY = NormY;
+  NumSegments = 0;
+  LastX = 0;
+  LastY = 0;
+  for (p = 0; p < num_points; p++) {
+    if (Flags[p] & kFXOutlineStart) {
+      LastX = Xs[p];
+      LastY = Ys[p];
+      continue;
+    }
+    NormX = Xs[p];
+    NormY = Ys[p];
+
+    n = 1;
+    if (!(Flags[p - 1] & kFXHiddenEdge)) {
+      DeltaX = NormX - LastX;
+      DeltaY = NormY - LastY;
+      Length = MySqrt(DeltaX, DeltaY);
+      n = ((Length << 2) + Length + 32) >> 6;
+      if (n != 0) {
+        Xsum += ((LastX << 1) + DeltaX) * (int) Length;
+        Ysum += ((LastY << 1) + DeltaY) * (int) Length;
+        LengthSum += Length;
+        SegX[NumSegments] = LastX;
+        SegY[NumSegments] = LastY;
+        SegDX[NumSegments] = DeltaX;
+        SegDY[NumSegments] = DeltaY;
+        SegN[NumSegments] = n;
+        NumSegments++;
       }
     }
-    while (Loop != LoopStart);
-    OutLine = OutLine->next;
+    if (n != 0) {              /* Throw away a point that is too close */
+      LastX = NormX;
+      LastY = NormY;
+    }
   }
   if (LengthSum == 0)
     return FALSE;
@@ -199,67 +217,35 @@ int ExtractIntFeat(TBLOB *Blob,
   Ix = 0;
   Iy = 0;
   NumBLFeatures = 0;
-  OutLine = Blob->outlines;
-  while (OutLine != NULL) {
-    LoopStart = OutLine->loop;
-    Loop = LoopStart;
-    LastX = Loop->pos.x - Xmean;
-    LastY = Loop->pos.y;
-    /* Check for bad loops */
-    if ((Loop == NULL) || (Loop->next == NULL) || (Loop->next == LoopStart))
-      return FALSE;
-    do {
-      Segment = Loop;
-      Loop = Loop->next;
-      NormX = Loop->pos.x - Xmean;
-      NormY = Loop->pos.y;
-
-      n = 1;
-      if (!Segment->IsHidden()) {
-        DeltaX = NormX - LastX;
-        DeltaY = NormY - LastY;
-        Length = MySqrt(DeltaX, DeltaY);
-        n = ((Length << 2) + Length + 32) >> 6;
-        if (n != 0) {
-          Theta = BinaryAnglePlusPi(DeltaY, DeltaX);
-          dX = (DeltaX << 8) / n;
-          dY = (DeltaY << 8) / n;
-          pfX = (LastX << 8) + (dX >> 1);
-          pfY = (LastY << 8) + (dY >> 1);
-          Ix += ((pfY >> 8) - Ymean) * ((pfY >> 8) - Ymean);
-          // TODO(eger): Hmmm... Xmean is not necessarily 0.
-          //   Figure out if we should center against Xmean for these
-          //   features, and if so fix Iy & SaveFeature().
-          Iy += (pfX >> 8) * (pfX >> 8);
-          if (SaveFeature(BLFeat,
-                          NumBLFeatures,
-                          (inT16) (pfX >> 8),
-                          (inT16) ((pfY >> 8) - 128),
-                          Theta) == FALSE)
-            return FALSE;
-          NumBLFeatures++;
-          for (i = 1; i < n; i++) {
-            pfX += dX;
-            pfY += dY;
-            Ix += ((pfY >> 8) - Ymean) * ((pfY >> 8) - Ymean);
-            Iy += (pfX >> 8) * (pfX >> 8);
-            if (SaveFeature(BLFeat,
-                            NumBLFeatures,
-                            (inT16) (pfX >> 8),
-                            (inT16) ((pfY >> 8) - 128),
-                            Theta) == FALSE)
-              return FALSE;
-            NumBLFeatures++;
-          }
-        }
-      }
-      if (n != 0) {              /* Throw away a point that is too close */
-        LastX = NormX;
-        LastY = NormY;
+  for (int s = 0; s < NumSegments; s++) {
+    LastX = SegX[s] - Xmean;
+    LastY = SegY[s];
+    DeltaX = SegDX[s];
+    DeltaY = SegDY[s];
+    n = SegN[s];
+    Theta = BinaryAnglePlusPi(DeltaY, DeltaX);
+    dX = (DeltaX << 8) / n;
+    dY = (DeltaY << 8) / n;
+    pfX = (LastX << 8) + (dX >> 1);
+    pfY = (LastY << 8) + (dY >> 1);
+    for (i = 0; i < n; i++) {
+      if (i > 0) {
+        pfX += dX;
+        pfY += dY;
       }
+      Ix += ((pfY >> 8) - Ymean) * ((pfY >> 8) - Ymean);
+      // TODO(eger): Hmmm... Xmean is not necessarily 0.
+      //   Figure out if we should center against Xmean for these
+      //   features, and if so fix Iy & SaveFeature().
+      Iy += (pfX >> 8) * (pfX >> 8);
+      if (SaveFeature(BLFeat,
+                      NumBLFeatures,
+                      (inT16) (pfX >> 8),
+                      (inT16) ((pfY >> 8) - 128),
+                      Theta) == FALSE)
+        return FALSE;
+      NumBLFeatures++;
     }
-    while (Loop != LoopStart);
-    OutLine = OutLine->next;
   }
   if (Ix == 0)
     Ix = 1;
@@ -294,41 +280,44 @@ int ExtractIntFeat(TBLOB *Blob,
   //   is the centroid, not the center of the bounding box.  Instead, we can
   //   only bound the result to [-204 ... 204] x [-204 ... 204]
   //
+  int ShiftX = (inT8) RyExp;
+  int ShiftY = (inT8) RxExp;
+  for (p = 0; p < num_points; p++) {
+    CNXs[p] = ((Xs[p] - Xmean) * RyInv) >> ShiftX;
+    CNYs[p] = ((Ys[p] - Ymean) * RxInv) >> ShiftY;
+  }
   NumCNFeatures = 0;
-  OutLine = Blob->outlines;
   int OutLineIndex = -1;
-  while (OutLine != NULL) {
-    LoopStart = OutLine->loop;
-    Loop = LoopStart;
-    LastX = (Loop->pos.x - Xmean) * RyInv;
-    LastY = (Loop->pos.y - Ymean) * RxInv;
-    LastX >>= (inT8) RyExp;
-    LastY >>= (inT8) RxExp;
-    OutLineIndex++;
-
-    /* Check for bad loops */
-    if ((Loop == NULL) || (Loop->next == NULL) || (Loop->next == LoopStart))
-      return FALSE;
-    do {
-      Segment = Loop;
-      Loop = Loop->next;
-      NormX = (Loop->pos.x - Xmean) * RyInv;
-      NormY = (Loop->pos.y - Ymean) * RxInv;
-      NormX >>= (inT8) RyExp;
-      NormY >>= (inT8) RxExp;
-
-      n = 1;
-      if (!Segment->IsHidden()) {
-        DeltaX = NormX - LastX;
-        DeltaY = NormY - LastY;
-        Length = MySqrt(DeltaX, DeltaY);
-        n = ((Length << 2) + Length + 32) >> 6;
-        if (n != 0) {
-          Theta = BinaryAnglePlusPi(DeltaY, DeltaX);
-          dX = (DeltaX << 8) / n;
-          dY = (DeltaY << 8) / n;
-          pfX = (LastX << 8) + (dX >> 1);
-          pfY = (LastY << 8) + (dY >> 1);
+  for (p = 0; p < num_points; p++) {
+    if (Flags[p] & kFXOutlineStart) {
+      // The start of an outline is scaled in 16 bits.
+      LastX = (Xs[p] - Xmean) * RyInv;
+      LastY = (Ys[p] - Ymean) * RxInv;
+      LastX >>= ShiftX;
+      LastY >>= ShiftY;
+      OutLineIndex++;
+      continue;
+    }
+    NormX = CNXs[p];
+    NormY = CNYs[p];
+
+    n = 1;
+    if (!(Flags[p - 1] & kFXHiddenEdge)) {
+      DeltaX = NormX - LastX;
+      DeltaY = NormY - LastY;
+      Length = MySqrt(DeltaX, DeltaY);
+      n = ((Length << 2) + Length + 32) >> 6;
+      if (n != 0) {
+        Theta = BinaryAnglePlusPi(DeltaY, DeltaX);
+        dX = (DeltaX << 8) / n;
+        dY = (DeltaY << 8) / n;
+        pfX = (LastX << 8) + (dX >> 1);
+        pfY = (LastY << 8) + (dY >> 1);
+        for (i = 0; i < n; i++) {
+          if (i > 0) {
+            pfX += dX;
+            pfY += dY;
+          }
           if (SaveFeature(CNFeat,
                           NumCNFeatures,
                           (inT16) (pfX >> 8),
@@ -339,35 +328,83 @@ int ExtractIntFeat(TBLOB *Blob,
             FeatureOutlineArray[NumCNFeatures] = OutLineIndex;
           }
           NumCNFeatures++;
-          for (i = 1; i < n; i++) {
-            pfX += dX;
-            pfY += dY;
-            if (SaveFeature(CNFeat,
-                            NumCNFeatures,
-                            (inT16) (pfX >> 8),
-                            (inT16) (pfY >> 8),
-                            Theta) == FALSE)
-              return FALSE;
-            if (FeatureOutlineArray) {
-              FeatureOutlineArray[NumCNFeatures] = OutLineIndex;
-            }
-            NumCNFeatures++;
-          }
         }
       }
-      if (n != 0) {              /* Throw away a point that is too close */
-        LastX = NormX;
-        LastY = NormY;
-      }
     }
-    while (Loop != LoopStart);
-    OutLine = OutLine->next;
+    if (n != 0) {              /* Throw away a point that is too close */
+      LastX = NormX;
+      LastY = NormY;
+    }
   }
 
   Results->NumCN = NumCNFeatures;
   return TRUE;
 }
 
+int ExtractIntFeat(TBLOB *Blob,
+                   const DENORM& denorm,
+                   INT_FEATURE_ARRAY BLFeat,
+                   INT_FEATURE_ARRAY CNFeat,
+                   INT_FX_RESULT Results,
+                   inT32 *FeatureOutlineArray) {
+  TESSLINE *OutLine;
+  EDGEPT *Loop, *LoopStart;
+
+  Results->Length = 0;
+  Results->Xmean = 0;
+  Results->Ymean = 0;
+  Results->Rx = 0;
+  Results->Ry = 0;
+  Results->NumBL = 0;
+  Results->NumCN = 0;
+
+  int num_points = 0;
+  for (OutLine = Blob->outlines; OutLine != NULL; OutLine = OutLine->next) {
+    LoopStart = OutLine->loop;
+    /* Check for bad loops */
+    if ((LoopStart == NULL) || (LoopStart->next == NULL) ||
+        (LoopStart->next == LoopStart))
+      return FALSE;
+    Loop = LoopStart;
+    do {
+      num_points++;
+      Loop = Loop->next;
+    } while (Loop != LoopStart);
+    num_points++;  // The closing copy of the first point.
+  }
+
+  inT32 stack_buffer[kFXNumArrays * kFXMaxStackPoints];
+  inT32 *buffer = num_points <= kFXMaxStackPoints
+                ? stack_buffer : new inT32[kFXNumArrays * num_points];
+  inT32 *Xs = buffer;
+  inT32 *Ys = Xs + num_points;
+  inT32 *Flags = Ys + num_points;
+  int p = 0;
+  for (OutLine = Blob->outlines; OutLine != NULL; OutLine = OutLine->next) {
+    int start = p;
+    LoopStart = OutLine->loop;
+    Loop = LoopStart;
+    do {
+      Xs[p] = Loop->pos.x;
+      Ys[p] = Loop->pos.y;
+      Flags[p] = Loop->IsHidden() ? kFXHiddenEdge : 0;
+      p++;
+      Loop = Loop->next;
+    } while (Loop != LoopStart);
+    Flags[start] |= kFXOutlineStart;
+    Xs[p] = Xs[start];
+    Ys[p] = Ys[start];
+    Flags[p] = 0;
+    p++;
+  }
+
+  int result = ExtractIntFeatFromPoints(num_points, buffer, BLFeat, CNFeat,
+                                        Results, FeatureOutlineArray);
+  if (buffer != stack_buffer)
+    delete [] buffer;
+  return result;
+}
+
 
 /*--------------------------------------------------------------------------*/
 // Return the "binary angle" [0..255]
@@ -449,9 +486,6 @@ int SaveFeature(INT_FEATURE_ARRAY FeatureArray,
 // Return floor(sqrt(min(emm, x)^2 + min(emm, y)^2))
 //    where emm = EvidenceMultMask.
 uinT16 MySqrt(inT32 X, inT32 Y) {
-  register uinT16 SqRoot;
-  register uinT32 Square;
-  register uinT16 BitLocation;
   register uinT32 Sum;
   const uinT32 EvidenceMultMask =
     ((1 << IntegerMatcher::kIntEvidenceTruncBits) - 1);
@@ -468,17 +502,10 @@ uinT16 MySqrt(inT32 X, inT32 Y) {
 
   Sum = X * X + Y * Y;
 
-  BitLocation = (EvidenceMultMask + 1) << 1;
-  SqRoot = 0;
-  do {
-    Square = (SqRoot | BitLocation) * (SqRoot | BitLocation);
-    if (Square <= Sum)
-      SqRoot |= BitLocation;
-    BitLocation >>= 1;
-  }
-  while (BitLocation);
-
-  return SqRoot;
+  // The square root of a double is correctly rounded, so truncating it gives
+  // the integer square root exactly for any Sum below 2^52, in one
+  // instruction instead of a loop over the 16 bits of the result.
+  return (uinT16) sqrt((double) Sum);
 }
 
 
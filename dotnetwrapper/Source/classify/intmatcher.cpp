@@ -25,6 +25,7 @@
 #include "scrollview.h"
 #include "globals.h"
 #include "classify.h"
+#include "intsimdmatch.h"
 #include <math.h>
 
 // Include automatically generated configuration file if running autoconf.
@@ -89,38 +90,10 @@ static const uinT8 next_table[256] = {
   0xf8, 0xfc, 0xfc, 0xfe
 };
 
-struct ClassPrunerData {
-  int *class_count_;
-  int *norm_count_;
-  int *sort_key_;
-  int *sort_index_;
-  int max_classes_;
-
-  ClassPrunerData(int max_classes) {
-    // class_count_ and friends are referenced by indexing off of data in
-    //   class pruner word sized chunks.  Each pruner word is of sized
-    //   BITS_PER_WERD and each entry is NUM_BITS_PER_CLASS, so there are
-    //   BITS_PER_WERD / NUM_BITS_PER_CLASS entries.
-    //   See Classify::ClassPruner in intmatcher.cpp.
-    max_classes_ = RoundUp(
-        max_classes, WERDS_PER_CP_VECTOR * BITS_PER_WERD / NUM_BITS_PER_CLASS);
-    class_count_ = new int[max_classes_];
-    norm_count_ = new int[max_classes_];
-    sort_key_ = new int[max_classes_ + 1];
-    sort_index_ = new int[max_classes_ + 1];
-    for (int i = 0; i < max_classes_; i++) {
-      class_count_[i] = 0;
-    }
-  }
-
-  ~ClassPrunerData() {
-    delete []class_count_;
-    delete []norm_count_;
-    delete []sort_key_;
-    delete []sort_index_;
-  }
-
-};
+#ifdef HAVE_SSE2_INTRINSICS
+// Whether the SSE2 kernels of intsimdmatch.h can run, checked once.
+static const bool use_sse2 = tesseract::SIMDDetect::IsSSE2Available();
+#endif
 
 const float IntegerMatcher::kSEExponentialMultiplier = 0.0;
 const float IntegerMatcher::kSimilarityCenter = 0.0075;
@@ -160,16 +133,23 @@ int Classify::ClassPruner(INT_TEMPLATES IntTemplates,
   uinT32 PrunerWord;
   inT32 class_index;             //index to class
   int Word;
-  uinT32 *BasePrunerAddress;
+  const uinT32 *BasePrunerAddress;
   uinT32 feature_address;        //current feature index
   INT_FEATURE feature;           //current feature
-  CLASS_PRUNER *ClassPruner;
   int PrunerSet;
   int NumPruners;
   inT32 feature_index;           //current feature
 
   int MaxNumClasses = IntTemplates->NumClasses;
-  ClassPrunerData data(IntTemplates->NumClasses);
+  // The scratch arrays are kept from one call to the next.
+  if (class_pruner_data_ == NULL ||
+      class_pruner_data_->max_classes_ < MaxNumClasses) {
+    delete class_pruner_data_;
+    class_pruner_data_ = new ClassPrunerData(MaxNumClasses);
+  } else {
+    class_pruner_data_->ClearCounts();
+  }
+  ClassPrunerData& data = *class_pruner_data_;
   int *ClassCount = data.class_count_;
   int *NormCount = data.norm_count_;
   int *SortKey = data.sort_key_;
@@ -182,64 +162,16 @@ int Classify::ClassPruner(INT_TEMPLATES IntTemplates,
   CLASS_ID class_id;
 
   /* Update Class Counts */
-  NumPruners = IntTemplates->NumClassPruners;
+  int feature_addresses[MAX_NUM_INT_FEATURES];
   for (feature_index = 0; feature_index < NumFeatures; feature_index++) {
     feature = &Features[feature_index];
-    feature_address = (((feature->X * NUM_CP_BUCKETS >> 8) * NUM_CP_BUCKETS +
-                        (feature->Y * NUM_CP_BUCKETS >> 8)) * NUM_CP_BUCKETS +
-                       (feature->Theta * NUM_CP_BUCKETS >> 8)) << 1;
-    ClassPruner = IntTemplates->ClassPruner;
-    class_index = 0;
-
-    for (PrunerSet = 0; PrunerSet < NumPruners; PrunerSet++, ClassPruner++) {
-      BasePrunerAddress = (uinT32 *) (*ClassPruner) + feature_address;
-
-      for (Word = 0; Word < WERDS_PER_CP_VECTOR; Word++) {
-        PrunerWord = *BasePrunerAddress++;
-        // This inner loop is unrolled to speed up the ClassPruner.
-        // Currently gcc would not unroll it unless it is set to O3
-        // level of optimization or -funroll-loops is specified.
-        /*
-        uinT32 class_mask = (1 << NUM_BITS_PER_CLASS) - 1;
-        for (int bit = 0; bit < BITS_PER_WERD/NUM_BITS_PER_CLASS; bit++) {
-          ClassCount[class_index++] += PrunerWord & class_mask;
-          PrunerWord >>= NUM_BITS_PER_CLASS;
-        }
-        */
-        ClassCount[class_index++] += PrunerWord & CLASS_PRUNER_CLASS_MASK;
-        PrunerWord >>= NUM_BITS_PER_CLASS;
-        ClassCount[class_index++] += PrunerWord & CLASS_PRUNER_CLASS_MASK;
-        PrunerWord >>= NUM_BITS_PER_CLASS;
-        ClassCount[class_index++] += PrunerWord & CLASS_PRUNER_CLASS_MASK;
-        PrunerWord >>= NUM_BITS_PER_CLASS;
-        ClassCount[class_index++] += PrunerWord & CLASS_PRUNER_CLASS_MASK;
-        PrunerWord >>= NUM_BITS_PER_CLASS;
-        ClassCount[class_index++] += PrunerWord & CLASS_PRUNER_CLASS_MASK;
-        PrunerWord >>= NUM_BITS_PER_CLASS;
-        ClassCount[class_index++] += PrunerWord & CLASS_PRUNER_CLASS_MASK;
-        PrunerWord >>= NUM_BITS_PER_CLASS;
-        ClassCount[class_index++] += PrunerWord & CLASS_PRUNER_CLASS_MASK;
-        PrunerWord >>= NUM_BITS_PER_CLASS;
-        ClassCount[class_index++] += PrunerWord & CLASS_PRUNER_CLASS_MASK;
-        PrunerWord >>= NUM_BITS_PER_CLASS;
-        ClassCount[class_index++] += PrunerWord & CLASS_PRUNER_CLASS_MASK;
-        PrunerWord >>= NUM_BITS_PER_CLASS;
-        ClassCount[class_index++] += PrunerWord & CLASS_PRUNER_CLASS_MASK;
-        PrunerWord >>= NUM_BITS_PER_CLASS;
-        ClassCount[class_index++] += PrunerWord & CLASS_PRUNER_CLASS_MASK;
-        PrunerWord >>= NUM_BITS_PER_CLASS;
-        ClassCount[class_index++] += PrunerWord & CLASS_PRUNER_CLASS_MASK;
-        PrunerWord >>= NUM_BITS_PER_CLASS;
-        ClassCount[class_index++] += PrunerWord & CLASS_PRUNER_CLASS_MASK;
-        PrunerWord >>= NUM_BITS_PER_CLASS;
-        ClassCount[class_index++] += PrunerWord & CLASS_PRUNER_CLASS_MASK;
-        PrunerWord >>= NUM_BITS_PER_CLASS;
-        ClassCount[class_index++] += PrunerWord & CLASS_PRUNER_CLASS_MASK;
-        PrunerWord >>= NUM_BITS_PER_CLASS;
-        ClassCount[class_index++] += PrunerWord & CLASS_PRUNER_CLASS_MASK;
-      }
-    }
+    feature_addresses[feature_index] =
+      (((feature->X * NUM_CP_BUCKETS >> 8) * NUM_CP_BUCKETS +
+        (feature->Y * NUM_CP_BUCKETS >> 8)) * NUM_CP_BUCKETS +
+       (feature->Theta * NUM_CP_BUCKETS >> 8)) << 1;
   }
+  AddClassPrunerCounts(IntTemplates, NumFeatures, feature_addresses,
+                       ClassCount);
 
   /* Adjust Class Counts for Number of Expected Features */
   for (class_id = 0; class_id < MaxNumClasses; class_id++) {
@@ -315,12 +247,10 @@ int Classify::ClassPruner(INT_TEMPLATES IntTemplates,
           (((feature->X * NUM_CP_BUCKETS >> 8) * NUM_CP_BUCKETS +
           (feature->Y * NUM_CP_BUCKETS >> 8)) * NUM_CP_BUCKETS +
           (feature->Theta * NUM_CP_BUCKETS >> 8)) << 1;
-        ClassPruner = IntTemplates->ClassPruner;
         class_index = 0;
-        for (PrunerSet = 0; PrunerSet < NumPruners;
-        PrunerSet++, ClassPruner++) {
-          BasePrunerAddress = (uinT32 *) (*ClassPruner)
-            + feature_address;
+        for (PrunerSet = 0; PrunerSet < NumPruners; PrunerSet++) {
+          BasePrunerAddress = ClassPrunerWords(IntTemplates, PrunerSet,
+                                               feature_address);
 
           for (Word = 0; Word < WERDS_PER_CP_VECTOR; Word++) {
             PrunerWord = *BasePrunerAddress++;
@@ -824,6 +754,17 @@ int IntegerMatcher::UpdateTablesForFeature(
 
           ConfigWord &= *ConfigMask;
 
+#ifdef HAVE_SSE2_INTRINSICS
+          if (use_sse2) {
+            tesseract::MaxConfigEvidenceSSE2(tables->feature_evidence_,
+                                             ConfigWord, Evidence);
+            tesseract::InsertProtoEvidenceSSE2(
+                tables->proto_evidence_[ActualProtoNum + proto_offset],
+                ClassTemplate->ProtoLengths[ActualProtoNum + proto_offset],
+                Evidence);
+            continue;
+          }
+#endif
           UINT8Pointer = tables->feature_evidence_ - 8;
           config_byte = 0;
           while (ConfigWord != 0 || config_byte != 0) {
@@ -1111,6 +1052,13 @@ void ScratchEvidence::UpdateSumOfProtoEvidences(
          ((ProtoNum < PROTOS_PER_PROTO_SET) && (ActualProtoNum < NumProtos));
          ProtoNum++, ActualProtoNum++) {
       int temp = 0;
+#ifdef HAVE_SSE2_INTRINSICS
+      if (use_sse2) {
+        temp = tesseract::SumProtoEvidenceSSE2(
+            proto_evidence_[ActualProtoNum],
+            ClassTemplate->ProtoLengths[ActualProtoNum]);
+      } else
+#endif
       for (int i = 0; i < ClassTemplate->ProtoLengths[ActualProtoNum]; i++)
         temp += proto_evidence_[ActualProtoNum] [i];
 
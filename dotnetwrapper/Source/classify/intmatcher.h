@@ -18,6 +18,7 @@
 #ifndef   INTMATCHER_H
 #define   INTMATCHER_H
 
+#include "helpers.h"
 #include "params.h"
 
 // Character fragments could be present in the trained templaes
@@ -88,6 +89,44 @@ struct ScratchEvidence {
     INT_CLASS ClassTemplate, BIT_VECTOR ConfigMask, inT16 NumFeatures);
 };
 
+// Scratch arrays of Classify::ClassPruner, for templates of at most
+// max_classes_ classes.
+struct ClassPrunerData {
+  int *class_count_;
+  int *norm_count_;
+  int *sort_key_;
+  int *sort_index_;
+  int max_classes_;
+
+  ClassPrunerData(int max_classes) {
+    // class_count_ and friends are referenced by indexing off of data in
+    //   class pruner word sized chunks.  Each pruner word is of sized
+    //   BITS_PER_WERD and each entry is NUM_BITS_PER_CLASS, so there are
+    //   BITS_PER_WERD / NUM_BITS_PER_CLASS entries.
+    //   See Classify::ClassPruner in intmatcher.cpp.
+    max_classes_ = RoundUp(
+        max_classes, WERDS_PER_CP_VECTOR * BITS_PER_WERD / NUM_BITS_PER_CLASS);
+    class_count_ = new int[max_classes_];
+    norm_count_ = new int[max_classes_];
+    sort_key_ = new int[max_classes_ + 1];
+    sort_index_ = new int[max_classes_ + 1];
+    ClearCounts();
+  }
+
+  ~ClassPrunerData() {
+    delete []class_count_;
+    delete []norm_count_;
+    delete []sort_key_;
+    delete []sort_index_;
+  }
+
+  void ClearCounts() {
+    for (int i = 0; i < max_classes_; i++) {
+      class_count_[i] = 0;
+    }
+  }
+};
+
 
 class IntegerMatcher {
  public:
@@ -34,6 +34,7 @@
 
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 #ifdef __UNIX__
 #include <unistd.h>
@@ -226,6 +227,7 @@ void AddIntClass(INT_TEMPLATES Templates, CLASS_ID ClassId, INT_CLASS Class) {
     fprintf(stderr, " in increasing order of ClassIds\n");
     exit(1);
   }
+  ASSERT_HOST(Templates->PackedBlock == NULL);
   ClassForClassId (Templates, ClassId) = Class;
   Templates->NumClasses++;
 
@@ -709,6 +711,7 @@ INT_CLASS NewIntClass(int MaxNumProtos, int MaxNumConfigs) {
 
   Class->NumProtos = 0;
   Class->NumConfigs = 0;
+  Class->font_set_id = -1;
 
   for (i = 0; i < Class->NumProtoSets; i++) {
     /* allocate space for a proto set, install in class, and initialize */
@@ -761,6 +764,8 @@ INT_TEMPLATES NewIntTemplates() {
   T = (INT_TEMPLATES) Emalloc (sizeof (INT_TEMPLATES_STRUCT));
   T->NumClasses = 0;
   T->NumClassPruners = 0;
+  T->PackedBlock = NULL;
+  T->PackedClassPruner = NULL;
 
   for (i = 0; i < MAX_NUM_CLASSES; i++)
     ClassForClassId (T, i) = NULL;
@@ -773,6 +778,11 @@ INT_TEMPLATES NewIntTemplates() {
 void free_int_templates(INT_TEMPLATES templates) {
   int i;
 
+  if (templates->PackedBlock != NULL) {
+    Efree(templates->PackedBlock);
+    Efree(templates);
+    return;
+  }
   for (i = 0; i < templates->NumClasses; i++)
     free_int_class(templates->Class[i]);
   for (i = 0; i < templates->NumClassPruners; i++)
@@ -781,6 +791,84 @@ void free_int_templates(INT_TEMPLATES templates) {
 }
 
 
+/*---------------------------------------------------------------------------*/
+// Alignment of the parts of packed templates: a cache line.
+const size_t kPackedAlignment = 64;
+
+// Returns size rounded up to a multiple of kPackedAlignment.
+static size_t PackedSize(size_t size) {
+  return (size + kPackedAlignment - 1) & ~(kPackedAlignment - 1);
+}
+
+// Moves the class pruners and the classes of templates into a single
+// allocation aligned on a cache line, for the class pruner and the matcher
+// to read with fewer cache and TLB misses. The class pruners are
+// interleaved by bucket (see PackedClassPruner), and each class is followed
+// by its proto lengths and proto sets, each part starting on a cache line.
+// The INT_CLASS pointers of templates change. The packed templates may be
+// read, written and freed as usual, but no class or proto may be added to
+// them: this is meant for the pre-trained templates once they are read.
+void PackIntTemplates(INT_TEMPLATES templates) {
+  ASSERT_HOST(templates->PackedBlock == NULL);
+  int num_pruners = templates->NumClassPruners;
+  size_t size = PackedSize(num_pruners * sizeof(CLASS_PRUNER_STRUCT));
+  for (int c = 0; c < templates->NumClasses; ++c) {
+    INT_CLASS Class = templates->Class[c];
+    if (Class == NULL)
+      continue;
+    size += PackedSize(sizeof(INT_CLASS_STRUCT));
+    if (Class->ProtoLengths != NULL)
+      size += PackedSize(MaxNumIntProtosIn(Class) * sizeof(uinT8));
+    size += Class->NumProtoSets * PackedSize(sizeof(PROTO_SET_STRUCT));
+  }
+  char *block = static_cast<char *>(Emalloc(size + kPackedAlignment - 1));
+  char *next = block + (kPackedAlignment - 1 -
+      (reinterpret_cast<size_t>(block) + kPackedAlignment - 1) %
+      kPackedAlignment);
+
+  uinT32 *packed_pruner = reinterpret_cast<uinT32 *>(next);
+  const int kNumVectors = NUM_CP_BUCKETS * NUM_CP_BUCKETS * NUM_CP_BUCKETS;
+  for (int v = 0; v < kNumVectors; ++v) {
+    for (int p = 0; p < num_pruners; ++p) {
+      const uinT32 *words =
+          reinterpret_cast<const uinT32 *>(templates->ClassPruner[p]) +
+          v * WERDS_PER_CP_VECTOR;
+      for (int w = 0; w < static_cast<int>(WERDS_PER_CP_VECTOR); ++w)
+        *packed_pruner++ = words[w];
+    }
+  }
+  for (int p = 0; p < num_pruners; ++p) {
+    Efree(templates->ClassPruner[p]);
+    templates->ClassPruner[p] = NULL;
+  }
+  templates->PackedClassPruner = reinterpret_cast<uinT32 *>(next);
+  next += PackedSize(num_pruners * sizeof(CLASS_PRUNER_STRUCT));
+
+  for (int c = 0; c < templates->NumClasses; ++c) {
+    INT_CLASS Class = templates->Class[c];
+    if (Class == NULL)
+      continue;
+    INT_CLASS packed_class = reinterpret_cast<INT_CLASS>(next);
+    *packed_class = *Class;
+    next += PackedSize(sizeof(INT_CLASS_STRUCT));
+    if (Class->ProtoLengths != NULL) {
+      size_t lengths_size = MaxNumIntProtosIn(Class) * sizeof(uinT8);
+      memcpy(next, Class->ProtoLengths, lengths_size);
+      packed_class->ProtoLengths = reinterpret_cast<uinT8 *>(next);
+      next += PackedSize(lengths_size);
+    }
+    for (int s = 0; s < Class->NumProtoSets; ++s) {
+      memcpy(next, Class->ProtoSets[s], sizeof(PROTO_SET_STRUCT));
+      packed_class->ProtoSets[s] = reinterpret_cast<PROTO_SET>(next);
+      next += PackedSize(sizeof(PROTO_SET_STRUCT));
+    }
+    free_int_class(Class);
+    templates->Class[c] = packed_class;
+  }
+  templates->PackedBlock = block;
+}
+
+
 /*---------------------------------------------------------------------------*/
 // Code to read/write Classify::font*table structures.
 namespace {
@@ -1298,9 +1386,11 @@ void Classify::WriteIntTemplates(FILE *File, INT_TEMPLATES Templates,
   fwrite(&Templates->NumClasses, sizeof(Templates->NumClasses), 1, File);
 
   /* then write out the class pruners */
-  for (i = 0; i < Templates->NumClassPruners; i++)
-    fwrite(Templates->ClassPruner[i],
-           sizeof(CLASS_PRUNER_STRUCT), 1, File);
+  for (i = 0; i < Templates->NumClassPruners; i++) {
+    for (j = 0; j < static_cast<int>(WERDS_PER_CP); j += WERDS_PER_CP_VECTOR)
+      fwrite(ClassPrunerWords(Templates, i, j),
+             sizeof(uinT32), WERDS_PER_CP_VECTOR, File);
+  }
 
   /* then write out each class */
   for (i = 0; i < Templates->NumClasses; i++) {
@@ -204,6 +204,13 @@ typedef struct
   int NumClassPruners;
   INT_CLASS Class[MAX_NUM_CLASSES];
   CLASS_PRUNER ClassPruner[MAX_NUM_CLASS_PRUNERS];
+  // Set by PackIntTemplates, else NULL. PackedBlock is the single allocation
+  // holding the packed class pruners and classes. PackedClassPruner holds
+  // the WERDS_PER_CP_VECTOR words of every class pruner for the first
+  // bucket, then for the second bucket and so on, so that the words read
+  // for a feature are contiguous. The ClassPruner are then NULL.
+  void *PackedBlock;
+  uinT32 *PackedClassPruner;
 }
 
 
@@ -310,6 +317,21 @@ INT_TEMPLATES NewIntTemplates();
 
 void free_int_templates(INT_TEMPLATES templates);
 
+void PackIntTemplates(INT_TEMPLATES templates);
+
+// Returns the WERDS_PER_CP_VECTOR words of the given class pruner for the
+// bucket at the given offset in uinT32 words in a CLASS_PRUNER, whether the
+// templates are packed or not.
+inline const uinT32 *ClassPrunerWords(INT_TEMPLATES templates, int pruner,
+                                      int address) {
+  if (templates->PackedClassPruner != NULL)
+    return templates->PackedClassPruner +
+           (address * templates->NumClassPruners +
+            pruner * WERDS_PER_CP_VECTOR);
+  return reinterpret_cast<const uinT32 *>(templates->ClassPruner[pruner]) +
+         address;
+}
+
 void ShowMatchDisplay();
 
 namespace tesseract {
@@ -0,0 +1,192 @@
+///////////////////////////////////////////////////////////////////////
+// File:        intsimdmatch.cpp
+// Description: Vectorized kernels of the class pruner and integer matcher.
+//
+// (C) Copyright 2011, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include "intsimdmatch.h"
+
+namespace tesseract {
+
+typedef void (*ClassPrunerCountFunc)(INT_TEMPLATES templates,
+                                     int num_features,
+                                     const int* feature_addresses,
+                                     int* class_count);
+
+static void AddClassPrunerCountsScalar(INT_TEMPLATES templates,
+                                       int num_features,
+                                       const int* feature_addresses,
+                                       int* class_count) {
+  int num_pruners = templates->NumClassPruners;
+  for (int f = 0; f < num_features; ++f) {
+    int* count = class_count;
+    for (int p = 0; p < num_pruners; ++p) {
+      const uinT32* pruner_words =
+          ClassPrunerWords(templates, p, feature_addresses[f]);
+      for (int w = 0; w < static_cast<int>(WERDS_PER_CP_VECTOR); ++w) {
+        uinT32 pruner_word = pruner_words[w];
+        // This inner loop is unrolled to speed up the ClassPruner.
+        // Currently gcc would not unroll it unless it is set to O3
+        // level of optimization or -funroll-loops is specified.
+        count[0] += pruner_word & CLASS_PRUNER_CLASS_MASK;
+        pruner_word >>= NUM_BITS_PER_CLASS;
+        count[1] += pruner_word & CLASS_PRUNER_CLASS_MASK;
+        pruner_word >>= NUM_BITS_PER_CLASS;
+        count[2] += pruner_word & CLASS_PRUNER_CLASS_MASK;
+        pruner_word >>= NUM_BITS_PER_CLASS;
+        count[3] += pruner_word & CLASS_PRUNER_CLASS_MASK;
+        pruner_word >>= NUM_BITS_PER_CLASS;
+        count[4] += pruner_word & CLASS_PRUNER_CLASS_MASK;
+        pruner_word >>= NUM_BITS_PER_CLASS;
+        count[5] += pruner_word & CLASS_PRUNER_CLASS_MASK;
+        pruner_word >>= NUM_BITS_PER_CLASS;
+        count[6] += pruner_word & CLASS_PRUNER_CLASS_MASK;
+        pruner_word >>= NUM_BITS_PER_CLASS;
+        count[7] += pruner_word & CLASS_PRUNER_CLASS_MASK;
+        pruner_word >>= NUM_BITS_PER_CLASS;
+        count[8] += pruner_word & CLASS_PRUNER_CLASS_MASK;
+        pruner_word >>= NUM_BITS_PER_CLASS;
+        count[9] += pruner_word & CLASS_PRUNER_CLASS_MASK;
+        pruner_word >>= NUM_BITS_PER_CLASS;
+        count[10] += pruner_word & CLASS_PRUNER_CLASS_MASK;
+        pruner_word >>= NUM_BITS_PER_CLASS;
+        count[11] += pruner_word & CLASS_PRUNER_CLASS_MASK;
+        pruner_word >>= NUM_BITS_PER_CLASS;
+        count[12] += pruner_word & CLASS_PRUNER_CLASS_MASK;
+        pruner_word >>= NUM_BITS_PER_CLASS;
+        count[13] += pruner_word & CLASS_PRUNER_CLASS_MASK;
+        pruner_word >>= NUM_BITS_PER_CLASS;
+        count[14] += pruner_word & CLASS_PRUNER_CLASS_MASK;
+        pruner_word >>= NUM_BITS_PER_CLASS;
+        count[15] += pruner_word & CLASS_PRUNER_CLASS_MASK;
+        count += CLASSES_PER_CP_WERD;
+      }
+    }
+  }
+}
+
+#ifdef HAVE_SSE2_INTRINSICS
+// The pruner words of two class pruners fill a vector of 16 bytes. Each
+// byte holds the 2-bit counts of 4 classes, which are separated into 4
+// vectors of byte counts by shifting and masking, and summed over the
+// features in bytes. A byte can hold the sum of kMaxByteSumFeatures counts
+// of at most CLASS_PRUNER_CLASS_MASK, after which the byte sums are added
+// to class_count and cleared.
+static const int kCountsPerByte = 8 / NUM_BITS_PER_CLASS;
+static const int kMaxByteSumFeatures = 255 / CLASS_PRUNER_CLASS_MASK;
+static const int kMaxPrunerVectors = (MAX_NUM_CLASS_PRUNERS + 1) / 2;
+
+// Adds the byte sums of the pruner vectors of the given number of class
+// pruners to class_count. Byte b of sums[v * kCountsPerByte + k] is the
+// count of class k of byte b % 4 of word b / 4 of the pruner vector v.
+static void FlushByteSums(const __m128i* sums, int num_pruners,
+                          int* class_count) {
+  uinT8 bytes[sizeof(__m128i)];
+  for (int v = 0; 2 * v < num_pruners; ++v) {
+    int* vector_count = class_count + v * 2 * CLASSES_PER_CP;
+    // The second half of the last vector is padding if num_pruners is odd.
+    int num_bytes = 2 * v + 1 < num_pruners ? sizeof(bytes)
+                                            : sizeof(bytes) / 2;
+    for (int k = 0; k < kCountsPerByte; ++k) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes),
+                       sums[v * kCountsPerByte + k]);
+      for (int b = 0; b < num_bytes; ++b) {
+        int word = b / sizeof(uinT32);
+        int byte_in_word = b % sizeof(uinT32);
+        vector_count[word * CLASSES_PER_CP_WERD +
+                     byte_in_word * kCountsPerByte + k] += bytes[b];
+      }
+    }
+  }
+}
+
+static void AddClassPrunerCountsSSE2(INT_TEMPLATES templates,
+                                     int num_features,
+                                     const int* feature_addresses,
+                                     int* class_count) {
+  __m128i sums[kMaxPrunerVectors * kCountsPerByte];
+  int num_pruners = templates->NumClassPruners;
+  int num_vectors = (num_pruners + 1) / 2;
+  // An odd last pruner is paired with a pruner of zeros.
+  int num_pairs = num_pruners / 2;
+  const uinT32* packed = templates->PackedClassPruner;
+  const __m128i mask = _mm_set1_epi8(CLASS_PRUNER_CLASS_MASK);
+  const __m128i zero = _mm_setzero_si128();
+  for (int start = 0; start < num_features; start += kMaxByteSumFeatures) {
+    int end = start + kMaxByteSumFeatures;
+    if (end > num_features)
+      end = num_features;
+    for (int s = 0; s < num_vectors * kCountsPerByte; ++s)
+      sums[s] = zero;
+    for (int f = start; f < end; ++f) {
+      int address = feature_addresses[f];
+      // With packed templates, the words of all the pruners for the
+      // feature are contiguous and a pair is read in a single load.
+      const uinT32* packed_words = packed == NULL ? NULL
+                                 : packed + address * num_pruners;
+      __m128i* sum = sums;
+      for (int v = 0; v < num_vectors; ++v, sum += kCountsPerByte) {
+        __m128i words;
+        if (packed_words != NULL) {
+          const __m128i* pair = reinterpret_cast<const __m128i*>(
+              packed_words + 2 * v * WERDS_PER_CP_VECTOR);
+          words = v < num_pairs ? _mm_loadu_si128(pair)
+                                : _mm_loadl_epi64(pair);
+        } else {
+          __m128i low = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(
+              reinterpret_cast<const uinT32*>(templates->ClassPruner[2 * v]) +
+              address));
+          __m128i high = zero;
+          if (v < num_pairs) {
+            high = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(
+                reinterpret_cast<const uinT32*>(
+                    templates->ClassPruner[2 * v + 1]) + address));
+          }
+          words = _mm_unpacklo_epi64(low, high);
+        }
+        // The shifts are by 16-bit lanes, but the mask keeps only the bits
+        // that come from the same byte.
+        sum[0] = _mm_add_epi8(sum[0], _mm_and_si128(words, mask));
+        sum[1] = _mm_add_epi8(sum[1],
+                              _mm_and_si128(_mm_srli_epi16(words, 2), mask));
+        sum[2] = _mm_add_epi8(sum[2],
+                              _mm_and_si128(_mm_srli_epi16(words, 4), mask));
+        sum[3] = _mm_add_epi8(sum[3],
+                              _mm_and_si128(_mm_srli_epi16(words, 6), mask));
+      }
+    }
+    FlushByteSums(sums, num_pruners, class_count);
+  }
+}
+#endif  // HAVE_SSE2_INTRINSICS
+
+static ClassPrunerCountFunc SelectClassPrunerCounter() {
+#ifdef HAVE_SSE2_INTRINSICS
+  if (SIMDDetect::IsSSE2Available())
+    return AddClassPrunerCountsSSE2;
+#endif
+  return AddClassPrunerCountsScalar;
+}
+
+// Selected once, when the library is loaded.
+static const ClassPrunerCountFunc class_pruner_counter =
+    SelectClassPrunerCounter();
+
+void AddClassPrunerCounts(INT_TEMPLATES templates, int num_features,
+                          const int* feature_addresses, int* class_count) {
+  class_pruner_counter(templates, num_features, feature_addresses,
+                       class_count);
+}
+
+}  // namespace tesseract
@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////
+// File:        intsimdmatch.h
+// Description: Vectorized kernels of the class pruner and integer matcher.
+//
+// (C) Copyright 2011, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#ifndef TESSERACT_CLASSIFY_INTSIMDMATCH_H__
+#define TESSERACT_CLASSIFY_INTSIMDMATCH_H__
+
+#include "intproto.h"
+#include "simddetect.h"
+
+#ifdef HAVE_SSE2_INTRINSICS
+#include <emmintrin.h>
+#endif
+
+namespace tesseract {
+
+// Adds to class_count[c], for each class c of the class pruners of
+// templates, the 2-bit count of c in the pruner words of each of the
+// num_features features. feature_addresses[f] is the offset in uinT32 words
+// of the bucket of feature f in a CLASS_PRUNER. class_count must have room
+// for templates->NumClassPruners * CLASSES_PER_CP counts.
+// The SSE2 version is used when the cpu has it, else the scalar one. Both
+// give the same counts.
+void AddClassPrunerCounts(INT_TEMPLATES templates, int num_features,
+                          const int* feature_addresses, int* class_count);
+
+#ifdef HAVE_SSE2_INTRINSICS
+// The kernels below are the SSE2 versions of the inner loops of
+// IntegerMatcher, which calls them only if SIMDDetect::IsSSE2Available.
+// They give exactly the same tables as the scalar loops.
+
+// Returns a mask of the bytes of index in [start, start + 16) that are
+// less than length.
+inline __m128i ByteMaskBelow(int start, int length) {
+  const __m128i index = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                      8, 9, 10, 11, 12, 13, 14, 15);
+  return _mm_cmplt_epi8(index, _mm_set1_epi8(length - start));
+}
+
+// Inserts evidence in the first length bytes of the proto evidence row,
+// which are sorted in decreasing order, dropping the last one. Byte i
+// becomes max(row[i], min(row[i - 1], evidence)), with row[-1] = 255, which
+// is what the scalar insertion does in up to MAX_PROTO_INDEX steps.
+// The row is read as 16 + 8 bytes so as not to go past MAX_PROTO_INDEX.
+inline void InsertProtoEvidenceSSE2(uinT8* row, int length, uinT8 evidence) {
+  __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row));
+  __m128i high = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + 16));
+  __m128i value = _mm_set1_epi8(evidence);
+  __m128i prev_low = _mm_or_si128(_mm_slli_si128(low, 1),
+                                  _mm_cvtsi32_si128(0xff));
+  __m128i prev_high = _mm_or_si128(_mm_slli_si128(high, 1),
+                                   _mm_srli_si128(low, 15));
+  __m128i new_low = _mm_max_epu8(low, _mm_min_epu8(prev_low, value));
+  __m128i new_high = _mm_max_epu8(high, _mm_min_epu8(prev_high, value));
+  __m128i mask_low = ByteMaskBelow(0, length);
+  __m128i mask_high = ByteMaskBelow(16, length);
+  new_low = _mm_or_si128(_mm_and_si128(mask_low, new_low),
+                         _mm_andnot_si128(mask_low, low));
+  new_high = _mm_or_si128(_mm_and_si128(mask_high, new_high),
+                          _mm_andnot_si128(mask_high, high));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(row), new_low);
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(row + 16), new_high);
+}
+
+// Raises to evidence the first 32 bytes of feature_evidence whose bit is
+// set in config_word.
+inline void MaxConfigEvidenceSSE2(uinT8* feature_evidence, uinT32 config_word,
+                                  uinT8 evidence) {
+  // Spread byte b of config_word over bytes [8b, 8b + 8) and keep in each
+  // byte the bit of its index.
+  __m128i bytes = _mm_cvtsi32_si128(config_word);
+  bytes = _mm_unpacklo_epi8(bytes, bytes);
+  bytes = _mm_unpacklo_epi16(bytes, bytes);
+  const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128,
+                                     1, 2, 4, 8, 16, 32, 64, -128);
+  __m128i value = _mm_set1_epi8(evidence);
+  __m128i low = _mm_and_si128(_mm_unpacklo_epi32(bytes, bytes), bits);
+  __m128i high = _mm_and_si128(_mm_unpackhi_epi32(bytes, bytes), bits);
+  low = _mm_and_si128(_mm_cmpeq_epi8(low, bits), value);
+  high = _mm_and_si128(_mm_cmpeq_epi8(high, bits), value);
+  __m128i* evidence_low = reinterpret_cast<__m128i*>(feature_evidence);
+  __m128i* evidence_high = reinterpret_cast<__m128i*>(feature_evidence + 16);
+  _mm_storeu_si128(evidence_low,
+                   _mm_max_epu8(_mm_loadu_si128(evidence_low), low));
+  _mm_storeu_si128(evidence_high,
+                   _mm_max_epu8(_mm_loadu_si128(evidence_high), high));
+}
+
+// Returns the sum of the first length bytes of the proto evidence row.
+inline int SumProtoEvidenceSSE2(const uinT8* row, int length) {
+  __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row));
+  __m128i high = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + 16));
+  low = _mm_and_si128(low, ByteMaskBelow(0, length));
+  high = _mm_and_si128(high, ByteMaskBelow(16, length));
+  // The sums of absolute differences with 0 are the sums of the bytes of
+  // each half, in the low 16 bits of each 64-bit lane.
+  __m128i sums = _mm_add_epi64(_mm_sad_epu8(low, _mm_setzero_si128()),
+                               _mm_sad_epu8(high, _mm_setzero_si128()));
+  return _mm_cvtsi128_si32(sums) +
+      _mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+}
+#endif  // HAVE_SSE2_INTRINSICS
+
+}  // namespace tesseract
+
+#endif  // TESSERACT_CLASSIFY_INTSIMDMATCH_H__
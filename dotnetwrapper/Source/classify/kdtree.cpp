@@ -5,6 +5,7 @@
  **  History:  3/10/89, DSJ, Created.
  **      5/23/89, DSJ, Added circular feature capability.
  **      7/13/89, DSJ, Made tree nodes invisible to outside.
+ **      Nodes held in one array, bulk built and lazily deleted.
  **
  **  (c) Copyright Hewlett-Packard Company, 1988.
  ** Licensed under the Apache License, Version 2.0 (the "License");
@@ -27,6 +28,7 @@
 #include "freelist.h"
 #include <stdio.h>
 #include <math.h>
+#include <string.h>
 
 #define Magnitude(X)    ((X) < 0 ? -(X) : (X))
 #define NodeFound(N,K,D)  (( (N)->Key == (K) ) && ( (N)->Data == (D) ))
@@ -37,6 +39,11 @@
 #define MINSEARCH -MAX_FLOAT32
 #define MAXSEARCH MAX_FLOAT32
 
+// Initial number of nodes allocated, and of subtrees a search can hold
+// before it grows its stack.
+#define INITIALNODES 64
+#define INITIALSTACK 64
+
 // Helper function to find the next essential dimension in a cycle.
 static int NextLevel(KDTREE *tree, int level) {
   do {
@@ -49,6 +56,8 @@ static int NextLevel(KDTREE *tree, int level) {
 
 //-----------------------------------------------------------------------------
 // Store the k smallest-keyed key-value pairs.
+// The elements are kept in a binary max-heap, so the largest key is always
+// elements_[0] and an insert costs O(log k).
 template<typename Key, typename Value>
 class MinK {
  public:
@@ -71,15 +80,14 @@ class MinK {
 
  private:
   const Key max_key_;  // the maximum possible Key
-  Element* elements_;  // unsorted array of elements
+  Element* elements_;  // max-heap of elements
   int elements_count_;  // the number of results collected so far
   int k_;  // the number of results we want from the search
-  int max_index_;  // the index of the result with the largest key
 };
 
 template<typename Key, typename Value>
 MinK<Key, Value>::MinK(Key max_key, int k) :
-  max_key_(max_key), elements_count_(0), k_(k < 1 ? 1 : k), max_index_(0) {
+  max_key_(max_key), elements_count_(0), k_(k < 1 ? 1 : k) {
   elements_ = new Element[k_];
 }
 
@@ -92,27 +100,39 @@ template<typename Key, typename Value>
 const Key& MinK<Key, Value>::max_insertable_key() {
   if (elements_count_ < k_)
     return max_key_;
-  return elements_[max_index_].key;
+  return elements_[0].key;
 }
 
 template<typename Key, typename Value>
 bool MinK<Key, Value>::insert(Key key, Value value) {
+  int i;
   if (elements_count_ < k_) {
-    elements_[elements_count_++] = Element(key, value);
-    if (key > elements_[max_index_].key)
-      max_index_ = elements_count_ - 1;
-    return true;
-  } else if (key < elements_[max_index_].key) {
-    // evict the largest element.
-    elements_[max_index_] = Element(key, value);
-    // recompute max_index_
-    for (int i = 0; i < elements_count_; i++) {
-      if (elements_[i].key > elements_[max_index_].key)
-        max_index_ = i;
+    // sift the new element up from the end.
+    i = elements_count_++;
+    while (i > 0 && elements_[(i - 1) / 2].key < key) {
+      elements_[i] = elements_[(i - 1) / 2];
+      i = (i - 1) / 2;
+    }
+  } else if (key < elements_[0].key) {
+    // evict the largest element and sift the new one down from the top.
+    i = 0;
+    for (;;) {
+      int child = 2 * i + 1;
+      if (child >= elements_count_)
+        break;
+      if (child + 1 < elements_count_ &&
+          elements_[child + 1].key > elements_[child].key)
+        ++child;
+      if (!(elements_[child].key > key))
+        break;
+      elements_[i] = elements_[child];
+      i = child;
     }
-    return true;
+  } else {
+    return false;
   }
-  return false;
+  elements_[i] = Element(key, value);
+  return true;
 }
 
 
@@ -127,50 +147,130 @@ class KDTreeSearch {
   void Search(int *result_count, FLOAT32 *distances, void **results);
 
  private:
-  void SearchRec(int Level, KDNODE *SubTree);
+  // A subtree still to be searched: its root, the level it branches on and,
+  // in boxes_, the box its keys are known to lie in.
+  struct StackEntry {
+    inT32 node;
+    inT32 level;
+  };
+
+  void Reserve(int size);
+  FLOAT32 *LowerOf(int entry) { return boxes_ + 2 * entry * tree_->KeySize; }
+  FLOAT32 *UpperOf(int entry) { return LowerOf(entry) + tree_->KeySize; }
   bool BoxIntersectsSearch(FLOAT32 *lower, FLOAT32 *upper);
 
   KDTREE *tree_;
   FLOAT32 *query_point_;
   MinK<FLOAT32, void *>* results_;
-  FLOAT32 *sb_min_;  // search box minimum
-  FLOAT32 *sb_max_;  // search box maximum
+  StackEntry *stack_;
+  FLOAT32 *boxes_;  // lower then upper corner of the box of each entry
+  int stack_allocated_;
 };
 
 KDTreeSearch::KDTreeSearch(KDTREE* tree, FLOAT32 *query_point, int k_closest) :
     tree_(tree),
-    query_point_(query_point) {
+    query_point_(query_point),
+    stack_(NULL),
+    boxes_(NULL),
+    stack_allocated_(0) {
   results_ = new MinK<FLOAT32, void *>(MAXSEARCH, k_closest);
-  sb_min_ = new FLOAT32[tree->KeySize];
-  sb_max_ = new FLOAT32[tree->KeySize];
+  Reserve(INITIALSTACK);
 }
 
 KDTreeSearch::~KDTreeSearch() {
   delete results_;
-  delete[] sb_min_;
-  delete[] sb_max_;
+  delete[] stack_;
+  delete[] boxes_;
+}
+
+// Make room for size entries on the stack, keeping the ones there.
+void KDTreeSearch::Reserve(int size) {
+  if (size <= stack_allocated_)
+    return;
+  int new_size = MAX(size, 2 * stack_allocated_);
+  StackEntry *stack = new StackEntry[new_size];
+  FLOAT32 *boxes = new FLOAT32[2 * new_size * tree_->KeySize];
+  if (stack_ != NULL) {
+    memcpy(stack, stack_, stack_allocated_ * sizeof(*stack));
+    memcpy(boxes, boxes_,
+           2 * stack_allocated_ * tree_->KeySize * sizeof(*boxes));
+    delete[] stack_;
+    delete[] boxes_;
+  }
+  stack_ = stack;
+  boxes_ = boxes;
+  stack_allocated_ = new_size;
 }
 
 // Locate the k_closest points to query_point_, and return their distances and
 // data into the given buffers.
+// The subtrees are searched depth first from an explicit stack, the one on
+// the side of the query before the other, so that the other is most likely
+// pruned by the time it is popped.
 void KDTreeSearch::Search(int *result_count,
                           FLOAT32 *distances,
                           void **results) {
-  if (tree_->Root.Left == NULL) {
+  UpdateKDTree(tree_);
+  if (tree_->Root < 0) {
     *result_count = 0;
-  } else {
-    for (int i = 0; i < tree_->KeySize; i++) {
-      sb_min_[i] = tree_->KeyDesc[i].Min;
-      sb_max_[i] = tree_->KeyDesc[i].Max;
+    return;
+  }
+  int size = 1;
+  stack_[0].node = tree_->Root;
+  stack_[0].level = NextLevel(tree_, -1);
+  for (int i = 0; i < tree_->KeySize; i++) {
+    LowerOf(0)[i] = tree_->KeyDesc[i].Min;
+    UpperOf(0)[i] = tree_->KeyDesc[i].Max;
+  }
+  while (size > 0) {
+    int top = --size;
+    if (!BoxIntersectsSearch(LowerOf(top), UpperOf(top)))
+      continue;
+    KDNODE *node = &tree_->Nodes[stack_[top].node];
+    if (!node->Deleted)
+      results_->insert(DistanceSquared(tree_->KeySize, tree_->KeyDesc,
+                                       query_point_, node->Key),
+                       node->Data);
+
+    int level = stack_[top].level;
+    int next_level = NextLevel(tree_, level);
+    inT32 near_node, far_node;
+    if (query_point_[level] < node->BranchPoint) {
+      near_node = node->Left;
+      far_node = node->Right;
+    } else {
+      near_node = node->Right;
+      far_node = node->Left;
+    }
+    // Both children start from the box of their parent, which is in the
+    // entry just popped.
+    if (near_node >= 0 && far_node >= 0) {
+      Reserve(top + 2);
+      memcpy(LowerOf(top + 1), LowerOf(top),
+             2 * tree_->KeySize * sizeof(FLOAT32));
     }
-    SearchRec(0, tree_->Root.Left);
-    int count = results_->elements_count();
-    *result_count = count;
-    for (int j = 0; j < count; j++) {
-      distances[j] = (FLOAT32) sqrt((FLOAT64)results_->elements()[j].key);
-      results[j] = results_->elements()[j].value;
+    FLOAT32 left_branch = node->LeftBranch;
+    FLOAT32 right_branch = node->RightBranch;
+    inT32 left = node->Left;
+    inT32 children[2] = { far_node, near_node };
+    for (int c = 0; c < 2; ++c) {
+      if (children[c] < 0)
+        continue;
+      stack_[size].node = children[c];
+      stack_[size].level = next_level;
+      if (children[c] == left)
+        UpperOf(size)[level] = left_branch;
+      else
+        LowerOf(size)[level] = right_branch;
+      ++size;
     }
   }
+  int count = results_->elements_count();
+  *result_count = count;
+  for (int j = 0; j < count; j++) {
+    distances[j] = (FLOAT32) sqrt((FLOAT64)results_->elements()[j].key);
+    results[j] = results_->elements()[j].value;
+  }
 }
 
 /*-----------------------------------------------------------------------------
@@ -199,8 +299,12 @@ KDTREE *MakeKDTree(inT16 KeySize, const PARAM_DESC KeyDesc[]) {
     }
   }
   KDTree->KeySize = KeySize;
-  KDTree->Root.Left = NULL;
-  KDTree->Root.Right = NULL;
+  KDTree->Root = -1;
+  KDTree->Nodes = NULL;
+  KDTree->NumNodes = 0;
+  KDTree->NodesAllocated = 0;
+  KDTree->NumLinked = 0;
+  KDTree->NumDeleted = 0;
   return KDTree;
 }
 
@@ -209,7 +313,9 @@ KDTREE *MakeKDTree(inT16 KeySize, const PARAM_DESC KeyDesc[]) {
 void KDStore(KDTREE *Tree, FLOAT32 *Key, void *Data) {
 /**
  * This routine stores Data in the K-D tree specified by Tree
- * using Key as an access key.
+ * using Key as an access key.  The node is only linked into the
+ * tree by the next search, walk or delete, so that the nodes stored
+ * in a row are built into a balanced tree all at once.
  *
  * @param Tree    K-D tree in which data is to be stored
  * @param Key    ptr to key by which data can be retrieved
@@ -219,29 +325,7 @@ void KDStore(KDTREE *Tree, FLOAT32 *Key, void *Data) {
  * @note History:  3/10/89, DSJ, Created.
  *      7/13/89, DSJ, Changed return to void.
  */
-  int Level;
-  KDNODE *Node;
-  KDNODE **PtrToNode;
-
-  PtrToNode = &(Tree->Root.Left);
-  Node = *PtrToNode;
-  Level = NextLevel(Tree, -1);
-  while (Node != NULL) {
-    if (Key[Level] < Node->BranchPoint) {
-      PtrToNode = &(Node->Left);
-      if (Key[Level] > Node->LeftBranch)
-        Node->LeftBranch = Key[Level];
-    }
-    else {
-      PtrToNode = &(Node->Right);
-      if (Key[Level] < Node->RightBranch)
-        Node->RightBranch = Key[Level];
-    }
-    Level = NextLevel(Tree, Level);
-    Node = *PtrToNode;
-  }
-
-  *PtrToNode = MakeKDNode(Tree, Key, (void *) Data, Level);
+  MakeKDNode(Tree, Key, Data);
 }                                /* KDStore */
 
 
@@ -253,8 +337,9 @@ void KDStore(KDTREE *Tree, FLOAT32 *Key, void *Data) {
  * to the pointers that were used for the node when it was	
  * originally stored in the tree.  A node will be deleted from	
  * the tree only if its key and data pointers are identical	
- * to Key and Data respectively.  The tree is re-formed by removing
- * the affected subtree and inserting all elements but the root.
+ * to Key and Data respectively.  The node is only marked as
+ * deleted, and still routes and bounds the searches until the
+ * tree is rebuilt without it.
  *
  * @param Tree K-D tree to delete node from
  * @param Key key of node to be deleted
@@ -268,37 +353,30 @@ void KDStore(KDTREE *Tree, FLOAT32 *Key, void *Data) {
 void
 KDDelete (KDTREE * Tree, FLOAT32 Key[], void *Data) {
   int Level;
-  KDNODE *Current;
-  KDNODE *Father;
+  inT32 Current;
+  KDNODE *Node;
 
+  UpdateKDTree(Tree);
   /* initialize search at root of tree */
-  Father = &(Tree->Root);
-  Current = Father->Left;
+  Current = Tree->Root;
   Level = NextLevel(Tree, -1);
 
   /* search tree for node to be deleted */
-  while ((Current != NULL) && (!NodeFound (Current, Key, Data))) {
-    Father = Current;
-    if (Key[Level] < Current->BranchPoint)
-      Current = Current->Left;
+  while (Current >= 0) {
+    Node = &Tree->Nodes[Current];
+    if (!Node->Deleted && NodeFound(Node, Key, Data))
+      break;
+    if (Key[Level] < Node->BranchPoint)
+      Current = Node->Left;
     else
-      Current = Current->Right;
+      Current = Node->Right;
 
     Level = NextLevel(Tree, Level);
   }
 
-  if (Current != NULL) {         /* if node to be deleted was found */
-    if (Current == Father->Left) {
-      Father->Left = NULL;
-      Father->LeftBranch = Tree->KeyDesc[Level].Min;
-    } else {
-      Father->Right = NULL;
-      Father->RightBranch = Tree->KeyDesc[Level].Max;
-    }
-
-    InsertNodes(Tree, Current->Left);
-    InsertNodes(Tree, Current->Right);
-    FreeSubTree(Current);
+  if (Current >= 0) {            /* if node to be deleted was found */
+    Tree->Nodes[Current].Deleted = TRUE;
+    Tree->NumDeleted++;
   }
 }                                /* KDDelete */
 
@@ -335,10 +413,52 @@ void KDNearestNeighborSearch(
 
 
 /*---------------------------------------------------------------------------*/
-// Walk a given Tree with action.
+//  Walk a given Tree with action, calling it once on each node that is not
+//  deleted, parents before children and left subtrees before right ones:
+//        action(context, data, level)
+//  data is the data contents of the node being visited and level is the
+//  dimension the node branches on.
 void KDWalk(KDTREE *Tree, void_proc action, void *context) {
-  if (Tree->Root.Left != NULL)
-    Walk(Tree, action, context, Tree->Root.Left, NextLevel(Tree, -1));
+  UpdateKDTree(Tree);
+  if (Tree->Root < 0)
+    return;
+  // Each node pushes at most its two children after it is popped, so the
+  // stack holds at most one more node than the depth of the tree.
+  inT32 *stack = (inT32 *) Emalloc((Tree->NumNodes + 1) * sizeof(inT32));
+  inT32 *levels = (inT32 *) Emalloc((Tree->NumNodes + 1) * sizeof(inT32));
+  int size = 1;
+  stack[0] = Tree->Root;
+  levels[0] = NextLevel(Tree, -1);
+  while (size > 0) {
+    --size;
+    KDNODE *node = &Tree->Nodes[stack[size]];
+    int level = levels[size];
+    // The action must not store or delete nodes.
+    if (!node->Deleted)
+      (*action)(context, node->Data, level);
+    if (node->Right >= 0) {
+      stack[size] = node->Right;
+      levels[size++] = NextLevel(Tree, level);
+    }
+    if (node->Left >= 0) {
+      stack[size] = node->Left;
+      levels[size++] = NextLevel(Tree, level);
+    }
+  }
+  memfree(stack);
+  memfree(levels);
+}
+
+
+/*---------------------------------------------------------------------------*/
+// Return the data of the root of the tree, rebuilt without the deleted nodes,
+// or NULL if the tree is empty.  When a single node is left, as at the end of
+// clustering, that is its data.
+void *KDRootData(KDTREE *Tree) {
+  UpdateKDTree(Tree);
+  if (Tree->NumDeleted > 0)
+    BuildKDTree(Tree);
+  return Tree->Root < 0 ? NULL : Tree->Nodes[Tree->Root].Data;
 }
 
 
@@ -350,8 +470,8 @@ void FreeKDTree(KDTREE *Tree) {
  **  Operation:
  **    This routine frees all memory which is allocated to the
  **    specified KD-tree.  This includes the data structure for
- **    the kd-tree itself plus the data structures for each node
- **    in the tree.  It does not include the Key and Data items
+ **    the kd-tree itself plus the array of its nodes.
+ **    It does not include the Key and Data items
  **    which are pointed to by the nodes.  This memory is left
  **    untouched.
  **  Return: none
@@ -359,7 +479,8 @@ void FreeKDTree(KDTREE *Tree) {
  **  History:
  **    5/26/89, DSJ, Created.
  */
-  FreeSubTree(Tree->Root.Left);
+  if (Tree->Nodes != NULL)
+    memfree(Tree->Nodes);
   memfree(Tree);
 }                                /* FreeKDTree */
 
@@ -368,90 +489,209 @@ void FreeKDTree(KDTREE *Tree) {
               Private Code
 -----------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
-KDNODE *MakeKDNode(KDTREE *tree, FLOAT32 Key[], void *Data, int Index) {
+inT32 MakeKDNode(KDTREE *tree, FLOAT32 Key[], void *Data) {
 /*
  **  Parameters:
  **      tree  The tree to create the node for
  **      Key  Access key for new node in KD tree
  **      Data  ptr to data to be stored in new node
- **      Index  index of Key to branch on
  **  Operation:
- **    This routine allocates memory for a new K-D tree node
- **    and places the specified Key and Data into it.  The
- **    left and right subtree pointers for the node are
- **    initialized to empty subtrees.
+ **    This routine adds a node at the end of the nodes of tree,
+ **    growing them as needed, and places the specified Key and
+ **    Data into it.  The node is not linked into the tree.
  **  Return:
- **    pointer to new K-D tree node
+ **    index of the new K-D tree node
  **  Exceptions:
  **    None
  **  History:
  **    3/11/89, DSJ, Created.
  */
-  KDNODE *NewNode;
-
-  NewNode = (KDNODE *) Emalloc (sizeof (KDNODE));
+  if (tree->NumNodes == tree->NodesAllocated) {
+    tree->NodesAllocated = MAX(INITIALNODES, 2 * tree->NodesAllocated);
+    tree->Nodes = (KDNODE *) Erealloc(
+        tree->Nodes, tree->NodesAllocated * sizeof(KDNODE));
+  }
+  KDNODE *NewNode = &tree->Nodes[tree->NumNodes];
 
   NewNode->Key = Key;
   NewNode->Data = Data;
-  NewNode->BranchPoint = Key[Index];
-  NewNode->LeftBranch = tree->KeyDesc[Index].Min;
-  NewNode->RightBranch = tree->KeyDesc[Index].Max;
-  NewNode->Left = NULL;
-  NewNode->Right = NULL;
+  NewNode->Left = -1;
+  NewNode->Right = -1;
+  NewNode->Deleted = FALSE;
 
-  return NewNode;
+  return tree->NumNodes++;
 }                                /* MakeKDNode */
 
 
 /*---------------------------------------------------------------------------*/
-void FreeKDNode(KDNODE *Node) {
-  memfree ((char *)Node);
+// Insert the node of the given index into tree below its leaves, widening
+// the branches it goes down, as KDStore always did.
+void LinkKDNode(KDTREE *tree, inT32 index) {
+  KDNODE *NewNode = &tree->Nodes[index];
+  FLOAT32 *Key = NewNode->Key;
+  inT32 *Link = &tree->Root;
+  int Level = NextLevel(tree, -1);
+  while (*Link >= 0) {
+    KDNODE *Node = &tree->Nodes[*Link];
+    if (Key[Level] < Node->BranchPoint) {
+      Link = &Node->Left;
+      if (Key[Level] > Node->LeftBranch)
+        Node->LeftBranch = Key[Level];
+    }
+    else {
+      Link = &Node->Right;
+      if (Key[Level] < Node->RightBranch)
+        Node->RightBranch = Key[Level];
+    }
+    Level = NextLevel(tree, Level);
+  }
+  *Link = index;
+  NewNode->BranchPoint = Key[Level];
+  NewNode->LeftBranch = tree->KeyDesc[Level].Min;
+  NewNode->RightBranch = tree->KeyDesc[Level].Max;
+  NewNode->Left = -1;
+  NewNode->Right = -1;
 }
 
 
+// Swap two nodes of an array.
+static void SwapNodes(KDNODE *nodes, int a, int b) {
+  KDNODE tmp = nodes[a];
+  nodes[a] = nodes[b];
+  nodes[b] = tmp;
+}
+
+// Reorder nodes [lo, hi) so that nodes[k] is the one that would be there if
+// they were sorted by their keys in dimension level, with no larger key
+// before it and no smaller key after it.
+static void SelectNode(KDNODE *nodes, int lo, int hi, int k, int level) {
+  --hi;
+  while (hi > lo) {
+    FLOAT32 a = nodes[lo].Key[level];
+    FLOAT32 b = nodes[(lo + hi) / 2].Key[level];
+    FLOAT32 c = nodes[hi].Key[level];
+    FLOAT32 pivot = a < b ? (b < c ? b : (a < c ? c : a))
+                          : (a < c ? a : (b < c ? c : b));
+    int i = lo;
+    int j = hi;
+    while (i <= j) {
+      while (nodes[i].Key[level] < pivot)
+        ++i;
+      while (nodes[j].Key[level] > pivot)
+        --j;
+      if (i <= j)
+        SwapNodes(nodes, i++, j--);
+    }
+    // Now [lo, j] are at most pivot, [i, hi] at least and (j, i) equal to it.
+    if (k <= j)
+      hi = j;
+    else if (k >= i)
+      lo = i;
+    else
+      break;
+  }
+}
+
+// A range of nodes still to be built into a subtree by BuildKDTree, and the
+// link of its parent to set to the root of that subtree.
+struct KDBuildRange {
+  inT32 lo;
+  inT32 hi;
+  inT32 level;
+  inT32 *link;
+};
+
 /*---------------------------------------------------------------------------*/
-// Recursively accumulate the k_closest points to query_point_ into results_.
-//  Parameters:
-//      Level  level in tree of sub-tree to be searched
-//      SubTree  sub-tree to be searched
-void KDTreeSearch::SearchRec(int level, KDNODE *sub_tree) {
-  if (level >= tree_->KeySize)
-    level = 0;
-
-  if (!BoxIntersectsSearch(sb_min_, sb_max_))
+// Drop the deleted nodes of tree and build all the others, linked or not,
+// into a balanced tree.  The key of each node in its dimension is the median
+// of its subtree, and the nodes of a subtree follow its root in the array,
+// those of the left subtree first.
+void BuildKDTree(KDTREE *tree) {
+  KDNODE *nodes = tree->Nodes;
+  inT32 num_nodes = 0;
+  for (inT32 i = 0; i < tree->NumNodes; i++) {
+    if (!nodes[i].Deleted)
+      nodes[num_nodes++] = nodes[i];
+  }
+  tree->NumNodes = num_nodes;
+  tree->NumLinked = num_nodes;
+  tree->NumDeleted = 0;
+  tree->Root = -1;
+  if (num_nodes == 0)
     return;
 
-  results_->insert(DistanceSquared(tree_->KeySize, tree_->KeyDesc,
-                                  query_point_, sub_tree->Key),
-                   sub_tree->Data);
-
-  if (query_point_[level] < sub_tree->BranchPoint) {
-    if (sub_tree->Left != NULL) {
-      FLOAT32 tmp = sb_max_[level];
-      sb_max_[level] = sub_tree->LeftBranch;
-      SearchRec(NextLevel(tree_, level), sub_tree->Left);
-      sb_max_[level] = tmp;
+  // Each range popped pushes at most two, so the stack never holds more
+  // ranges than there are nodes.
+  KDBuildRange *stack =
+      (KDBuildRange *) Emalloc(num_nodes * sizeof(KDBuildRange));
+  int size = 1;
+  stack[0].lo = 0;
+  stack[0].hi = num_nodes;
+  stack[0].level = NextLevel(tree, -1);
+  stack[0].link = &tree->Root;
+  while (size > 0) {
+    KDBuildRange range = stack[--size];
+    int lo = range.lo;
+    int hi = range.hi;
+    int level = range.level;
+    int mid = lo + (hi - lo) / 2;
+    SelectNode(nodes, lo, hi, mid, level);
+    // The nodes with the same key as the median must all go right of it, so
+    // the root is the first of them, and it moves to the front of the range.
+    FLOAT32 median = nodes[mid].Key[level];
+    int split = lo;
+    for (int i = lo; i < mid; i++) {
+      if (nodes[i].Key[level] < median)
+        SwapNodes(nodes, i, split++);
     }
-    if (sub_tree->Right != NULL) {
-      FLOAT32 tmp = sb_min_[level];
-      sb_min_[level] = sub_tree->RightBranch;
-      SearchRec(NextLevel(tree_, level), sub_tree->Right);
-      sb_min_[level] = tmp;
+    SwapNodes(nodes, lo, split);
+    // Now the left subtree is [lo + 1, split + 1) and the right one
+    // [split + 1, hi).
+    KDNODE *node = &nodes[lo];
+    *range.link = lo;
+    node->BranchPoint = median;
+    node->LeftBranch = tree->KeyDesc[level].Min;
+    node->RightBranch = tree->KeyDesc[level].Max;
+    node->Left = -1;
+    node->Right = -1;
+    for (int i = lo + 1; i <= split; i++) {
+      if (i == lo + 1 || nodes[i].Key[level] > node->LeftBranch)
+        node->LeftBranch = nodes[i].Key[level];
     }
-  } else {
-    if (sub_tree->Right != NULL) {
-      FLOAT32 tmp = sb_min_[level];
-      sb_min_[level] = sub_tree->RightBranch;
-      SearchRec(NextLevel(tree_, level), sub_tree->Right);
-      sb_min_[level] = tmp;
+    for (int i = split + 1; i < hi; i++) {
+      if (i == split + 1 || nodes[i].Key[level] < node->RightBranch)
+        node->RightBranch = nodes[i].Key[level];
+    }
+    int next_level = NextLevel(tree, level);
+    if (split + 1 < hi) {
+      stack[size].lo = split + 1;
+      stack[size].hi = hi;
+      stack[size].level = next_level;
+      stack[size++].link = &node->Right;
     }
-    if (sub_tree->Left != NULL) {
-      FLOAT32 tmp = sb_max_[level];
-      sb_max_[level] = sub_tree->LeftBranch;
-      SearchRec(NextLevel(tree_, level), sub_tree->Left);
-      sb_max_[level] = tmp;
+    if (lo + 1 <= split) {
+      stack[size].lo = lo + 1;
+      stack[size].hi = split + 1;
+      stack[size].level = next_level;
+      stack[size++].link = &node->Left;
     }
   }
+  memfree(stack);
+}
+
+
+/*---------------------------------------------------------------------------*/
+// Link the nodes stored since the last update into tree.  If they and the
+// deleted nodes outnumber the nodes left in the tree, the whole tree is
+// rebuilt instead, which also drops the deleted nodes.
+void UpdateKDTree(KDTREE *tree) {
+  inT32 num_pending = tree->NumNodes - tree->NumLinked;
+  if (num_pending + tree->NumDeleted > tree->NumLinked - tree->NumDeleted) {
+    BuildKDTree(tree);
+  } else {
+    while (tree->NumLinked < tree->NumNodes)
+      LinkKDNode(tree, tree->NumLinked++);
+  }
 }
 
 
@@ -495,8 +735,8 @@ FLOAT32 ComputeDistance(int k, PARAM_DESC *dim, FLOAT32 p1[], FLOAT32 p2[]) {
 bool KDTreeSearch::BoxIntersectsSearch(FLOAT32 *lower, FLOAT32 *upper) {
   FLOAT32 *query = query_point_;
   FLOAT64 total_distance = 0.0;
-  FLOAT64 radius_squared =
-      results_->max_insertable_key() * results_->max_insertable_key();
+  // The keys of the results are already squared distances.
+  FLOAT64 radius_squared = results_->max_insertable_key();
   PARAM_DESC *dim = tree_->KeyDesc;
 
   for (int i = tree_->KeySize; i > 0; i--, dim++, query++, lower++, upper++) {
@@ -527,48 +767,3 @@ bool KDTreeSearch::BoxIntersectsSearch(FLOAT32 *lower, FLOAT32 *upper) {
   }
   return TRUE;
 }
-
-
-/*---------------------------------------------------------------------------*/
-//  Walk a tree, calling action once on each node.
-//
-//  Parameters:
-//      tree  root of the tree being walked.
-//      action  action to be performed at every node
-//      context  action's context
-//      sub_tree  ptr to root of subtree to be walked
-//      level  current level in the tree for this node
-//  Operation:
-//      This routine walks thru the specified sub_tree and invokes action
-//      action at each node as follows:
-//        action(context, data, level)
-//      data  the data contents of the node being visited,
-//      level is the level of the node in the tree with the root being level 0.
-void Walk(KDTREE *tree, void_proc action, void *context,
-          KDNODE *sub_tree, inT32 level) {
-  (*action)(context, sub_tree->Data, level);
-  if (sub_tree->Left != NULL)
-    Walk(tree, action, context, sub_tree->Left, NextLevel(tree, level));
-  if (sub_tree->Right != NULL)
-    Walk(tree, action, context, sub_tree->Right, NextLevel(tree, level));
-}
-
-
-// Given a subtree nodes, insert all of its elements into tree.
-void InsertNodes(KDTREE *tree, KDNODE *nodes) {
-  if (nodes == NULL)
-    return;
-
-  KDStore(tree, nodes->Key, nodes->Data);
-  InsertNodes(tree, nodes->Left);
-  InsertNodes(tree, nodes->Right);
-}
-
-// Free all of the nodes of a sub tree.
-void FreeSubTree(KDNODE *sub_tree) {
-  if (sub_tree != NULL) {
-    FreeSubTree(sub_tree->Left);
-    FreeSubTree(sub_tree->Right);
-    memfree(sub_tree);
-  }
-}                                /* FreeSubTree */
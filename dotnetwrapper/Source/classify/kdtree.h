@@ -42,20 +42,34 @@ struct KDNODE {
   FLOAT32 BranchPoint;           /**< needed to make deletes work efficiently */
   FLOAT32 LeftBranch;            /**< used to optimize search pruning */
   FLOAT32 RightBranch;           /**< used to optimize search pruning */
-  struct KDNODE *Left;           /**< ptrs for KD tree structure */
-  struct KDNODE *Right;
+  inT32 Left;                    /**< indices of the subtrees in Nodes, or -1 */
+  inT32 Right;
+  BOOL8 Deleted;                 /**< only kept to route and bound searches */
 };
 
+/**
+The nodes are held in one array. Nodes [0, NumLinked) are in the tree and
+the others have been stored since and are not linked yet: they are all built
+into a balanced tree at once by the first search, walk or delete that finds
+them more numerous than the nodes in the tree, or else inserted one by one.
+A deleted node is only marked as such, and the tree is rebuilt from the
+nodes left when the deleted ones outnumber them.
+*/
 struct KDTREE {
   inT16 KeySize;                 /* number of dimensions in the tree */
-  KDNODE Root;                   /* Root.Left points to actual root node */
+  inT32 Root;                    /* index of the root node, or -1 */
+  KDNODE *Nodes;                 /* all the nodes, linked or not */
+  inT32 NumNodes;                /* number of nodes used in Nodes */
+  inT32 NodesAllocated;          /* number of nodes allocated in Nodes */
+  inT32 NumLinked;               /* number of nodes linked into the tree */
+  inT32 NumDeleted;              /* number of linked nodes deleted */
   PARAM_DESC KeyDesc[1];         /* description of each dimension */
 };
 
 /*----------------------------------------------------------------------------
             Macros
 -----------------------------------------------------------------------------*/
-#define RootOf(T)   ((T)->Root.Left->Data)
+#define RootOf(T)   (KDRootData(T))
 
 /*-----------------------------------------------------------------------------
           Public Function Prototypes
@@ -72,25 +86,22 @@ void KDNearestNeighborSearch(
 
 void KDWalk(KDTREE *Tree, void_proc Action, void *context);
 
+void *KDRootData(KDTREE *Tree);
+
 void FreeKDTree(KDTREE *Tree);
 
 /*-----------------------------------------------------------------------------
           Private Function Prototypes
 -----------------------------------------------------------------------------*/
-KDNODE *MakeKDNode(KDTREE *tree, FLOAT32 Key[], void *Data, int Index);
+inT32 MakeKDNode(KDTREE *tree, FLOAT32 Key[], void *Data);
 
-void FreeKDNode(KDNODE *Node);
+void LinkKDNode(KDTREE *tree, inT32 Index);
 
-FLOAT32 DistanceSquared(int k, PARAM_DESC *dim, FLOAT32 p1[], FLOAT32 p2[]);
+void BuildKDTree(KDTREE *tree);
 
-FLOAT32 ComputeDistance(int k, PARAM_DESC *dim, FLOAT32 p1[], FLOAT32 p2[]);
+void UpdateKDTree(KDTREE *tree);
 
-int QueryInSearch(KDTREE *tree);
-
-void Walk(KDTREE *tree, void_proc action, void *context,
-          KDNODE *SubTree, inT32 Level);
-
-void InsertNodes(KDTREE *tree, KDNODE *nodes);
+FLOAT32 DistanceSquared(int k, PARAM_DESC *dim, FLOAT32 p1[], FLOAT32 p2[]);
 
-void FreeSubTree(KDNODE *SubTree);
+FLOAT32 ComputeDistance(int k, PARAM_DESC *dim, FLOAT32 p1[], FLOAT32 p2[]);
 #endif
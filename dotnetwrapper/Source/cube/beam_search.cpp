@@ -18,6 +18,7 @@
  **********************************************************************/
 
 #include <algorithm>
+#include <new>
 
 #include "beam_search.h"
 #include "tesseractclass.h"
@@ -32,16 +33,19 @@ BeamSearch::BeamSearch(CubeRecoContext *cntxt, bool word_mode) {
   word_mode_ = word_mode;
 }
 
-// Cleanup the lattice corresponding to the last search
+// Cleanup the lattice corresponding to the last search. The columns and
+// their nodes are destroyed, and their memory is kept by the arena for the
+// next search
 void BeamSearch::Cleanup() {
   if (col_ != NULL) {
     for (int col = 0; col < col_cnt_; col++) {
       if (col_[col])
-        delete col_[col];
+        col_[col]->~SearchColumn();
     }
-    delete []col_;
   }
   col_ = NULL;
+  node_hash_table_.Clear();
+  arena_.Reset();
 }
 
 BeamSearch::~BeamSearch() {
@@ -123,24 +127,16 @@ WordAltList * BeamSearch::Search(SearchObject *srch_obj, LangModel *lang_mod) {
   }
 
   // alloc memory for columns
-  col_ = new SearchColumn *[col_cnt_];
-  if (!col_) {
-    fprintf(stderr, "Cube ERROR (BeamSearch::Search): could not construct "
-            "SearchColumn array\n");
-    return NULL;
-  }
+  col_ = static_cast<SearchColumn **>(
+      arena_.Alloc(col_cnt_ * sizeof(*col_)));
   memset(col_, 0, col_cnt_ * sizeof(*col_));
 
   // for all possible segments
   for (int end_seg = 1; end_seg <= (seg_pt_cnt_ + 1); end_seg++) {
     // create a search column
-    col_[end_seg - 1] = new SearchColumn(end_seg - 1,
-                                         cntxt_->Params()->BeamWidth());
-    if (!col_[end_seg - 1]) {
-      fprintf(stderr, "Cube ERROR (BeamSearch::Search): could not construct "
-              "SearchColumn for column %d\n", end_seg - 1);
-      return NULL;
-    }
+    col_[end_seg - 1] = new(arena_.Alloc(sizeof(SearchColumn)))
+        SearchColumn(end_seg - 1, cntxt_->Params()->BeamWidth(), &arena_,
+                     &node_hash_table_);
 
     // for all possible start segments
     int init_seg = MAX(0, end_seg - cntxt_->Params()->MaxSegPerChar());
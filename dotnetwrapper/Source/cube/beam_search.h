@@ -31,6 +31,7 @@
 #ifndef BEAM_SEARCH_H
 #define BEAM_SEARCH_H
 
+#include "search_arena.h"
 #include "search_column.h"
 #include "word_altlist.h"
 #include "search_object.h"
@@ -95,6 +96,10 @@ class BeamSearch {
   int col_cnt_;
   // Array of lattice columns
   SearchColumn **col_;
+  // Memory of the lattice, reset at the start of each search
+  SearchArena arena_;
+  // Node hash table, used in turn by the columns as they are filled
+  SearchNodeHashTable node_hash_table_;
   // Run in word or phrase mode
   bool word_mode_;
   // Node index of best-cost node, before alternates are merged and sorted
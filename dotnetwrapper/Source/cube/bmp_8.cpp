@@ -21,11 +21,13 @@
 #include <math.h>
 #include <cstring>
 #include <algorithm>
+#include <vector>
 #include "bmp_8.h"
 #include "con_comp.h"
 #ifdef USE_STD_NAMESPACE
 using std::min;
 using std::max;
+using std::vector;
 #endif
 
 #ifdef WIN32
@@ -467,6 +469,14 @@ bool Bmp8::ScaleFrom(Bmp8 *bmp, bool isotropic) {
     unsigned int **dest_line_buff = CreateBmpBuffer(wid_, hgt_, 0),
       **dest_pix_cnt =  CreateBmpBuffer(wid_, hgt_, 0);
 
+    // the scaled x of each column is the same for every row, so it is
+    // computed once
+    vector<int> xdests(wid_src);
+    for (xsrc = 0; xsrc < wid_src; xsrc++) {
+      xdests[xsrc] = xoff + static_cast<int>(0.5 +
+                                             (1.0 * xsrc * x_num / x_denom));
+    }
+
     for (ysrc = 0; ysrc < hgt_src; ysrc++) {
       // compute scaled y
       ydest = yoff + static_cast<int>(0.5 + (1.0 * ysrc * y_num / y_denom));
@@ -475,8 +485,7 @@ bool Bmp8::ScaleFrom(Bmp8 *bmp, bool isotropic) {
       }
 
       for (xsrc = 0; xsrc < wid_src; xsrc++) {
-        // compute scaled y
-        xdest = xoff + static_cast<int>(0.5 + (1.0 * xsrc * x_num / x_denom));
+        xdest = xdests[xsrc];
         if (xdest < 0 || xdest >= wid_) {
           continue;
         }
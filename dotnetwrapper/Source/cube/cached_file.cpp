@@ -40,18 +40,33 @@ CachedFile::~CachedFile() {
     fp_ = NULL;
   }
 
-  if (buff_ != NULL) {
+  if (buff_ != NULL && !mapped_file_.IsOpen()) {
     delete []buff_;
-    buff_ = NULL;
   }
+  buff_ = NULL;
 }
 
 // free buffers and init vars
 bool CachedFile::Open() {
-  if (fp_ != NULL) {
+  if (fp_ != NULL || mapped_file_.IsOpen()) {
     return true;
   }
 
+  // use the whole mapped file as the buffer if possible
+  if (mapped_file_.Open(file_name_.c_str())) {
+    if (mapped_file_.size() <= 0x7fffffff) {
+      buff_ = reinterpret_cast<unsigned char *>(
+          const_cast<char *>(mapped_file_.data()));
+      file_size_ = static_cast<long>(mapped_file_.size());
+      buff_size_ = static_cast<int>(file_size_);
+      buff_pos_ = 0;
+      file_pos_ = file_size_;
+      return true;
+    }
+    // too large for the int buffer counters, so read it in chunks
+    mapped_file_.Close();
+  }
+
   fp_ = fopen(file_name_.c_str(), "r");
   if (fp_ == NULL) {
     return false;
@@ -124,7 +139,7 @@ int CachedFile::Read(void *read_buff, int bytes) {
 }
 
 long CachedFile::Size() {
-  if (fp_ == NULL && Open() == false) {
+  if (!Open()) {
     return 0;
   }
 
@@ -132,7 +147,7 @@ long CachedFile::Size() {
 }
 
 long CachedFile::Tell() {
-  if (fp_ == NULL && Open() == false) {
+  if (!Open()) {
     return 0;
   }
 
@@ -140,7 +155,7 @@ long CachedFile::Tell() {
 }
 
 bool CachedFile::eof() {
-  if (fp_ == NULL && Open() == false) {
+  if (!Open()) {
     return true;
   }
 
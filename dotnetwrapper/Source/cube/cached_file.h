@@ -25,6 +25,7 @@
 
 #include <stdio.h>
 #include <string>
+#include "mmapfile.h"
 #ifdef USE_STD_NAMESPACE
 using std::string;
 #endif
@@ -61,6 +62,9 @@ class CachedFile {
   int buff_size_;
   // file handle
   FILE *fp_;
+  // The file mapped into memory. If the mapping succeeds, buff_ points to
+  // the whole mapped file instead of a cache, and fp_ is not used.
+  MemoryMappedFile mapped_file_;
   // Opens the file
   bool Open();
 };
@@ -652,6 +652,27 @@ CharSamp *CharSamp::FromCharDumpFile(unsigned char **raw_data_ptr) {
   return char_samp;
 }
 
+// computes the foreground extents of the rows and columns in one pass
+void CharSamp::ComputeExtents() {
+  row_extents_.assign(2 * hgt_, -1);
+  col_extents_.assign(2 * wid_, -1);
+  for (int y = 0; y < hgt_; y++) {
+    unsigned char *line_data = line_buff_[y];
+    for (int x = 0; x < wid_; x++) {
+      if (line_data[x] == 0) {
+        if (row_extents_[2 * y] < 0) {
+          row_extents_[2 * y] = x;
+        }
+        row_extents_[2 * y + 1] = x;
+        if (col_extents_[2 * x] < 0) {
+          col_extents_[2 * x] = y;
+        }
+        col_extents_[2 * x + 1] = y;
+      }
+    }
+  }
+}
+
 // computes the features corresponding to the char sample
 bool CharSamp::ComputeFeatures(int conv_grid_size, float *features) {
   // Create a scaled BMP
@@ -31,6 +31,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string>
+#include <vector>
 #include "bmp_8.h"
 #include "string_32.h"
 
@@ -107,6 +108,28 @@ class CharSamp : public Bmp8 {
   void SetLastChar(unsigned short last_char) {
     last_char_ = last_char;
   }
+  // The foreground extents of the sample: a pair per row of the leftmost
+  // and rightmost foreground x, and a pair per column of the topmost and
+  // bottommost foreground y, both -1 for a blank row or column. They are
+  // computed from the bitmap on the first call unless set by SetExtents.
+  const int *RowExtents() {
+    if (row_extents_.empty()) {
+      ComputeExtents();
+    }
+    return &row_extents_[0];
+  }
+  const int *ColExtents() {
+    if (col_extents_.empty()) {
+      ComputeExtents();
+    }
+    return &col_extents_[0];
+  }
+  // Takes the contents of row_extents and col_extents as the extents of
+  // the sample, for a caller that knows them without the bitmap
+  void SetExtents(vector<int> *row_extents, vector<int> *col_extents) {
+    row_extents_.swap(*row_extents);
+    col_extents_.swap(*col_extents);
+  }
 
   // Saves the charsamp to a dump file
   bool Save2CharDumpFile(FILE *fp) const;
@@ -159,6 +182,12 @@ class CharSamp : public Bmp8 {
   unsigned short norm_aspect_ratio_;
   unsigned short first_char_;
   unsigned short last_char_;
+  // foreground extents of the rows and columns, empty until needed
+  vector<int> row_extents_;
+  vector<int> col_extents_;
+
+  // Computes the foreground extents from the bitmap
+  void ComputeExtents();
 };
 
 }
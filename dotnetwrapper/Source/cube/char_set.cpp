@@ -86,6 +86,8 @@ CharSet *CharSet::Create(TessdataManager *tessdata_manager,
     delete char_set;
     return false;
   }
+  tessdata_manager->SetLoaded(cube_unicharset_exists ?
+                              TESSDATA_CUBE_UNICHARSET : TESSDATA_UNICHARSET);
 
   char_set->init_ = true;
   return char_set;
@@ -73,6 +73,15 @@ class CharClassifier {
   virtual bool SetLearnParam(char *var_name, float val) = 0;
   virtual bool Init(const string &data_file_path, const string &lang,
                     LangModel *lang_mod) = 0;
+  // Classifies samp_cnt charsamps at once, setting alt_lists[samp] to what
+  // Classify(char_samps[samp]) would return. Classifiers that can share
+  // work between the samples override this.
+  virtual void ClassifyBatch(CharSamp **char_samps, int samp_cnt,
+                             CharAltList **alt_lists) {
+    for (int samp = 0; samp < samp_cnt; samp++) {
+      alt_lists[samp] = Classify(char_samps[samp]);
+    }
+  }
 
   // accessors
   FeatureBase *FeatureExtractor() {return feat_extract_;}
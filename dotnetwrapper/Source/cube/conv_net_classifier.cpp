@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <string>
 #include <vector>
 #include <wctype.h>
@@ -188,7 +189,10 @@ CharAltList *ConvNetCharClassifier::Classify(CharSamp *char_samp) {
   if (RunNets(char_samp) == false) {
     return NULL;
   }
+  return NetOutputAltList();
+}
 
+CharAltList *ConvNetCharClassifier::NetOutputAltList() {
   int class_cnt = char_set_->ClassCount();
 
   // create an altlist
@@ -207,6 +211,48 @@ CharAltList *ConvNetCharClassifier::Classify(CharSamp *char_samp) {
   return alt_list;
 }
 
+// The features of all the samples are computed first, then the net is run
+// on all of them at once, and the outputs of each sample are folded in
+// net_output_ as RunNets does.
+void ConvNetCharClassifier::ClassifyBatch(CharSamp **char_samps,
+                                          int samp_cnt,
+                                          CharAltList **alt_lists) {
+  if (char_net_ == NULL || net_output_ == NULL) {
+    CharClassifier::ClassifyBatch(char_samps, samp_cnt, alt_lists);
+    return;
+  }
+  int feat_cnt = char_net_->in_cnt();
+  int class_cnt = char_set_->ClassCount();
+  vector<float> inputs(samp_cnt * feat_cnt);
+  vector<int> batch_samps;
+  for (int samp = 0; samp < samp_cnt; samp++) {
+    alt_lists[samp] = NULL;
+    if (feat_extract_->ComputeFeatures(
+        char_samps[samp], &inputs[batch_samps.size() * feat_cnt]) == false) {
+      fprintf(stderr, "Cube ERROR (ConvNetCharClassifier::ClassifyBatch): "
+              "unable to compute features\n");
+      continue;
+    }
+    batch_samps.push_back(samp);
+  }
+  if (batch_samps.empty()) {
+    return;
+  }
+  int batch_cnt = static_cast<int>(batch_samps.size());
+  vector<float> outputs(batch_cnt * class_cnt);
+  if (char_net_->FeedForward(&inputs[0], batch_cnt, &outputs[0]) == false) {
+    fprintf(stderr, "Cube ERROR (ConvNetCharClassifier::ClassifyBatch): "
+            "unable to run feed-forward\n");
+    return;
+  }
+  for (int batch_samp = 0; batch_samp < batch_cnt; batch_samp++) {
+    memcpy(net_output_, &outputs[batch_samp * class_cnt],
+           class_cnt * sizeof(*net_output_));
+    Fold();
+    alt_lists[batch_samps[batch_samp]] = NetOutputAltList();
+  }
+}
+
 // Set an external net (for training purposes)
 void ConvNetCharClassifier::SetNet(tesseract::NeuralNet *char_net) {
   if (char_net_ != NULL) {
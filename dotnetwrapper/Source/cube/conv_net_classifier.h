@@ -64,6 +64,9 @@ class ConvNetCharClassifier : public CharClassifier {
   // Classifies an input charsamp and return a CharAltList object containing
   // the possible candidates and corresponding scores
   virtual CharAltList * Classify(CharSamp *char_samp);
+  // Classifies several charsamps with a single batch feedforward of the net
+  virtual void ClassifyBatch(CharSamp **char_samps, int samp_cnt,
+                             CharAltList **alt_lists);
   // Computes the cost of a specific charsamp being a character (versus a
   // non-character: part-of-a-character OR more-than-one-character)
   virtual int CharCost(CharSamp *char_samp);
@@ -89,6 +92,8 @@ class ConvNetCharClassifier : public CharClassifier {
   virtual void Fold();
   // Scales the input char_samp and feeds it to the NeuralNet as input
   bool RunNets(CharSamp *char_samp);
+  // Creates a CharAltList from the folded net outputs in net_output_
+  CharAltList *NetOutputAltList();
 };
 }
 #endif  // CONV_NET_CLASSIFIER_H
@@ -28,6 +28,7 @@ const bool CubeSearchObject::kUseCroppedChars = true;
 CubeSearchObject::CubeSearchObject(CubeRecoContext *cntxt, CharSamp *samp)
     : SearchObject(cntxt) {
   init_ = false;
+  batched_ = false;
   reco_cache_ = NULL;
   samp_cache_ = NULL;
   segments_ = NULL;
@@ -95,6 +96,8 @@ void CubeSearchObject::Cleanup() {
     delete []segments_;
     segments_ = NULL;
   }
+  seg_row_extents_.clear();
+  seg_col_extents_.clear();
 
   if (space_cost_) {
     delete []space_cost_;
@@ -108,6 +111,7 @@ void CubeSearchObject::Cleanup() {
 
   segment_cnt_ = 0;
   init_ = false;
+  batched_ = false;
 }
 
 // # of segmentation points. One less than the count of segments
@@ -124,6 +128,7 @@ bool CubeSearchObject::Init() {
   if (!Segment()) {
     return false;
   }
+  ComputeSegmentExtents();
 
   // init cache
   reco_cache_ = new CharAltList **[segment_cnt_];
@@ -219,6 +224,7 @@ CharSamp *CubeSearchObject::CharSample(int start_pt, int end_pt) {
   samp->SetNormTop(255 * char_top / hgt_);
   samp->SetNormBottom(255 * (char_top + char_hgt) / hgt_);
   samp->SetNormAspectRatio(255 * char_wid / (char_wid + char_hgt));
+  SetRangeExtents(start_pt, end_pt, samp);
 
   // add to cache & return
   samp_cache_[start_pt + 1][end_pt] = samp;
@@ -234,6 +240,13 @@ Box *CubeSearchObject::CharBox(int start_pt, int end_pt) {
     return NULL;
   }
 
+  // the sample may already be cached by the recognition
+  if (samp_cache_[start_pt + 1][end_pt]) {
+    CharSamp *samp = samp_cache_[start_pt + 1][end_pt];
+    return boxCreate(samp->Left(), samp->Top(),
+                     samp->Width(), samp->Height());
+  }
+
   // create a char samp object from the specified range of segments,
   // extract its dimensions into a leptonica box, and delete it
   bool left_most;
@@ -257,6 +270,43 @@ Box *CubeSearchObject::CharBox(int start_pt, int end_pt) {
   return box;
 }
 
+// The ranges whose CharSamp cannot be made are left out, for
+// RecognizeSegment to report.
+void CubeSearchObject::RecognizeAllSegments() {
+  batched_ = true;
+  vector<CharSamp *> samps;
+  vector<int> start_pts;
+  vector<int> end_pts;
+  for (int end_pt = 0; end_pt < segment_cnt_; end_pt++) {
+    for (int start_pt = MAX(-1, end_pt - max_seg_per_char_);
+         start_pt < end_pt; start_pt++) {
+      if (reco_cache_[start_pt + 1][end_pt]) {
+        continue;
+      }
+      CharSamp *samp = CharSample(start_pt, end_pt);
+      if (!samp) {
+        continue;
+      }
+      samps.push_back(samp);
+      start_pts.push_back(start_pt);
+      end_pts.push_back(end_pt);
+    }
+  }
+  if (samps.empty()) {
+    return;
+  }
+  int samp_cnt = static_cast<int>(samps.size());
+  vector<CharAltList *> alt_lists(samp_cnt);
+  {
+    PageStageTimer timer(cntxt_->TesseractPageStats(),
+                         PAGE_STAGE_CUBE_CLASSIFIER);
+    cntxt_->Classifier()->ClassifyBatch(&samps[0], samp_cnt, &alt_lists[0]);
+  }
+  for (int samp = 0; samp < samp_cnt; samp++) {
+    reco_cache_[start_pts[samp] + 1][end_pts[samp]] = alt_lists[samp];
+  }
+}
+
 // call from Beam Search to return the alt list corresponding to
 // recognizing the bitmap between two segmentation pts
 CharAltList * CubeSearchObject::RecognizeSegment(int start_pt, int end_pt) {
@@ -280,6 +330,15 @@ CharAltList * CubeSearchObject::RecognizeSegment(int start_pt, int end_pt) {
     return reco_cache_[start_pt + 1][end_pt];
   }
 
+  // BeamSearch asks for all the valid ranges, so they are classified
+  // together on the first miss
+  if (!batched_ && cntxt_->BatchSegments() && cntxt_->Classifier()) {
+    RecognizeAllSegments();
+    if (reco_cache_[start_pt + 1][end_pt]) {
+      return reco_cache_[start_pt + 1][end_pt];
+    }
+  }
+
   // create the char sample corresponding to the blob
   CharSamp *samp = CharSample(start_pt, end_pt);
   if (!samp) {
@@ -291,6 +350,8 @@ CharAltList * CubeSearchObject::RecognizeSegment(int start_pt, int end_pt) {
   // recognize the char sample
   CharClassifier *char_classifier = cntxt_->Classifier();
   if (char_classifier) {
+    PageStageTimer timer(cntxt_->TesseractPageStats(),
+                         PAGE_STAGE_CUBE_CLASSIFIER);
     reco_cache_[start_pt + 1][end_pt] = char_classifier->Classify(samp);
   } else {
     // no classifer: all characters are equally probable; add a penalty
@@ -335,6 +396,79 @@ bool CubeSearchObject::Segment() {
   return true;
 }
 
+// The extents of a segment are taken from its points, which is cheaper than
+// scanning its bitmap.
+void CubeSearchObject::ComputeSegmentExtents() {
+  seg_row_extents_.resize(segment_cnt_);
+  seg_col_extents_.resize(segment_cnt_);
+  for (int seg = 0; seg < segment_cnt_; seg++) {
+    ConComp *segment = segments_[seg];
+    vector<int> &row_extents = seg_row_extents_[seg];
+    vector<int> &col_extents = seg_col_extents_[seg];
+    row_extents.assign(2 * segment->Height(), -1);
+    col_extents.assign(2 * segment->Width(), -1);
+    for (ConCompPt *pt_ptr = segment->Head(); pt_ptr;
+         pt_ptr = pt_ptr->Next()) {
+      int x = pt_ptr->x() - segment->Left();
+      int y = pt_ptr->y() - segment->Top();
+      if (row_extents[2 * y] == -1) {
+        row_extents[2 * y] = row_extents[2 * y + 1] = x;
+      } else {
+        UpdateRange(x, &row_extents[2 * y], &row_extents[2 * y + 1]);
+      }
+      if (col_extents[2 * x] == -1) {
+        col_extents[2 * x] = col_extents[2 * x + 1] = y;
+      } else {
+        UpdateRange(y, &col_extents[2 * x], &col_extents[2 * x + 1]);
+      }
+    }
+  }
+}
+
+// The sample of a segment range holds exactly the foreground points of the
+// segments, so the extent of each of its rows and columns is the union of
+// those of the segments, shifted to the top left corner of the sample.
+void CubeSearchObject::SetRangeExtents(int start_pt, int end_pt,
+                                       CharSamp *samp) {
+  vector<int> row_extents(2 * samp->Height(), -1);
+  vector<int> col_extents(2 * samp->Width(), -1);
+  for (int seg = start_pt + 1; seg <= end_pt; seg++) {
+    int dx = segments_[seg]->Left() - samp->Left();
+    int dy = segments_[seg]->Top() - samp->Top();
+    const vector<int> &seg_rows = seg_row_extents_[seg];
+    int seg_hgt = static_cast<int>(seg_rows.size()) / 2;
+    for (int y = 0; y < seg_hgt; y++) {
+      if (seg_rows[2 * y] == -1) {
+        continue;
+      }
+      int *extent = &row_extents[2 * (y + dy)];
+      if (extent[0] == -1) {
+        extent[0] = seg_rows[2 * y] + dx;
+        extent[1] = seg_rows[2 * y + 1] + dx;
+      } else {
+        UpdateRange(seg_rows[2 * y] + dx, seg_rows[2 * y + 1] + dx,
+                    &extent[0], &extent[1]);
+      }
+    }
+    const vector<int> &seg_cols = seg_col_extents_[seg];
+    int seg_wid = static_cast<int>(seg_cols.size()) / 2;
+    for (int x = 0; x < seg_wid; x++) {
+      if (seg_cols[2 * x] == -1) {
+        continue;
+      }
+      int *extent = &col_extents[2 * (x + dx)];
+      if (extent[0] == -1) {
+        extent[0] = seg_cols[2 * x] + dy;
+        extent[1] = seg_cols[2 * x + 1] + dy;
+      } else {
+        UpdateRange(seg_cols[2 * x] + dy, seg_cols[2 * x + 1] + dy,
+                    &extent[0], &extent[1]);
+      }
+    }
+  }
+  samp->SetExtents(&row_extents, &col_extents);
+}
+
 // computes the space and no space costs at gaps between segments
 bool CubeSearchObject::ComputeSpaceCosts() {
   // init if necessary
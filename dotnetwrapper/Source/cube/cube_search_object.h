@@ -79,6 +79,8 @@ class CubeSearchObject : public SearchObject {
   int max_spc_gap_;
   // initialization flag
   bool init_;
+  // set once all the segment ranges were classified in a batch
+  bool batched_;
   // maximum segments per character: Cached from tuning parameters object
   int max_seg_per_char_;
   // char sample to be processed
@@ -87,6 +89,12 @@ class CubeSearchObject : public SearchObject {
   int segment_cnt_;
   // segments of the processed char samp
   ConComp **segments_;
+  // Foreground extents of the rows and columns of each segment, relative to
+  // its top left corner, as in CharSamp::RowExtents and ColExtents. They are
+  // computed once per word, and the extents of the sample of a segment range
+  // are composed from them instead of from its bitmap.
+  vector<vector<int> > seg_row_extents_;
+  vector<vector<int> > seg_col_extents_;
   // Cache data members:
   // There are two caches kept; a CharSamp cache and a CharAltList cache
   // Each is a 2-D array of CharSamp and CharAltList pointers respectively
@@ -107,6 +115,14 @@ class CubeSearchObject : public SearchObject {
   // histogram and sorting the resulting segments in reading order
   // Returns true on success
   bool Segment();
+  // Computes the foreground extents of the rows and columns of the segments
+  void ComputeSegmentExtents();
+  // Sets the foreground extents of samp, the sample of the specified range
+  // of segments, to the union of those of the segments
+  void SetRangeExtents(int start_pt, int end_pt, CharSamp *samp);
+  // Classifies in one batch all the valid segment ranges that are not in
+  // the recognition cache, and adds the results to the cache
+  void RecognizeAllSegments();
   // validate the segment ranges.
   inline bool IsValidSegmentRange(int start_pt, int end_pt) {
     return (end_pt > start_pt && start_pt >= -1 && start_pt < segment_cnt_ &&
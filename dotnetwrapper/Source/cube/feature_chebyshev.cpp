@@ -90,45 +90,36 @@ bool FeatureChebyshev::ComputeChebyshevCoefficients(CharSamp *char_samp,
   if (char_samp->NormBottom() <= 0) {
     return false;
   }
-  unsigned char *raw_data = char_samp->RawData();
-  int stride = char_samp->Stride();
   // compute the height of the word
   int word_hgt = (255 * (char_samp->Top() + char_samp->Height()) /
                   char_samp->NormBottom());
-  // compute left & right profiles
+  // compute left & right profiles from the foreground extents of the rows,
+  // which CubeSearchObject composes from those of the segments
   vector<float> left_profile(word_hgt, 0.0);
   vector<float> right_profile(word_hgt, 0.0);
-  unsigned char *line_data = raw_data;
-  for (int y = 0; y < char_samp->Height(); y++, line_data += stride) {
-    int min_x = char_samp->Width();
-    int max_x = -1;
-    for (int x = 0; x < char_samp->Width(); x++) {
-      if (line_data[x] == 0) {
-        UpdateRange(x, &min_x, &max_x);
-      }
-    }
+  const int *row_extents = char_samp->RowExtents();
+  for (int y = 0; y < char_samp->Height(); y++) {
+    int min_x = row_extents[2 * y];
+    int max_x = row_extents[2 * y + 1];
     left_profile[char_samp->Top() + y] =
-        1.0 * (min_x == char_samp->Width() ? 0 : (min_x + 1)) /
-        char_samp->Width();
+        1.0 * (min_x == -1 ? 0 : (min_x + 1)) / char_samp->Width();
     right_profile[char_samp->Top() + y] =
         1.0 * (max_x == -1 ? 0 : char_samp->Width() - max_x) /
         char_samp->Width();
   }
 
-  // compute top and bottom profiles
+  // compute top and bottom profiles from those of the columns
   vector<float> top_profile(char_samp->Width(), 0);
   vector<float> bottom_profile(char_samp->Width(), 0);
+  const int *col_extents = char_samp->ColExtents();
   for (int x = 0; x < char_samp->Width(); x++) {
-    int min_y = word_hgt;
-    int max_y = -1;
-    line_data = raw_data;
-    for (int y = 0; y < char_samp->Height(); y++, line_data += stride) {
-      if (line_data[x] == 0) {
-        UpdateRange(y + char_samp->Top(), &min_y, &max_y);
-      }
-    }
-    top_profile[x] = 1.0 * (min_y == word_hgt ? 0 : (min_y + 1)) / word_hgt;
-    bottom_profile[x] = 1.0 * (max_y == -1 ? 0 : (word_hgt - max_y)) / word_hgt;
+    int min_y = col_extents[2 * x];
+    int max_y = col_extents[2 * x + 1];
+    top_profile[x] = 1.0 * (min_y == -1 ? 0 :
+                            (min_y + char_samp->Top() + 1)) / word_hgt;
+    bottom_profile[x] = 1.0 * (max_y == -1 ? 0 :
+                               (word_hgt - max_y - char_samp->Top())) /
+                        word_hgt;
   }
 
   // compute the chebyshev coefficients of each profile
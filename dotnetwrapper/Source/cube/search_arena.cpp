@@ -0,0 +1,81 @@
+/**********************************************************************
+ * File:        search_arena.cpp
+ * Description: Implementation of the Beam Search Lattice Arena Class
+ * Created:     2011
+ *
+ * (C) Copyright 2011, Google Inc.
+ ** Licensed under the Apache License, Version 2.0 (the "License");
+ ** you may not use this file except in compliance with the License.
+ ** You may obtain a copy of the License at
+ ** http://www.apache.org/licenses/LICENSE-2.0
+ ** Unless required by applicable law or agreed to in writing, software
+ ** distributed under the License is distributed on an "AS IS" BASIS,
+ ** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ ** See the License for the specific language governing permissions and
+ ** limitations under the License.
+ *
+ **********************************************************************/
+
+#include <new>
+#include "search_arena.h"
+
+namespace tesseract {
+
+SearchArena::SearchArena() {
+  block_idx_ = 0;
+  used_ = 0;
+  free_nodes_ = NULL;
+}
+
+SearchArena::~SearchArena() {
+  for (int block = 0; block < static_cast<int>(blocks_.size()); block++) {
+    delete []blocks_[block].data;
+  }
+}
+
+void *SearchArena::Alloc(int size) {
+  size = (size + kAlignment - 1) & ~(kAlignment - 1);
+  // move on to the first of the next blocks that has room, the remainder
+  // of the skipped ones is lost until the next Reset
+  int block_cnt = static_cast<int>(blocks_.size());
+  while (block_idx_ < block_cnt &&
+         used_ + size > blocks_[block_idx_].size) {
+    block_idx_++;
+    used_ = 0;
+  }
+  if (block_idx_ == block_cnt) {
+    Block block;
+    block.size = size > kBlockSize ? size : kBlockSize;
+    block.data = new char[block.size];
+    blocks_.push_back(block);
+  }
+  void *ptr = blocks_[block_idx_].data + used_;
+  used_ += size;
+  return ptr;
+}
+
+SearchNode *SearchArena::NewNode(CubeRecoContext *cntxt,
+                                 SearchNode *parent_node, int char_reco_cost,
+                                 LangModEdge *edge, int col_idx) {
+  void *mem = free_nodes_;
+  if (mem != NULL) {
+    free_nodes_ = *reinterpret_cast<void **>(mem);
+  } else {
+    mem = Alloc(sizeof(SearchNode));
+  }
+  return new(mem) SearchNode(cntxt, parent_node, char_reco_cost, edge,
+                             col_idx);
+}
+
+void SearchArena::DeleteNode(SearchNode *node) {
+  node->~SearchNode();
+  *reinterpret_cast<void **>(node) = free_nodes_;
+  free_nodes_ = node;
+}
+
+void SearchArena::Reset() {
+  block_idx_ = 0;
+  used_ = 0;
+  free_nodes_ = NULL;
+}
+}  // namespace tesseract
@@ -0,0 +1,67 @@
+/**********************************************************************
+ * File:        search_arena.h
+ * Description: Declaration of the Beam Search Lattice Arena Class
+ * Created:     2011
+ *
+ * (C) Copyright 2011, Google Inc.
+ ** Licensed under the Apache License, Version 2.0 (the "License");
+ ** you may not use this file except in compliance with the License.
+ ** You may obtain a copy of the License at
+ ** http://www.apache.org/licenses/LICENSE-2.0
+ ** Unless required by applicable law or agreed to in writing, software
+ ** distributed under the License is distributed on an "AS IS" BASIS,
+ ** WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ ** See the License for the specific language governing permissions and
+ ** limitations under the License.
+ *
+ **********************************************************************/
+
+// The SearchArena class holds the memory of the lattice built by a
+// BeamSearch: its columns, their node arrays and their nodes. The memory is
+// taken from large blocks, and is given back all at once by Reset when the
+// next search starts, which keeps the blocks for it. The nodes pruned out
+// during a search are recycled through a free list.
+// The language model edges of the nodes are still owned and freed by them.
+
+#ifndef SEARCH_ARENA_H
+#define SEARCH_ARENA_H
+
+#include <vector>
+#include "search_node.h"
+
+namespace tesseract {
+
+class SearchArena {
+ public:
+  SearchArena();
+  ~SearchArena();
+  // Returns size bytes, aligned for any lattice object, valid until the
+  // next Reset
+  void *Alloc(int size);
+  // Creates a node, reusing the memory of a deleted one if any
+  SearchNode *NewNode(CubeRecoContext *cntxt, SearchNode *parent_node,
+                      int char_reco_cost, LangModEdge *edge, int col_idx);
+  // Destroys a node made by NewNode and keeps its memory for the next one
+  void DeleteNode(SearchNode *node);
+  // Makes all the memory of the arena available again. The objects in it
+  // must have been destroyed.
+  void Reset();
+
+ private:
+  static const int kBlockSize = 64 * 1024;
+  static const int kAlignment = 16;
+  struct Block {
+    char *data;
+    int size;
+  };
+  // The blocks, of which the first block_idx_ are full, and used_ bytes of
+  // the next one are taken
+  vector<Block> blocks_;
+  int block_idx_;
+  int used_;
+  // The memory of the deleted nodes, linked through its first bytes
+  void *free_nodes_;
+};
+}
+
+#endif  // SEARCH_ARENA_H
@@ -22,56 +22,38 @@
 
 namespace tesseract {
 
-SearchColumn::SearchColumn(int col_idx, int max_node) {
+SearchColumn::SearchColumn(int col_idx, int max_node, SearchArena *arena,
+                           SearchNodeHashTable *node_hash_table) {
   col_idx_ = col_idx;
   node_cnt_ = 0;
   node_array_ = NULL;
+  node_array_size_ = 0;
   max_node_cnt_ = max_node;
-  node_hash_table_ = NULL;
-  init_ = false;
+  node_hash_table_ = node_hash_table;
+  arena_ = arena;
   min_cost_ = INT_MAX;
   max_cost_ = 0;
 }
 
-// Cleanup data
+// Cleanup data. The memory stays in the arena until it is reset
 void SearchColumn::Cleanup() {
   if (node_array_ != NULL) {
     for (int node_idx = 0; node_idx < node_cnt_; node_idx++) {
       if (node_array_[node_idx] != NULL) {
-        delete node_array_[node_idx];
+        arena_->DeleteNode(node_array_[node_idx]);
       }
     }
 
-    delete []node_array_;
     node_array_ = NULL;
+    node_cnt_ = 0;
   }
   FreeHashTable();
-  init_ = false;
 }
 
 SearchColumn::~SearchColumn() {
   Cleanup();
 }
 
-// Initializations
-bool SearchColumn::Init() {
-  if (init_ == true) {
-    return true;
-  }
-
-  // create hash table
-  if (node_hash_table_ == NULL) {
-    node_hash_table_ = new SearchNodeHashTable();
-    if (node_hash_table_ == NULL) {
-      return false;
-    }
-  }
-
-  init_ = true;
-
-  return true;
-}
-
 // Prune the nodes if necessary. Pruning is done such that a max
 // number of nodes is kept, i.e., the beam width
 void SearchColumn::Prune() {
@@ -112,7 +94,7 @@ void SearchColumn::Prune() {
     // prune this node out
     if (node_array_[node_idx]->BestCost() > pruning_cost ||
         new_node_cnt > max_node_cnt_) {
-      delete node_array_[node_idx];
+      arena_->DeleteNode(node_array_[node_idx]);
     } else {
       // keep it
       node_array_[new_node_cnt++] = node_array_[node_idx];
@@ -133,8 +115,8 @@ void SearchColumn::Sort() {
 SearchNode *SearchColumn::AddNode(LangModEdge *edge, int reco_cost,
                                   SearchNode *parent_node,
                                   CubeRecoContext *cntxt) {
-  // init if necessary
-  if (init_ == false && Init() == false) {
+  // the hash table is given back once the column is filled
+  if (node_hash_table_ == NULL) {
     return NULL;
   }
 
@@ -143,36 +125,31 @@ SearchNode *SearchColumn::AddNode(LangModEdge *edge, int reco_cost,
   SearchNode *new_node = node_hash_table_->Lookup(edge, parent_node);
   // node does not exist
   if (new_node == NULL) {
-    new_node = new SearchNode(cntxt, parent_node, reco_cost, edge, col_idx_);
-    if (new_node == NULL) {
-      return NULL;
-    }
+    new_node = arena_->NewNode(cntxt, parent_node, reco_cost, edge, col_idx_);
 
     // if the max node count has already been reached, check if the cost of
     // the new node exceeds the max cost. This indicates that it will be pruned
     // and so there is no point adding it
     if (node_cnt_ >= max_node_cnt_ && new_node->BestCost() > max_cost_) {
-      delete new_node;
+      arena_->DeleteNode(new_node);
       return NULL;
     }
 
-    // expand the node buffer if necc
-    if ((node_cnt_ % kNodeAllocChunk) == 0) {
+    // expand the node buffer if necc. The old one is left in the arena
+    if (node_cnt_ == node_array_size_) {
       // alloc a new buff
-      SearchNode **new_node_buff =
-          new SearchNode *[node_cnt_ + kNodeAllocChunk];
-      if (new_node_buff == NULL) {
-        delete new_node;
-        return NULL;
-      }
+      int new_size = node_array_size_ == 0 ?
+          kNodeAllocChunk : 2 * node_array_size_;
+      SearchNode **new_node_buff = static_cast<SearchNode **>(
+          arena_->Alloc(new_size * sizeof(*new_node_buff)));
 
-      // free existing after copying contents
+      // copy existing contents
       if (node_array_ != NULL) {
         memcpy(new_node_buff, node_array_, node_cnt_ * sizeof(*new_node_buff));
-        delete []node_array_;
       }
 
       node_array_ = new_node_buff;
+      node_array_size_ = new_size;
     }
 
     // add the node to the hash table only if it is non-OOD edge
@@ -180,7 +157,7 @@ SearchNode *SearchColumn::AddNode(LangModEdge *edge, int reco_cost,
     if (edge->IsOOD() == false) {
       if (!node_hash_table_->Insert(edge, new_node)) {
         printf("Hash table full!!!");
-        delete new_node;
+        arena_->DeleteNode(new_node);
         return NULL;
       }
     }
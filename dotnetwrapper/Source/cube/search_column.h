@@ -24,10 +24,13 @@
 // The class maintains a hash table of the nodes to be able to lookup nodes
 // quickly using their lang_mod_edge. This is needed to merge similar paths
 // in the lattice
+// The nodes and the node array are in the arena of the BeamSearch, and the
+// hash table is lent by it while the column is being filled
 
 #ifndef SEARCH_COLUMN_H
 #define SEARCH_COLUMN_H
 
+#include "search_arena.h"
 #include "search_node.h"
 #include "lang_mod_edge.h"
 #include "cube_reco_context.h"
@@ -36,7 +39,8 @@ namespace tesseract {
 
 class SearchColumn {
  public:
-  SearchColumn(int col_idx, int max_node_cnt);
+  SearchColumn(int col_idx, int max_node_cnt, SearchArena *arena,
+               SearchNodeHashTable *node_hash_table);
   ~SearchColumn();
   // Accessor functions
   inline int ColIdx() const { return col_idx_; }
@@ -52,32 +56,32 @@ class SearchColumn {
   SearchNode *BestNode();
   // Sort the lattice nodes. Needed for visualization
   void Sort();
-  // Free up the Hash Table. Added to be called by the Beam Search after
-  // a column is pruned to reduce memory foot print
+  // Give back the Hash Table, cleared for the next column. Added to be
+  // called by the Beam Search after a column is pruned
   void FreeHashTable() {
     if (node_hash_table_ != NULL) {
-      delete node_hash_table_;
+      node_hash_table_->Clear();
       node_hash_table_ = NULL;
     }
   }
 
  private:
+  // initial size of the node array, which doubles when full
   static const int kNodeAllocChunk = 1024;
   static const int kScoreBins = 1024;
-  bool init_;
   int min_cost_;
   int max_cost_;
   int max_node_cnt_;
   int node_cnt_;
+  int node_array_size_;
   int col_idx_;
   int score_bins_[kScoreBins];
   SearchNode **node_array_;
   SearchNodeHashTable *node_hash_table_;
+  SearchArena *arena_;
 
-  // Free node array and hash table
+  // Free nodes and give back the hash table
   void Cleanup();
-  // Create hash table
-  bool Init();
 };
 }
 
@@ -27,6 +27,8 @@
 #ifndef SEARCH_NODE_H
 #define SEARCH_NODE_H
 
+#include <algorithm>
+#include <vector>
 #include "lang_mod_edge.h"
 #include "cube_reco_context.h"
 
@@ -106,10 +108,14 @@ class SearchNode {
 // Implments a SearchNode hash table used to detect if a Search Node exists
 // or not. This is needed to make sure that identical paths in the BeamSearch
 // converge
+// A node is filed under a bin computed from its edge and its parent's edge,
+// and the nodes of a bin are looked at in insertion order. The table is
+// flat, with open addressing and linear probing over indices into the
+// entries, and grows to keep at least half of its slots empty. Clear keeps
+// the memory, so that one table serves all the columns of the lattice.
 class SearchNodeHashTable {
  public:
   SearchNodeHashTable() {
-    memset(bin_size_array_, 0, sizeof(bin_size_array_));
   }
 
   ~SearchNodeHashTable() {
@@ -117,51 +123,93 @@ class SearchNodeHashTable {
 
   // inserts an entry in the hash table
   inline bool Insert(LangModEdge *lang_mod_edge, SearchNode *srch_node) {
-    // compute hash based on the edge and its parent node edge
-    unsigned int edge_hash = lang_mod_edge->Hash();
-    unsigned int parent_hash = (srch_node->ParentNode() == NULL ?
-        0 : srch_node->ParentNode()->LangModelEdge()->Hash());
-    unsigned int hash_bin = (edge_hash + parent_hash) % kSearchNodeHashBins;
-
-    // already maxed out, just fail
-    if (bin_size_array_[hash_bin] >= kMaxSearchNodePerBin) {
-      return false;
+    if (2 * (entries_.size() + 1) > slots_.size()) {
+      Grow();
     }
-
-    bin_array_[hash_bin][bin_size_array_[hash_bin]++] = srch_node;
-
+    Entry entry;
+    entry.hash_bin = HashBin(lang_mod_edge, srch_node->ParentNode());
+    entry.srch_node = srch_node;
+    entries_.push_back(entry);
+    Place(entries_.size() - 1);
     return true;
   }
 
   // Looks up an entry in the hash table
   inline SearchNode *Lookup(LangModEdge *lang_mod_edge,
                             SearchNode *parent_node) {
-    // compute hash based on the edge and its parent node edge
-    unsigned int edge_hash = lang_mod_edge->Hash();
-    unsigned int parent_hash = (parent_node == NULL ?
-        0 : parent_node->LangModelEdge()->Hash());
-    unsigned int hash_bin = (edge_hash + parent_hash) % kSearchNodeHashBins;
-
-    // lookup the entries in the hash bin
-    for (int node_idx = 0; node_idx < bin_size_array_[hash_bin]; node_idx++) {
-      if (lang_mod_edge->IsIdentical(
-          bin_array_[hash_bin][node_idx]->LangModelEdge()) == true &&
+    if (entries_.empty()) {
+      return NULL;
+    }
+    unsigned int hash_bin = HashBin(lang_mod_edge, parent_node);
+
+    // lookup the entries of the hash bin, which linear probing keeps in
+    // insertion order
+    int slot_mask = slots_.size() - 1;
+    for (int slot = hash_bin & slot_mask; slots_[slot] >= 0;
+         slot = (slot + 1) & slot_mask) {
+      const Entry &entry = entries_[slots_[slot]];
+      if (entry.hash_bin == hash_bin &&
+          lang_mod_edge->IsIdentical(
+          entry.srch_node->LangModelEdge()) == true &&
           SearchNode::IdenticalPath(
-          bin_array_[hash_bin][node_idx]->ParentNode(), parent_node) == true) {
-        return bin_array_[hash_bin][node_idx];
+          entry.srch_node->ParentNode(), parent_node) == true) {
+        return entry.srch_node;
       }
     }
 
     return NULL;
   }
 
+  // Removes all the entries, keeping the memory
+  void Clear() {
+    if (!entries_.empty()) {
+      entries_.clear();
+      std::fill(slots_.begin(), slots_.end(), -1);
+    }
+  }
+
  private:
-  // Hash bin size parameters. These were determined emperically. These affect
-  // the speed of the beam search but have no impact on accuracy
+  // Hash bin count. This was determined emperically. It affects the speed
+  // of the beam search but has no impact on accuracy
   static const int kSearchNodeHashBins = 4096;
-  static const int kMaxSearchNodePerBin = 512;
-  int bin_size_array_[kSearchNodeHashBins];
-  SearchNode *bin_array_[kSearchNodeHashBins][kMaxSearchNodePerBin];
+  // Initial slot count, a power of 2
+  static const int kMinSlotCnt = 256;
+  struct Entry {
+    unsigned int hash_bin;
+    SearchNode *srch_node;
+  };
+  // entries in insertion order
+  vector<Entry> entries_;
+  // indices into entries_, -1 for an empty slot
+  vector<int> slots_;
+
+  // compute the hash bin based on the edge and its parent node edge
+  static inline unsigned int HashBin(LangModEdge *lang_mod_edge,
+                                     SearchNode *parent_node) {
+    unsigned int edge_hash = lang_mod_edge->Hash();
+    unsigned int parent_hash = (parent_node == NULL ?
+        0 : parent_node->LangModelEdge()->Hash());
+    return (edge_hash + parent_hash) % kSearchNodeHashBins;
+  }
+  // Puts an entry in the first empty slot from that of its bin
+  inline void Place(int entry_idx) {
+    int slot_mask = slots_.size() - 1;
+    int slot = entries_[entry_idx].hash_bin & slot_mask;
+    while (slots_[slot] >= 0) {
+      slot = (slot + 1) & slot_mask;
+    }
+    slots_[slot] = entry_idx;
+  }
+  // Doubles the slots and places the entries again, in insertion order
+  void Grow() {
+    int slot_cnt = slots_.empty() ? kMinSlotCnt :
+        2 * static_cast<int>(slots_.size());
+    slots_.assign(slot_cnt, -1);
+    int entry_cnt = static_cast<int>(entries_.size());
+    for (int entry_idx = 0; entry_idx < entry_cnt; entry_idx++) {
+      Place(entry_idx);
+    }
+  }
 };
 }
 
@@ -73,10 +73,21 @@ TessLangModel::TessLangModel(const string &lm_params,
         tessdata_manager->SeekToStart(TESSDATA_CUBE_SYSTEM_DAWG)) {
       // The last parameter to the Dawg constructor (the debug level) is set to
       // false, until Cube has a way to express its preferred debug level.
-      *word_dawgs_ +=  new SquishedDawg(tessdata_manager->GetDataFilePtr(),
-                                        DAWG_TYPE_WORD,
-                                        cntxt_->Lang().c_str(),
-                                        SYSTEM_DAWG_PERM, false);
+      // The edges are used in place if the traineddata file is mapped.
+      const char *dawg_data =
+          tessdata_manager->GetDataPtr(TESSDATA_CUBE_SYSTEM_DAWG);
+      if (dawg_data != NULL) {
+        *word_dawgs_ += new SquishedDawg(
+            dawg_data,
+            tessdata_manager->GetDataSize(TESSDATA_CUBE_SYSTEM_DAWG),
+            DAWG_TYPE_WORD, cntxt_->Lang().c_str(), SYSTEM_DAWG_PERM, false);
+      } else {
+        *word_dawgs_ +=  new SquishedDawg(tessdata_manager->GetDataFilePtr(),
+                                          DAWG_TYPE_WORD,
+                                          cntxt_->Lang().c_str(),
+                                          SYSTEM_DAWG_PERM, false);
+      }
+      tessdata_manager->SetLoaded(TESSDATA_CUBE_SYSTEM_DAWG);
     }
   } else {
     word_dawgs_ = NULL;
@@ -26,6 +26,7 @@
 ----------------------------------------------------------------------------**/
 #include "emalloc.h"
 #include "danerror.h"
+#include "memry.h"
 #include <stdlib.h>
 
 /**----------------------------------------------------------------------------
@@ -55,6 +56,7 @@ void *Emalloc(size_t Size) {
 
   if (Size <= 0)
     DoError (ILLEGALMALLOCREQUEST, "Illegal malloc request size");
+  count_alloc();
   Buffer = (void *) malloc (Size);
   if (Buffer == NULL) {
     DoError (NOTENOUGHMEMORY, "Not enough memory");
@@ -32,6 +32,8 @@
 #endif
 #include "dawg.h"
 
+#include <string.h>
+
 #include "cutil.h"
 #include "dict.h"
 #include "emalloc.h"
@@ -152,7 +154,14 @@ void Dawg::init(DawgType type, const STRING &lang,
          F u n c t i o n s   f o r   S q u i s h e d    D a w g
 ----------------------------------------------------------------------*/
 
-SquishedDawg::~SquishedDawg() { memfree(edges_); }
+// Size of the header of squished dawg data: magic number, unicharset size
+// and number of edges.
+static const int kSquishedDawgHeaderSize = sizeof(inT16) + 2 * sizeof(inT32);
+
+SquishedDawg::~SquishedDawg() {
+  if (edges_owned_)
+    memfree(edges_);
+}
 
 EDGE_REF SquishedDawg::edge_char_of(NODE_REF node,
                                     UNICHAR_ID unichar_id,
@@ -295,6 +304,7 @@ void SquishedDawg::read_squished_dawg(FILE *file,
   Dawg::init(type, lang, perm, unicharset_size, debug_level);
 
   edges_ = (EDGE_ARRAY) memalloc(sizeof(EDGE_RECORD) * num_edges_);
+  edges_owned_ = true;
   fread(&edges_[0], sizeof(EDGE_RECORD), num_edges_, file);
   EDGE_REF edge;
   if (swap) {
@@ -310,6 +320,134 @@ void SquishedDawg::read_squished_dawg(FILE *file,
   }
 }
 
+void SquishedDawg::read_squished_dawg(const char *data, inT64 size,
+                                      DawgType type,
+                                      const STRING &lang,
+                                      PermuterType perm,
+                                      int debug_level) {
+  if (debug_level) tprintf("Reading squished dawg from memory\n");
+
+  bool swap;
+  int unicharset_size;
+  ASSERT_HOST(ReadHeader(data, size, &swap, &unicharset_size, &num_edges_));
+  ASSERT_HOST(num_edges_ > 0);  // DAWG should not be empty
+  ASSERT_HOST(size >= kSquishedDawgHeaderSize +
+              static_cast<inT64>(sizeof(EDGE_RECORD)) * num_edges_);
+  Dawg::init(type, lang, perm, unicharset_size, debug_level);
+
+  const char *edge_data = data + kSquishedDawgHeaderSize;
+  // The edges can be used in place if they need no swapping and the
+  // platform reads them at any alignment, or they happen to be aligned.
+#if defined(__i386__) || defined(__x86_64__) || \
+    defined(_M_IX86) || defined(_M_X64)
+  bool aligned = true;
+#else
+  bool aligned = reinterpret_cast<size_t>(edge_data) %
+      sizeof(EDGE_RECORD) == 0;
+#endif
+  if (!swap && aligned) {
+    edges_ = reinterpret_cast<EDGE_ARRAY>(const_cast<char *>(edge_data));
+    edges_owned_ = false;
+  } else {
+    edges_ = (EDGE_ARRAY) memalloc(sizeof(EDGE_RECORD) * num_edges_);
+    edges_owned_ = true;
+    memcpy(edges_, edge_data, sizeof(EDGE_RECORD) * num_edges_);
+    if (swap) {
+      for (EDGE_REF edge = 0; edge < num_edges_; ++edge)
+        edges_[edge] = reverse64(edges_[edge]);
+    }
+  }
+  if (debug_level > 2) {
+    tprintf("type: %d lang: %s perm: %d unicharset_size: %d num_edges: %d\n",
+            type_, lang_.string(), perm_, unicharset_size_, num_edges_);
+    for (EDGE_REF edge = 0; edge < num_edges_; ++edge)
+      print_edge(edge);
+  }
+}
+
+/*----------------------------------------------------------------------
+       F u n c t i o n s   f o r   L a z y   S q u i s h e d    D a w g
+----------------------------------------------------------------------*/
+
+// Full memory barrier, for the compiler and the CPU. volatile alone does
+// not order the writes that make a SquishedDawg before those of the
+// pointer to it, nor the reads through the pointer after it.
+static inline void DawgMemoryBarrier() {
+#ifdef WIN32
+  MemoryBarrier();
+#else
+  __sync_synchronize();
+#endif
+}
+
+LazySquishedDawg::LazySquishedDawg(TessdataManager *tessdata_manager,
+                                   TessdataType tessdata_type,
+                                   DawgType type, const STRING &lang,
+                                   PermuterType perm, int debug_level)
+  : tessdata_manager_(tessdata_manager),
+    tessdata_type_(tessdata_type),
+    mutex_(new CCUtilMutex),
+    dawg_(NULL) {
+  ASSERT_HOST(tessdata_manager->GetDataPtr(tessdata_type) != NULL);
+  // The edge masks of the base class are only used by the SquishedDawg.
+  type_ = type;
+  lang_ = lang;
+  perm_ = perm;
+  unicharset_size_ = 0;
+  debug_level_ = debug_level;
+}
+
+LazySquishedDawg::~LazySquishedDawg() {
+  delete dawg_;
+  delete mutex_;
+}
+
+const SquishedDawg *LazySquishedDawg::dawg() const {
+  const SquishedDawg *dawg = dawg_;
+  if (dawg == NULL)
+    return Load();
+  // Pairs with the barrier in Load that publishes the pointer.
+  DawgMemoryBarrier();
+  return dawg;
+}
+
+const SquishedDawg *LazySquishedDawg::Load() const {
+  mutex_->Lock();
+  if (dawg_ == NULL) {
+    SquishedDawg *dawg = new SquishedDawg(
+        tessdata_manager_->GetDataPtr(tessdata_type_),
+        tessdata_manager_->GetDataSize(tessdata_type_),
+        type_, lang_, perm_, debug_level_);
+    tessdata_manager_->SetLoaded(tessdata_type_);
+    if (debug_level_ > 0) {
+      tprintf("Loaded %s on first use\n",
+              kTessdataFileSuffixes[tessdata_type_]);
+    }
+    DawgMemoryBarrier();
+    dawg_ = dawg;
+  }
+  mutex_->Unlock();
+  return dawg_;
+}
+
+bool SquishedDawg::ReadHeader(const char *data, inT64 size, bool *swap,
+                              int *unicharset_size, int *num_edges) {
+  // The header is the same as in the file: magic number, unicharset size
+  // and number of edges, followed by the edges.
+  if (size < kSquishedDawgHeaderSize)
+    return false;
+  inT16 magic;
+  memcpy(&magic, data, sizeof(magic));
+  memcpy(unicharset_size, data + sizeof(inT16), sizeof(inT32));
+  memcpy(num_edges, data + sizeof(inT16) + sizeof(inT32), sizeof(inT32));
+  *swap = (magic != kDawgMagicNumber);
+  if (*swap) {
+    *unicharset_size = reverse32(*unicharset_size);
+    *num_edges = reverse32(*num_edges);
+  }
+  return true;
+}
+
 NODE_MAP SquishedDawg::build_node_map(inT32 *num_nodes) const {
   EDGE_REF   edge;
   NODE_MAP   node_map;
@@ -372,11 +510,11 @@ void SquishedDawg::write_squished_dawg(FILE *file) {
   for (edge=0; edge<num_edges_; edge++) {
     if (forward_edge(edge)) {  // write forward edges
       do {
+        // The edges may be read-only, so the copy is the one modified.
         old_index = next_node_from_edge_rec(edges_[edge]);
-        set_next_node(edge, node_map[old_index]);
         temp_record = edges_[edge];
+        set_next_node_in_edge_rec(&temp_record, node_map[old_index]);
         fwrite(&(temp_record), sizeof(EDGE_RECORD), 1, file);
-        set_next_node(edge, old_index);
       } while (!last_edge(edge++));
 
       if (backward_edge(edge))  // skip back links
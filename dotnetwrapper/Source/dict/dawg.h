@@ -34,6 +34,7 @@
 #include "elst.h"
 #include "ratngs.h"
 #include "params.h"
+#include "tessdatamanager.h"
 
 #ifdef __MSW32__
 #define NO_EDGE                (inT64) 0xffffffffffffffffi64
@@ -354,10 +355,19 @@ class SquishedDawg : public Dawg {
     num_forward_edges_in_node0 = num_forward_edges(0);
     fclose(file);
   }
+  /// Makes the dawg from the given size bytes of squished dawg data, such as
+  /// a component of a memory mapped traineddata file. When the data does not
+  /// need byte swapping, the edges are used in place, so the data must then
+  /// outlive the dawg.
+  SquishedDawg(const char *data, inT64 size, DawgType type,
+               const STRING &lang, PermuterType perm, int debug_level) {
+    read_squished_dawg(data, size, type, lang, perm, debug_level);
+    num_forward_edges_in_node0 = num_forward_edges(0);
+  }
   SquishedDawg(EDGE_ARRAY edges, int num_edges, DawgType type,
                const STRING &lang, PermuterType perm,
                int unicharset_size, int debug_level) :
-    edges_(edges), num_edges_(num_edges) {
+    edges_(edges), num_edges_(num_edges), edges_owned_(true) {
     init(type, lang, perm, unicharset_size, debug_level);
     num_forward_edges_in_node0 = num_forward_edges(0);
     if (debug_level > 3) print_all("SquishedDawg:");
@@ -366,6 +376,13 @@ class SquishedDawg : public Dawg {
 
   int NumEdges() { return num_edges_; }
 
+  /// Reads the header of the given size bytes of squished dawg data: sets
+  /// *swap if the data needs byte swapping, and the size of the unicharset
+  /// the dawg was made for and its number of edges. Returns false if the
+  /// data is too short for the header.
+  static bool ReadHeader(const char *data, inT64 size, bool *swap,
+                         int *unicharset_size, int *num_edges);
+
   /// Returns the edge that corresponds to the letter out of this node.
   EDGE_REF edge_char_of(NODE_REF node, UNICHAR_ID unichar_id,
                         bool word_end) const;
@@ -459,6 +476,10 @@ class SquishedDawg : public Dawg {
   /// Reads SquishedDawg from a file.
   void read_squished_dawg(FILE *file, DawgType type, const STRING &lang,
                           PermuterType perm, int debug_level);
+  /// Reads SquishedDawg from memory, using the edges in place if possible.
+  void read_squished_dawg(const char *data, inT64 size, DawgType type,
+                          const STRING &lang, PermuterType perm,
+                          int debug_level);
 
   /// Prints the contents of an edge indicated by the given EDGE_REF.
   void print_edge(EDGE_REF edge) const;
@@ -477,6 +498,73 @@ class SquishedDawg : public Dawg {
   EDGE_ARRAY edges_;
   int num_edges_;
   int num_forward_edges_in_node0;
+  /// False if edges_ points into memory that is not owned by this dawg,
+  /// such as a memory mapped file. The edges must not be modified then.
+  bool edges_owned_;
+};
+
+class CCUtilMutex;
+
+//
+/// Dawg standing for the SquishedDawg of a component of a memory mapped
+/// traineddata file, which is only made the first time the dawg is searched,
+/// so a dawg that is never looked at costs nothing to load. The loading is
+/// recorded with TessdataManager::SetLoaded. It is done under a lock, as the
+/// dawgs of a Dict may be shared by instances running in other threads.
+/// The TessdataManager must outlive this object.
+//
+class LazySquishedDawg : public Dawg {
+ public:
+  LazySquishedDawg(TessdataManager *tessdata_manager,
+                   TessdataType tessdata_type, DawgType type,
+                   const STRING &lang, PermuterType perm, int debug_level);
+  ~LazySquishedDawg();
+
+  /// Returns true if the SquishedDawg has already been made.
+  bool loaded() const { return dawg_ != NULL; }
+
+  EDGE_REF edge_char_of(NODE_REF node, UNICHAR_ID unichar_id,
+                        bool word_end) const {
+    return dawg()->edge_char_of(node, unichar_id, word_end);
+  }
+  void unichar_ids_of(NODE_REF node, NodeChildVector *vec) const {
+    dawg()->unichar_ids_of(node, vec);
+  }
+  NODE_REF next_node(EDGE_REF edge_ref) const {
+    return dawg()->next_node(edge_ref);
+  }
+  bool end_of_word(EDGE_REF edge_ref) const {
+    return dawg()->end_of_word(edge_ref);
+  }
+  UNICHAR_ID edge_letter(EDGE_REF edge_ref) const {
+    return dawg()->edge_letter(edge_ref);
+  }
+  void print_node(NODE_REF node, int max_num_edges) const {
+    dawg()->print_node(node, max_num_edges);
+  }
+  void unichar_id_to_patterns(UNICHAR_ID unichar_id,
+                              const UNICHARSET &unicharset,
+                              GenericVector<UNICHAR_ID> *vec) const {
+    dawg()->unichar_id_to_patterns(unichar_id, unicharset, vec);
+  }
+  EDGE_REF pattern_loop_edge(EDGE_REF edge_ref, UNICHAR_ID unichar_id,
+                             bool word_end) const {
+    return dawg()->pattern_loop_edge(edge_ref, unichar_id, word_end);
+  }
+
+ private:
+  /// Returns the SquishedDawg, making it if this is the first use.
+  const SquishedDawg *dawg() const;
+  /// Makes the SquishedDawg under the lock, unless another thread did.
+  const SquishedDawg *Load() const;
+
+  TessdataManager *tessdata_manager_;
+  TessdataType tessdata_type_;
+  CCUtilMutex *mutex_;
+  /// Only ever set once, to a fully made SquishedDawg, under mutex_ and
+  /// after a memory barrier. Readers that skip the lock take a barrier
+  /// after reading it, so they see the SquishedDawg fully made.
+  mutable SquishedDawg *volatile dawg_;
 };
 
 }  // namespace tesseract
@@ -185,6 +185,9 @@ Dict::Dict(Image* image_ptr)
   freq_dawg_ = NULL;
   punc_dawg_ = NULL;
   max_fixed_length_dawgs_wdlen_ = -1;
+  shared_dawgs_ = false;
+  dawg_donor_ = NULL;
+  own_document_words_ = NULL;
   wordseg_rating_adjust_factor_ = -1.0f;
 }
 
@@ -192,6 +195,68 @@ Dict::~Dict() {
   if (hyphen_word_ != NULL) delete hyphen_word_;
 }
 
+// Makes the dawg of the given tessdata type, which must be present.
+// If the traineddata file is memory mapped, the dawg is only made on its
+// first use, with its edges used in place in the file, so a dawg that is
+// never searched is never loaded. Otherwise it is read from the file now.
+static Dawg *NewSquishedDawg(TessdataManager *tessdata_manager,
+                             TessdataType tessdata_type,
+                             DawgType type, const STRING &lang,
+                             PermuterType perm, int debug_level) {
+  if (tessdata_manager->GetDataPtr(tessdata_type) != NULL) {
+    return new LazySquishedDawg(tessdata_manager, tessdata_type,
+                                type, lang, perm, debug_level);
+  }
+  tessdata_manager->SetLoaded(tessdata_type);
+  return new SquishedDawg(tessdata_manager->GetDataFilePtr(),
+                          type, lang, perm, debug_level);
+}
+
+// Returns the dawg of dawg_donor_ of the given types if it can be used in
+// place of the one of this language, ie if both are made from identical data
+// and the unichar ids of that data stand for the same unichars in both
+// unicharsets, as is often the case for the punctuation and number dawgs of
+// languages of the same script. Returns NULL otherwise.
+Dawg *Dict::DonatedDawg(TessdataType tessdata_type, DawgType type) {
+  if (dawg_donor_ == NULL)
+    return NULL;
+  TessdataManager &tessdata_manager =
+    getImage()->getCCUtil()->tessdata_manager;
+  TessdataManager &donor_manager =
+    dawg_donor_->getImage()->getCCUtil()->tessdata_manager;
+  if (!tessdata_manager.SameData(tessdata_type, donor_manager))
+    return NULL;
+  bool swap;
+  int unicharset_size;
+  int num_edges;
+  if (!SquishedDawg::ReadHeader(tessdata_manager.GetDataPtr(tessdata_type),
+                                tessdata_manager.GetDataSize(tessdata_type),
+                                &swap, &unicharset_size, &num_edges))
+    return NULL;
+  const UNICHARSET &unicharset = getUnicharset();
+  const UNICHARSET &donor_unicharset = dawg_donor_->getUnicharset();
+  if (unicharset_size > unicharset.size() ||
+      unicharset_size > donor_unicharset.size())
+    return NULL;
+  for (UNICHAR_ID id = 0; id < unicharset_size; ++id) {
+    if (strcmp(unicharset.id_to_unichar(id),
+               donor_unicharset.id_to_unichar(id)) != 0)
+      return NULL;
+  }
+  for (int i = 0; i < dawg_donor_->dawgs_.length(); ++i) {
+    Dawg *dawg = dawg_donor_->dawgs_[i];
+    if (dawg->type() == type) {
+      borrowed_dawgs_.push_back(dawg);
+      if (dawg_debug_level) {
+        tprintf("Using the %s of %s\n", kTessdataFileSuffixes[tessdata_type],
+                dawg->lang().string());
+      }
+      return dawg;
+    }
+  }
+  return NULL;
+}
+
 void Dict::Load() {
   STRING name;
   STRING &lang = getImage()->getCCUtil()->lang;
@@ -204,25 +269,32 @@ void Dict::Load() {
 
   // Load dawgs_.
   if (load_punc_dawg && tessdata_manager.SeekToStart(TESSDATA_PUNC_DAWG)) {
-    punc_dawg_ = new SquishedDawg(tessdata_manager.GetDataFilePtr(),
-                                  DAWG_TYPE_PUNCTUATION, lang, PUNC_PERM,
-                                  dawg_debug_level);
+    punc_dawg_ = DonatedDawg(TESSDATA_PUNC_DAWG, DAWG_TYPE_PUNCTUATION);
+    if (punc_dawg_ == NULL) {
+      punc_dawg_ = NewSquishedDawg(&tessdata_manager, TESSDATA_PUNC_DAWG,
+                                   DAWG_TYPE_PUNCTUATION, lang, PUNC_PERM,
+                                   dawg_debug_level);
+    }
     dawgs_ += punc_dawg_;
   }
   if (load_system_dawg && tessdata_manager.SeekToStart(TESSDATA_SYSTEM_DAWG)) {
-    dawgs_ += new SquishedDawg(tessdata_manager.GetDataFilePtr(),
-                               DAWG_TYPE_WORD, lang, SYSTEM_DAWG_PERM,
-                               dawg_debug_level);
+    dawgs_ += NewSquishedDawg(&tessdata_manager, TESSDATA_SYSTEM_DAWG,
+                              DAWG_TYPE_WORD, lang, SYSTEM_DAWG_PERM,
+                              dawg_debug_level);
   }
   if (load_number_dawg && tessdata_manager.SeekToStart(TESSDATA_NUMBER_DAWG)) {
-    dawgs_ +=
-      new SquishedDawg(tessdata_manager.GetDataFilePtr(),
-                       DAWG_TYPE_NUMBER, lang, NUMBER_PERM, dawg_debug_level);
+    Dawg *number_dawg = DonatedDawg(TESSDATA_NUMBER_DAWG, DAWG_TYPE_NUMBER);
+    if (number_dawg == NULL) {
+      number_dawg = NewSquishedDawg(&tessdata_manager, TESSDATA_NUMBER_DAWG,
+                                    DAWG_TYPE_NUMBER, lang, NUMBER_PERM,
+                                    dawg_debug_level);
+    }
+    dawgs_ += number_dawg;
   }
   if (tessdata_manager.SeekToStart(TESSDATA_FREQ_DAWG)) {
-    freq_dawg_ = new SquishedDawg(tessdata_manager.GetDataFilePtr(),
-                                  DAWG_TYPE_WORD, lang, FREQ_DAWG_PERM,
-                                  dawg_debug_level);
+    freq_dawg_ = NewSquishedDawg(&tessdata_manager, TESSDATA_FREQ_DAWG,
+                                 DAWG_TYPE_WORD, lang, FREQ_DAWG_PERM,
+                                 dawg_debug_level);
     dawgs_ += freq_dawg_;
   }
 
@@ -270,6 +342,7 @@ void Dict::Load() {
     ReadFixedLengthDawgs(DAWG_TYPE_WORD, lang, SYSTEM_DAWG_PERM,
                          dawg_debug_level, tessdata_manager.GetDataFilePtr(),
                          &dawgs_, &max_fixed_length_dawgs_wdlen_);
+    tessdata_manager.SetLoaded(TESSDATA_FIXED_LENGTH_DAWGS);
   }
 
   // Construct a list of corresponding successors for each dawg. Each entry i
@@ -289,10 +362,74 @@ void Dict::Load() {
   }
 }
 
+void Dict::LoadShared(const Dict& master) {
+  STRING &lang = getImage()->getCCUtil()->lang;
+
+  if (dawgs_.length() != 0) this->End();
+
+  hyphen_unichar_id_ = getUnicharset().unichar_to_id(kHyphenSymbol);
+  freq_dawg_ = master.freq_dawg_;
+  punc_dawg_ = master.punc_dawg_;
+  max_fixed_length_dawgs_wdlen_ = master.max_fixed_length_dawgs_wdlen_;
+
+  // The document dictionary is learned while recognizing, so it is the only
+  // dawg that is not borrowed from master. It keeps the index of the master's
+  // document dictionary, so the successors can be copied as they are.
+  document_words_ = new Trie(DAWG_TYPE_WORD, lang, DOC_DAWG_PERM,
+                             kMaxDocDawgEdges, getUnicharset().size(),
+                             dawg_debug_level);
+  dawgs_.reserve(master.dawgs_.length());
+  for (int i = 0; i < master.dawgs_.length(); ++i) {
+    if (master.dawgs_[i] == master.document_words_)
+      dawgs_ += document_words_;
+    else
+      dawgs_ += master.dawgs_[i];
+  }
+  shared_dawgs_ = true;
+
+  // This dawg is temporary and should not be searched by letter_is_ok.
+  pending_words_ = new Trie(DAWG_TYPE_WORD, lang, NO_PERM,
+                            kMaxDocDawgEdges, getUnicharset().size(),
+                            dawg_debug_level);
+
+  successors_.reserve(master.successors_.length());
+  for (int i = 0; i < master.successors_.length(); ++i)
+    successors_ += new SuccessorList(*master.successors_[i]);
+}
+
+void Dict::BorrowDocumentDictionary(const Dict* master) {
+  Trie *doc_words = NULL;
+  if (master != NULL) {
+    if (own_document_words_ == NULL)
+      own_document_words_ = document_words_;
+    doc_words = master->document_words_;
+  } else if (own_document_words_ != NULL) {
+    doc_words = own_document_words_;
+    own_document_words_ = NULL;
+  } else {
+    return;
+  }
+  for (int i = 0; i < dawgs_.length(); ++i) {
+    if (dawgs_[i] == document_words_)
+      dawgs_[i] = doc_words;
+  }
+  document_words_ = doc_words;
+}
+
 void Dict::End() {
+  BorrowDocumentDictionary(NULL);
   if (dawgs_.length() == 0)
     return;  // Not safe to call twice.
-  dawgs_.delete_data_pointers();
+  if (shared_dawgs_) {
+    delete document_words_;  // The other dawgs belong to the master Dict.
+  } else {
+    for (int i = 0; i < dawgs_.length(); ++i) {
+      if (!borrowed_dawgs_.contains(dawgs_[i]))
+        delete dawgs_[i];
+    }
+  }
+  shared_dawgs_ = false;
+  borrowed_dawgs_.clear();
   successors_.delete_data_pointers();
   dawgs_.clear();
   successors_.clear();
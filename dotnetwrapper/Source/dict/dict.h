@@ -457,6 +457,17 @@ class Dict {
   /// Initialize Dict class - load dawgs from [lang].traineddata and
   /// user-specified wordlist and parttern list.
   void Load();
+  /// Initialize Dict class by sharing the read-only dawgs of master instead
+  /// of loading them. Only the document dictionary and the pending words are
+  /// owned by this Dict; master must outlive it (see TessBaseAPIPool).
+  void LoadShared(const Dict& master);
+  /// Makes this Dict search the document dictionary of master instead of its
+  /// own, until called again with NULL. master must not add words meanwhile.
+  void BorrowDocumentDictionary(const Dict* master);
+  /// Makes Load use the punctuation and number dawgs of donor, the Dict of
+  /// another language, in place of identical ones of this language (see
+  /// DonatedDawg). donor must be loaded first and outlive this Dict.
+  void set_dawg_donor(Dict* donor) { dawg_donor_ = donor; }
   void End();
 
   // Resets the document dictionary analogous to ResetAdaptiveClassifier.
@@ -693,6 +704,10 @@ class Dict {
   }
 
  private:
+  /// Returns the dawg of dawg_donor_ of the given types if it can stand in
+  /// for the one of this language, or NULL.
+  Dawg *DonatedDawg(TessdataType tessdata_type, DawgType type);
+
   /** Private member variables. */
   Image* image_ptr_;
   /**
@@ -737,6 +752,15 @@ class Dict {
   /// Maximum word length of fixed-length word dawgs.
   /// A value < 1 indicates that no fixed-length dawgs are loaded.
   int max_fixed_length_dawgs_wdlen_;
+  /// True if all dawgs but document_words_ are borrowed from another Dict.
+  bool shared_dawgs_;
+  /// Dict of another language that may lend its dawgs to Load.
+  Dict *dawg_donor_;
+  /// The dawgs of dawgs_ lent by dawg_donor_, which are not deleted by End.
+  GenericVector<Dawg *> borrowed_dawgs_;
+  /// Own document dictionary while that of another Dict is borrowed by
+  /// BorrowDocumentDictionary.
+  Trie *own_document_words_;
   /// Current segmentation cost adjust factor for word rating.
   /// See comments in incorporate_segcost.
   float wordseg_rating_adjust_factor_;
@@ -249,6 +249,8 @@ void Dict::go_deeper_dawg_fxn(
 WERD_CHOICE *Dict::dawg_permute_and_select(
     const BLOB_CHOICE_LIST_VECTOR &char_choices, float rating_limit,
     int sought_word_length, int start_char_choice_index) {
+  PageStageTimer timer(getImage()->getCCUtil()->page_stats(),
+                       PAGE_STAGE_DAWG_PERMUTE);
   WERD_CHOICE *best_choice = new WERD_CHOICE();
   best_choice->make_bad();
   best_choice->set_rating(rating_limit);
@@ -0,0 +1,442 @@
+// Copyright 2011 Google Inc.
+// All Rights Reserved.
+//
+// dense_net.cpp: Implementation of a class for the read-only version of a
+// neural net whose neurons are in fully connected layers, evaluated as
+// matrix-vector products
+//
+#include <math.h>
+#include <string.h>
+#include "dense_net.h"
+#include "neuron.h"
+#include "simddetect.h"
+
+#ifdef HAVE_SSE2_INTRINSICS
+#include <emmintrin.h>
+#endif
+
+namespace tesseract {
+
+// rounds size up to a multiple of kDenseNetBlock
+static int BlockRound(int size) {
+  return (size + DenseNet::kDenseNetBlock - 1) /
+      DenseNet::kDenseNetBlock * DenseNet::kDenseNetBlock;
+}
+
+// rounds size up to a multiple of kQuantizedBlock
+static int QuantizedRound(int size) {
+  return (size + DenseNet::kQuantizedBlock - 1) /
+      DenseNet::kQuantizedBlock * DenseNet::kQuantizedBlock;
+}
+
+// rounds value to the nearest integer in [-kQuantizedMax, kQuantizedMax]
+static int QuantizeValue(double value) {
+  int quant = static_cast<int>(floor(value + 0.5));
+  if (quant > DenseNet::kQuantizedMax) {
+    return DenseNet::kQuantizedMax;
+  } else if (quant < -DenseNet::kQuantizedMax) {
+    return -DenseNet::kQuantizedMax;
+  }
+  return quant;
+}
+
+// The products are rounded to float, as in NeuralNet::FastFeedForward,
+// before being summed in double.
+static double DotProductScalar(const float *u, const float *v, int size) {
+  double sum = 0.0;
+  for (int i = 0; i < size; i++) {
+    sum += u[i] * v[i];
+  }
+  return sum;
+}
+
+static void DotProductsScalar(const float *u, const float *const *v,
+                              int size, double *products) {
+  for (int s = 0; s < DenseNet::kDenseNetBatch; s++) {
+    products[s] = DotProductScalar(u, v[s], size);
+  }
+}
+
+// The sums are exact, so both versions give the same results:
+// kQuantizedMax^2 products overflow an inT32 only after 2^17 inputs.
+static inT32 QuantizedDotProductScalar(const inT8 *wgts, const inT16 *inputs,
+                                       int size) {
+  inT32 sum = 0;
+  for (int i = 0; i < size; i++) {
+    sum += wgts[i] * inputs[i];
+  }
+  return sum;
+}
+
+#ifdef HAVE_SSE2_INTRINSICS
+// Multiplies 4 floats at a time and adds the products to two pairs of
+// double sums.
+static double DotProductSSE2(const float *u, const float *v, int size) {
+  __m128d sum_low = _mm_setzero_pd();
+  __m128d sum_high = _mm_setzero_pd();
+  for (int i = 0; i < size; i += DenseNet::kDenseNetBlock) {
+    __m128 prod = _mm_mul_ps(_mm_loadu_ps(u + i), _mm_loadu_ps(v + i));
+    sum_low = _mm_add_pd(sum_low, _mm_cvtps_pd(prod));
+    sum_high = _mm_add_pd(sum_high, _mm_cvtps_pd(_mm_movehl_ps(prod, prod)));
+  }
+  double sums[2];
+  _mm_storeu_pd(sums, _mm_add_pd(sum_low, sum_high));
+  return sums[0] + sums[1];
+}
+
+// Same as DotProductSSE2 for kDenseNetBatch vectors at once, loading each
+// block of u once.
+static void DotProductsSSE2(const float *u, const float *const *v,
+                            int size, double *products) {
+  __m128d sum_low[DenseNet::kDenseNetBatch];
+  __m128d sum_high[DenseNet::kDenseNetBatch];
+  for (int s = 0; s < DenseNet::kDenseNetBatch; s++) {
+    sum_low[s] = _mm_setzero_pd();
+    sum_high[s] = _mm_setzero_pd();
+  }
+  for (int i = 0; i < size; i += DenseNet::kDenseNetBlock) {
+    __m128 wgts = _mm_loadu_ps(u + i);
+    for (int s = 0; s < DenseNet::kDenseNetBatch; s++) {
+      __m128 prod = _mm_mul_ps(wgts, _mm_loadu_ps(v[s] + i));
+      sum_low[s] = _mm_add_pd(sum_low[s], _mm_cvtps_pd(prod));
+      sum_high[s] = _mm_add_pd(sum_high[s],
+                               _mm_cvtps_pd(_mm_movehl_ps(prod, prod)));
+    }
+  }
+  for (int s = 0; s < DenseNet::kDenseNetBatch; s++) {
+    double sums[2];
+    _mm_storeu_pd(sums, _mm_add_pd(sum_low[s], sum_high[s]));
+    products[s] = sums[0] + sums[1];
+  }
+}
+
+// Sign extends 16 weights to two vectors of 8 inT16, which _mm_madd_epi16
+// multiplies with the inputs and adds in pairs.
+static inT32 QuantizedDotProductSSE2(const inT8 *wgts, const inT16 *inputs,
+                                     int size) {
+  __m128i sum = _mm_setzero_si128();
+  for (int i = 0; i < size; i += DenseNet::kQuantizedBlock) {
+    __m128i wgt_bytes =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(wgts + i));
+    __m128i wgts_low =
+        _mm_srai_epi16(_mm_unpacklo_epi8(wgt_bytes, wgt_bytes), 8);
+    __m128i wgts_high =
+        _mm_srai_epi16(_mm_unpackhi_epi8(wgt_bytes, wgt_bytes), 8);
+    __m128i inputs_low =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(inputs + i));
+    __m128i inputs_high =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(inputs + i + 8));
+    sum = _mm_add_epi32(sum, _mm_madd_epi16(wgts_low, inputs_low));
+    sum = _mm_add_epi32(sum, _mm_madd_epi16(wgts_high, inputs_high));
+  }
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 8));
+  sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 4));
+  return _mm_cvtsi128_si32(sum);
+}
+#endif  // HAVE_SSE2_INTRINSICS
+
+DenseNet::DenseNet(int in_cnt)
+    : in_cnt_(in_cnt), max_stride_(0), calibrated_cnt_(0),
+      quantized_(false) {
+  dot_product_ = DotProductScalar;
+  dot_products_ = DotProductsScalar;
+  quantized_dot_product_ = QuantizedDotProductScalar;
+#ifdef HAVE_SSE2_INTRINSICS
+  if (SIMDDetect::IsSSE2Available()) {
+    dot_product_ = DotProductSSE2;
+    dot_products_ = DotProductsSSE2;
+    quantized_dot_product_ = QuantizedDotProductSSE2;
+  }
+#endif
+  SizeBuffers();
+}
+
+DenseNet::~DenseNet() {
+  for (int layer = 0; layer < static_cast<int>(layers_.size()); layer++) {
+    delete []layers_[layer].weights;
+    delete []layers_[layer].qweights;
+    delete []layers_[layer].biases;
+  }
+}
+
+void DenseNet::SizeBuffers() {
+  max_stride_ = quantized_ ? QuantizedRound(in_cnt_) : BlockRound(in_cnt_);
+  for (int layer = 0; layer < static_cast<int>(layers_.size()); layer++) {
+    if (layers_[layer].stride > max_stride_) {
+      max_stride_ = layers_[layer].stride;
+    }
+    if (BlockRound(layers_[layer].out_cnt) > max_stride_) {
+      max_stride_ = BlockRound(layers_[layer].out_cnt);
+    }
+  }
+  for (int buff = 0; buff < 2; buff++) {
+    activations_[buff].resize(kDenseNetBatch * max_stride_);
+  }
+  qinputs_.resize(quantized_ ? max_stride_ : 0);
+}
+
+void DenseNet::AddLayer(int out_cnt, const float *weights,
+                        const float *biases) {
+  Layer layer;
+  layer.in_cnt = this->out_cnt();
+  layer.stride = BlockRound(layer.in_cnt);
+  layer.out_cnt = out_cnt;
+  layer.weights = new float[out_cnt * layer.stride];
+  layer.biases = new float[out_cnt];
+  layer.qweights = NULL;
+  layer.wgt_scale = 1.0f;
+  layer.in_scale = 1.0f;
+  for (int node = 0; node < out_cnt; node++) {
+    float *row = layer.weights + node * layer.stride;
+    memcpy(row, weights + node * layer.in_cnt,
+           layer.in_cnt * sizeof(*row));
+    for (int in = layer.in_cnt; in < layer.stride; in++) {
+      row[in] = 0.0f;
+    }
+    layer.biases[node] = biases[node];
+  }
+  layers_.push_back(layer);
+  in_ranges_.push_back(0.0f);
+  SizeBuffers();
+}
+
+void DenseNet::AddQuantizedLayer(int out_cnt, const inT8 *weights,
+                                 float wgt_scale, float in_scale,
+                                 const float *biases) {
+  Layer layer;
+  layer.in_cnt = this->out_cnt();
+  layer.stride = QuantizedRound(layer.in_cnt);
+  layer.out_cnt = out_cnt;
+  layer.weights = NULL;
+  layer.qweights = new inT8[out_cnt * layer.stride];
+  layer.biases = new float[out_cnt];
+  layer.wgt_scale = wgt_scale;
+  layer.in_scale = in_scale;
+  for (int node = 0; node < out_cnt; node++) {
+    inT8 *row = layer.qweights + node * layer.stride;
+    memcpy(row, weights + node * layer.in_cnt,
+           layer.in_cnt * sizeof(*row));
+    for (int in = layer.in_cnt; in < layer.stride; in++) {
+      row[in] = 0;
+    }
+    layer.biases[node] = biases[node];
+  }
+  layers_.push_back(layer);
+  in_ranges_.push_back(0.0f);
+  quantized_ = true;
+  SizeBuffers();
+}
+
+bool DenseNet::Calibrate(const float *inputs) {
+  if (quantized_) {
+    return false;
+  }
+  int in_buff = 0;
+  LoadInputs(inputs, 0, 1, &activations_[0][0]);
+  for (int layer = 0; layer < static_cast<int>(layers_.size()); layer++) {
+    const float *in_row = &activations_[in_buff][0];
+    for (int in = 0; in < layers_[layer].in_cnt; in++) {
+      if (fabs(in_row[in]) > in_ranges_[layer]) {
+        in_ranges_[layer] = fabs(in_row[in]);
+      }
+    }
+    RowLayer(layers_[layer], in_row, &activations_[1 - in_buff][0]);
+    in_buff = 1 - in_buff;
+  }
+  calibrated_cnt_++;
+  return true;
+}
+
+bool DenseNet::Quantize() {
+  if (quantized_ || calibrated_cnt_ == 0) {
+    return false;
+  }
+  int layer_cnt = static_cast<int>(layers_.size());
+  for (int layer_idx = 0; layer_idx < layer_cnt; layer_idx++) {
+    Layer &layer = layers_[layer_idx];
+    float max_wgt = 0.0f;
+    for (int wgt = 0; wgt < layer.out_cnt * layer.stride; wgt++) {
+      if (fabs(layer.weights[wgt]) > max_wgt) {
+        max_wgt = fabs(layer.weights[wgt]);
+      }
+    }
+    // all-zero weights or inputs can have any scale
+    layer.wgt_scale = max_wgt > 0.0f ? max_wgt / kQuantizedMax : 1.0f;
+    layer.in_scale = in_ranges_[layer_idx] > 0.0f ?
+        in_ranges_[layer_idx] / kQuantizedMax : 1.0f;
+    int stride = QuantizedRound(layer.in_cnt);
+    layer.qweights = new inT8[layer.out_cnt * stride];
+    for (int node = 0; node < layer.out_cnt; node++) {
+      const float *row = layer.weights + node * layer.stride;
+      inT8 *qrow = layer.qweights + node * stride;
+      for (int in = 0; in < layer.in_cnt; in++) {
+        qrow[in] = QuantizeValue(row[in] / layer.wgt_scale);
+      }
+      for (int in = layer.in_cnt; in < stride; in++) {
+        qrow[in] = 0;
+      }
+    }
+    delete []layer.weights;
+    layer.weights = NULL;
+    layer.stride = stride;
+  }
+  quantized_ = true;
+  SizeBuffers();
+  return true;
+}
+
+// Each layer is its out_cnt, weight scale, input scale, out_cnt biases and
+// out_cnt rows of as many weights as the layer has inputs.
+bool DenseNet::WriteQuantizedLayers(FILE *fp) const {
+  if (!quantized_) {
+    return false;
+  }
+  int layer_cnt = static_cast<int>(layers_.size());
+  for (int layer_idx = 0; layer_idx < layer_cnt; layer_idx++) {
+    const Layer &layer = layers_[layer_idx];
+    if (fwrite(&layer.out_cnt, sizeof(layer.out_cnt), 1, fp) != 1 ||
+        fwrite(&layer.wgt_scale, sizeof(layer.wgt_scale), 1, fp) != 1 ||
+        fwrite(&layer.in_scale, sizeof(layer.in_scale), 1, fp) != 1 ||
+        fwrite(layer.biases, sizeof(*layer.biases), layer.out_cnt, fp) !=
+        static_cast<size_t>(layer.out_cnt)) {
+      return false;
+    }
+    for (int node = 0; node < layer.out_cnt; node++) {
+      if (fwrite(layer.qweights + node * layer.stride,
+                 sizeof(*layer.qweights), layer.in_cnt, fp) !=
+          static_cast<size_t>(layer.in_cnt)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void DenseNet::LoadInputs(const float *inputs, int first, int sample_cnt,
+                          float *rows) {
+  for (int row = 0; row < kDenseNetBatch; row++) {
+    float *act = rows + row * max_stride_;
+    int in = 0;
+    if (row < sample_cnt) {
+      memcpy(act, inputs + (first + row) * in_cnt_, in_cnt_ * sizeof(*act));
+      in = in_cnt_;
+    }
+    for (; in < max_stride_; in++) {
+      act[in] = 0.0f;
+    }
+  }
+}
+
+void DenseNet::QuantizeInputs(const Layer &layer, const float *in_row) {
+  for (int in = 0; in < layer.in_cnt; in++) {
+    qinputs_[in] = QuantizeValue(in_row[in] / layer.in_scale);
+  }
+  for (int in = layer.in_cnt; in < layer.stride; in++) {
+    qinputs_[in] = 0;
+  }
+}
+
+double DenseNet::Activation(const Layer &layer, int node,
+                            const float *in_row) {
+  double activation = -layer.biases[node];
+  if (quantized_) {
+    inT32 sum = quantized_dot_product_(layer.qweights + node * layer.stride,
+                                       &qinputs_[0], layer.stride);
+    activation += sum * (static_cast<double>(layer.wgt_scale) *
+        layer.in_scale);
+  } else {
+    activation += dot_product_(layer.weights + node * layer.stride, in_row,
+                               layer.stride);
+  }
+  return activation;
+}
+
+// The activations past out_cnt are cleared since they are the padding of
+// the inputs of the next layer.
+void DenseNet::RowLayer(const Layer &layer, const float *in_row,
+                        float *out_row) {
+  if (quantized_) {
+    QuantizeInputs(layer, in_row);
+  }
+  for (int node = 0; node < layer.out_cnt; node++) {
+    out_row[node] = Neuron::Sigmoid(Activation(layer, node, in_row));
+  }
+  for (int node = layer.out_cnt; node < BlockRound(layer.out_cnt); node++) {
+    out_row[node] = 0.0f;
+  }
+}
+
+void DenseNet::BatchLayer(const Layer &layer, const float *in_rows,
+                          float *out_rows) {
+  const float *rows[kDenseNetBatch];
+  for (int row = 0; row < kDenseNetBatch; row++) {
+    rows[row] = in_rows + row * max_stride_;
+  }
+  const float *wgts = layer.weights;
+  double products[kDenseNetBatch];
+  for (int node = 0; node < layer.out_cnt; node++, wgts += layer.stride) {
+    dot_products_(wgts, rows, layer.stride, products);
+    for (int row = 0; row < kDenseNetBatch; row++) {
+      double activation = -layer.biases[node];
+      activation += products[row];
+      out_rows[row * max_stride_ + node] = Neuron::Sigmoid(activation);
+    }
+  }
+  for (int row = 0; row < kDenseNetBatch; row++) {
+    float *act = out_rows + row * max_stride_;
+    for (int node = layer.out_cnt; node < BlockRound(layer.out_cnt);
+         node++) {
+      act[node] = 0.0f;
+    }
+  }
+}
+
+// Samples are done kDenseNetBatch at a time, except a last single one,
+// which is done on its own rather than with empty rows. Quantized nets do
+// one sample at a time.
+void DenseNet::FeedForward(const float *inputs, int sample_cnt,
+                           float *outputs) {
+  int out_cnt = this->out_cnt();
+  int batch_size = quantized_ ? 1 : kDenseNetBatch;
+  for (int first = 0; first < sample_cnt; first += batch_size) {
+    int batch_cnt = sample_cnt - first;
+    if (batch_cnt > batch_size) {
+      batch_cnt = batch_size;
+    }
+    int in_buff = 0;
+    LoadInputs(inputs, first, batch_cnt, &activations_[0][0]);
+    for (int layer = 0; layer < static_cast<int>(layers_.size()); layer++) {
+      if (batch_cnt == 1) {
+        RowLayer(layers_[layer], &activations_[in_buff][0],
+                 &activations_[1 - in_buff][0]);
+      } else {
+        BatchLayer(layers_[layer], &activations_[in_buff][0],
+                   &activations_[1 - in_buff][0]);
+      }
+      in_buff = 1 - in_buff;
+    }
+    for (int row = 0; row < batch_cnt; row++) {
+      memcpy(outputs + (first + row) * out_cnt,
+             &activations_[in_buff][row * max_stride_],
+             out_cnt * sizeof(*outputs));
+    }
+  }
+}
+
+float DenseNet::GetNetOutput(const float *inputs, int output_id) {
+  int in_buff = 0;
+  LoadInputs(inputs, 0, 1, &activations_[0][0]);
+  int hidden_cnt = static_cast<int>(layers_.size()) - 1;
+  for (int layer = 0; layer < hidden_cnt; layer++) {
+    RowLayer(layers_[layer], &activations_[in_buff][0],
+             &activations_[1 - in_buff][0]);
+    in_buff = 1 - in_buff;
+  }
+  const Layer &last = layers_.back();
+  if (quantized_) {
+    QuantizeInputs(last, &activations_[in_buff][0]);
+  }
+  return Neuron::Sigmoid(Activation(last, output_id,
+                                    &activations_[in_buff][0]));
+}
+}
@@ -0,0 +1,190 @@
+// Copyright 2011 Google Inc.
+// All Rights Reserved.
+//
+// dense_net.h: Declarations of a class for the read-only version of a
+// neural net whose neurons are in fully connected layers, evaluated as
+// matrix-vector products
+//
+
+#ifndef DENSE_NET_H
+#define DENSE_NET_H
+
+#include <stdio.h>
+#include <vector>
+#include "host.h"
+
+#ifdef USE_STD_NAMESPACE
+using std::vector;
+#endif
+
+namespace tesseract {
+
+// A feedforward net made of layers, each of which takes its inputs from all
+// the outputs of the previous layer, or from the net inputs for the first
+// one. The weights of a layer are kept in one row-major matrix, with a row
+// per node padded with zero weights to a multiple of kDenseNetBlock, so a
+// node's activation is a dot product over contiguous memory. The dot
+// products use SSE2 when the cpu has it, else a scalar loop.
+// The products are computed in float and summed in double, and the outputs
+// go through Neuron::Sigmoid, so that the outputs are those of the node
+// by node computation of NeuralNet, up to the order of the sums.
+// A net can instead be quantized: the weights of each layer are then int8
+// steps of a scale of the layer, and the inputs of each layer are rounded
+// to int16 steps of another scale, found by calibration, before an integer
+// dot product. The quantized layers take a quarter of the memory of the
+// float ones.
+class DenseNet {
+  public:
+    // The number of floats processed at once by the dot products.
+    static const int kDenseNetBlock = 4;
+    // The number of samples that share the loads of the weights in
+    // a batch feedforward.
+    static const int kDenseNetBatch = 4;
+    // The number of int8 weights processed at once by the quantized dot
+    // products.
+    static const int kQuantizedBlock = 16;
+    // The largest magnitude of the quantized weights and inputs.
+    static const int kQuantizedMax = 127;
+
+    explicit DenseNet(int in_cnt);
+    ~DenseNet();
+    // Adds a layer of out_cnt nodes on top of the last one. weights holds
+    // a row of in_cnt() weights per node if this is the first layer, else
+    // of last_layer's out_cnt weights. A node's activation is the weighted
+    // sum of its inputs minus its bias.
+    void AddLayer(int out_cnt, const float *weights, const float *biases);
+    // Same as AddLayer for a quantized layer: a weight w stands for
+    // w * wgt_scale, and the inputs are rounded to steps of in_scale.
+    // The layers of a net must be all float or all quantized.
+    void AddQuantizedLayer(int out_cnt, const inT8 *weights,
+                           float wgt_scale, float in_scale,
+                           const float *biases);
+    // Accessor functions
+    int in_cnt() const { return in_cnt_; }
+    int out_cnt() const {
+      return layers_.empty() ? in_cnt_ : layers_.back().out_cnt;
+    }
+    int layer_cnt() const { return layers_.size(); }
+    int layer_out_cnt(int layer) const { return layers_[layer].out_cnt; }
+    bool quantized() const { return quantized_; }
+    // Feeds a sample through the float layers, keeping for each layer the
+    // largest magnitude of its inputs, which Quantize uses for the scales.
+    // Returns false if the net is already quantized.
+    bool Calibrate(const float *inputs);
+    // Converts the float layers to quantized ones: the weight scale of a
+    // layer maps its largest weight to kQuantizedMax, and the input scale
+    // maps the largest input seen by Calibrate to kQuantizedMax. Larger
+    // inputs are clipped. Frees the float weights. Returns false if the net
+    // is already quantized or no sample was calibrated.
+    bool Quantize();
+    // Writes the quantized layers in the format read by
+    // ReadQuantizedLayers
+    bool WriteQuantizedLayers(FILE *fp) const;
+    // Reads layer_cnt quantized layers and adds them to the net
+    template<class ReadBuffType> bool ReadQuantizedLayers(
+        ReadBuffType *input_buff, int layer_cnt) {
+      vector<inT8> wgts;
+      vector<float> biases;
+      for (int layer = 0; layer < layer_cnt; layer++) {
+        int layer_in_cnt = out_cnt();
+        int layer_out_cnt;
+        float wgt_scale;
+        float in_scale;
+        if (input_buff->Read(&layer_out_cnt, sizeof(layer_out_cnt)) !=
+            sizeof(layer_out_cnt) || layer_out_cnt <= 0) {
+          return false;
+        }
+        if (input_buff->Read(&wgt_scale, sizeof(wgt_scale)) !=
+            sizeof(wgt_scale) ||
+            input_buff->Read(&in_scale, sizeof(in_scale)) !=
+            sizeof(in_scale)) {
+          return false;
+        }
+        biases.resize(layer_out_cnt);
+        int biases_size = sizeof(biases[0]) * layer_out_cnt;
+        if (input_buff->Read(&biases[0], biases_size) != biases_size) {
+          return false;
+        }
+        wgts.resize(layer_out_cnt * layer_in_cnt);
+        int wgts_size = sizeof(wgts[0]) * wgts.size();
+        if (input_buff->Read(&wgts[0], wgts_size) != wgts_size) {
+          return false;
+        }
+        AddQuantizedLayer(layer_out_cnt, &wgts[0], wgt_scale, in_scale,
+                          &biases[0]);
+      }
+      return true;
+    }
+    // Computes the outputs of the last layer for sample_cnt samples.
+    // inputs holds in_cnt() inputs per sample and outputs gets out_cnt()
+    // outputs per sample.
+    void FeedForward(const float *inputs, int sample_cnt, float *outputs);
+    // Returns the output output_id of the last layer only, computing the
+    // other layers in full.
+    float GetNetOutput(const float *inputs, int output_id);
+
+  private:
+    struct Layer {
+      int in_cnt;
+      // row size of the weights, in_cnt rounded up to kDenseNetBlock
+      int stride;
+      int out_cnt;
+      // out_cnt rows of stride weights, NULL if quantized
+      float *weights;
+      float *biases;
+      // out_cnt rows of stride quantized weights, NULL if not quantized
+      inT8 *qweights;
+      float wgt_scale;
+      float in_scale;
+    };
+    // Dot product of the first size elements of two vectors, where size is
+    // a multiple of kDenseNetBlock
+    typedef double (*DotProductFunc)(const float *u, const float *v,
+                                     int size);
+    // Dot products of one vector with kDenseNetBatch others
+    typedef void (*DotProductsFunc)(const float *u, const float *const *v,
+                                    int size, double *products);
+    // Dot product of int8 weights and int16 inputs, where size is a
+    // multiple of kQuantizedBlock
+    typedef inT32 (*QuantizedDotProductFunc)(const inT8 *wgts,
+                                             const inT16 *inputs, int size);
+
+    // Copies the samples [first, first + sample_cnt) of inputs into the
+    // first kDenseNetBatch rows of the activations buffer, padding them
+    // with zeros
+    void LoadInputs(const float *inputs, int first, int sample_cnt,
+                    float *rows);
+    // Computes the outputs of layer for the kDenseNetBatch rows of
+    // in_rows into out_rows
+    void BatchLayer(const Layer &layer, const float *in_rows,
+                    float *out_rows);
+    // Computes the outputs of layer for one row
+    void RowLayer(const Layer &layer, const float *in_row, float *out_row);
+    // Rounds the inputs of a quantized layer into qinputs_
+    void QuantizeInputs(const Layer &layer, const float *in_row);
+    // Returns the activation of a node of layer for in_row, which for
+    // a quantized layer must have gone through QuantizeInputs
+    double Activation(const Layer &layer, int node, const float *in_row);
+    // Sizes the activation buffers for the strides of the layers
+    void SizeBuffers();
+
+    int in_cnt_;
+    vector<Layer> layers_;
+    // The largest layer input or output, rounded up to kDenseNetBlock
+    int max_stride_;
+    // Two buffers of kDenseNetBatch rows of max_stride_ activations, used
+    // in turn as the inputs and outputs of the layers
+    vector<float> activations_[2];
+    // The inputs of the current quantized layer
+    vector<inT16> qinputs_;
+    // The largest input magnitude of each layer seen by Calibrate
+    vector<float> in_ranges_;
+    int calibrated_cnt_;
+    bool quantized_;
+    DotProductFunc dot_product_;
+    DotProductsFunc dot_products_;
+    QuantizedDotProductFunc quantized_dot_product_;
+};
+}
+
+#endif  // DENSE_NET_H
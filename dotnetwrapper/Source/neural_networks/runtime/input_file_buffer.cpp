@@ -5,6 +5,7 @@
 // input_file_buffer.h: Declarations of a class for an object that
 // represents an input file buffer.
 
+#include <string.h>
 #include <string>
 #include "input_file_buffer.h"
 
@@ -13,6 +14,7 @@ namespace tesseract {
 InputFileBuffer::InputFileBuffer(const string &file_name)
   : file_name_(file_name) {
   fp_ = NULL;
+  mapped_pos_ = 0;
 }
 
 // virtual destructor
@@ -25,12 +27,22 @@ InputFileBuffer::~InputFileBuffer() {
 // Read the specified number of bytes to the specified input buffer
 int InputFileBuffer::Read(void *buffer, int bytes_to_read) {
   // open the file if necessary
-  if (fp_ == NULL) {
+  if (fp_ == NULL && !mapped_file_.IsOpen() &&
+      !mapped_file_.Open(file_name_.c_str())) {
     fp_ = fopen(file_name_.c_str(), "rb");
     if (fp_ == NULL) {
       return 0;
     }
   }
+  if (mapped_file_.IsOpen()) {
+    inT64 bytes_left = mapped_file_.size() - mapped_pos_;
+    if (bytes_to_read > bytes_left) {
+      bytes_to_read = static_cast<int>(bytes_left);
+    }
+    memcpy(buffer, mapped_file_.data() + mapped_pos_, bytes_to_read);
+    mapped_pos_ += bytes_to_read;
+    return bytes_to_read;
+  }
   return fread(buffer, 1, bytes_to_read, fp_);
 }
 }
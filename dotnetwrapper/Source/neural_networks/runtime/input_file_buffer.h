@@ -11,6 +11,7 @@
 
 #include <stdio.h>
 #include <string>
+#include "mmapfile.h"
 #ifdef USE_STD_NAMESPACE
 using std::string;
 #endif
@@ -25,6 +26,11 @@ class InputFileBuffer {
   protected:
     string file_name_;
     FILE *fp_;
+    // The file is memory mapped if possible, so that reading the many small
+    // fields of a net is a copy from memory rather than a library call each.
+    // fp_ is only used if the mapping fails.
+    MemoryMappedFile mapped_file_;
+    inT64 mapped_pos_;
 };
 }
 
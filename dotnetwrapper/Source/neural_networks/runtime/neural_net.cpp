@@ -24,10 +24,11 @@ NeuralNet::~NeuralNet() {
   // clean up neurons
   delete []neurons_;
   // clean up nodes
-  for (int node_idx = 0; node_idx < neuron_cnt_; node_idx++) {
+  for (int node_idx = 0; node_idx < static_cast<int>(fast_nodes_.size());
+       node_idx++) {
     delete []fast_nodes_[node_idx].inputs;
   }
-
+  delete dense_net_;
 }
 
 // Initiaization function
@@ -41,6 +42,7 @@ void NeuralNet::Init() {
   out_cnt_ = 0;
   wts_vec_.clear();
   neurons_ = NULL;
+  dense_net_ = NULL;
   inputs_mean_.clear();
   inputs_std_dev_.clear();
   inputs_min_.clear();
@@ -51,6 +53,16 @@ void NeuralNet::Init() {
 // Templatized for float and double Types
 template <typename Type> bool NeuralNet::FastFeedForward(const Type *inputs,
                                                          Type *outputs) {
+  if (dense_net_ != NULL) {
+    for (int in = 0; in < in_cnt_; in++) {
+      dense_inputs_[in] = inputs[in] - fast_nodes_[in].bias;
+    }
+    dense_net_->FeedForward(&dense_inputs_[0], 1, &dense_outputs_[0]);
+    for (int out = 0; out < out_cnt_; out++) {
+      outputs[out] = dense_outputs_[out];
+    }
+    return true;
+  }
   int node_idx = 0;
   Node *node = &fast_nodes_[0];
   // feed inputs in and offset them by the pre-computed bias
@@ -108,6 +120,80 @@ template <typename Type> bool NeuralNet::FeedForward(const Type *inputs,
   return true;
 }
 
+// Performs a feedforward of several samples. Templatized for float and
+// double Types
+template <typename Type> bool NeuralNet::FeedForward(const Type *inputs,
+                                                     int sample_cnt,
+                                                     Type *outputs) {
+  if (sample_cnt <= 0) {
+    return true;
+  }
+  // nets not in layers do one sample at a time
+  if (!read_only_ || dense_net_ == NULL) {
+    for (int sample = 0; sample < sample_cnt; sample++) {
+      if (!FeedForward(inputs + sample * in_cnt_,
+                       outputs + sample * out_cnt_)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  dense_inputs_.resize(sample_cnt * in_cnt_);
+  dense_outputs_.resize(sample_cnt * out_cnt_);
+  for (int sample = 0; sample < sample_cnt; sample++) {
+    for (int in = 0; in < in_cnt_; in++) {
+      dense_inputs_[sample * in_cnt_ + in] =
+          inputs[sample * in_cnt_ + in] - fast_nodes_[in].bias;
+    }
+  }
+  dense_net_->FeedForward(&dense_inputs_[0], sample_cnt,
+                          &dense_outputs_[0]);
+  for (int out = 0; out < sample_cnt * out_cnt_; out++) {
+    outputs[out] = dense_outputs_[out];
+  }
+  return true;
+}
+
+// Calibrates the quantization scales with a sample
+// Templatized for float and double Types
+template <typename Type> bool NeuralNet::Calibrate(const Type *inputs) {
+  if (!read_only_ || dense_net_ == NULL) {
+    return false;
+  }
+  for (int in = 0; in < in_cnt_; in++) {
+    dense_inputs_[in] = inputs[in] - fast_nodes_[in].bias;
+  }
+  return dense_net_->Calibrate(&dense_inputs_[0]);
+}
+
+bool NeuralNet::Quantize() {
+  return dense_net_ != NULL && dense_net_->Quantize();
+}
+
+// A quantized net file has the quantized signature, the input, output and
+// layer counts, the input biases and the layers of the DenseNet
+bool NeuralNet::WriteQuantized(const string &file_name) const {
+  if (!quantized()) {
+    return false;
+  }
+  FILE *fp = fopen(file_name.c_str(), "wb");
+  if (fp == NULL) {
+    return false;
+  }
+  unsigned int header[4] = {
+    kQuantizedNetSignature, static_cast<unsigned int>(in_cnt_),
+    static_cast<unsigned int>(out_cnt_),
+    static_cast<unsigned int>(dense_net_->layer_cnt())
+  };
+  bool ok = fwrite(header, sizeof(header), 1, fp) == 1;
+  for (int in = 0; ok && in < in_cnt_; in++) {
+    ok = fwrite(&fast_nodes_[in].bias, sizeof(fast_nodes_[in].bias), 1,
+                fp) == 1;
+  }
+  ok = ok && dense_net_->WriteQuantizedLayers(fp);
+  return fclose(fp) == 0 && ok;
+}
+
 // Sets a connection between two neurons
 bool NeuralNet::SetConnection(int from, int to) {
   // allocate the wgt
@@ -181,7 +267,68 @@ bool NeuralNet::CreateFastNet() {
     }
   }
   // sanity check
-  return wts_cnt_ == wts_cnt;
+  if (wts_cnt_ != wts_cnt) {
+    return false;
+  }
+  CreateDenseNet();
+  return true;
+}
+
+// Looks for the layers from the first non-input node on: a layer is the
+// longest run of nodes that only take inputs from nodes before the run,
+// and all of them must be in the previous layer. Missing connections get
+// a zero weight.
+void NeuralNet::CreateDenseNet() {
+  delete dense_net_;
+  dense_net_ = NULL;
+  DenseNet *dense_net = new DenseNet(in_cnt_);
+  vector<float> wgts;
+  vector<float> biases;
+  int prev_start = 0;
+  int layer_start = in_cnt_;
+  while (layer_start < neuron_cnt_) {
+    int layer_end = layer_start;
+    for (; layer_end < neuron_cnt_; layer_end++) {
+      const Node *node = &fast_nodes_[layer_end];
+      int fan_in = 0;
+      while (fan_in < node->fan_in_cnt &&
+             node->inputs[fan_in].input_node - &fast_nodes_[0] < layer_start) {
+        fan_in++;
+      }
+      if (fan_in < node->fan_in_cnt) {
+        break;
+      }
+    }
+    // the first node of a layer only has inputs before it, so the layer
+    // is never empty
+    int in_cnt = layer_start - prev_start;
+    int out_cnt = layer_end - layer_start;
+    wgts.assign(out_cnt * in_cnt, 0.0f);
+    biases.resize(out_cnt);
+    for (int node_idx = layer_start; node_idx < layer_end; node_idx++) {
+      const Node *node = &fast_nodes_[node_idx];
+      float *row = &wgts[(node_idx - layer_start) * in_cnt];
+      for (int fan_in = 0; fan_in < node->fan_in_cnt; fan_in++) {
+        int id = node->inputs[fan_in].input_node - &fast_nodes_[0];
+        if (id < prev_start) {
+          delete dense_net;
+          return;
+        }
+        row[id - prev_start] += node->inputs[fan_in].input_weight;
+      }
+      biases[node_idx - layer_start] = node->bias;
+    }
+    dense_net->AddLayer(out_cnt, &wgts[0], &biases[0]);
+    prev_start = layer_start;
+    layer_start = layer_end;
+  }
+  if (prev_start != neuron_cnt_ - out_cnt_) {
+    delete dense_net;
+    return;
+  }
+  dense_net_ = dense_net;
+  dense_inputs_.resize(in_cnt_);
+  dense_outputs_.resize(out_cnt_);
 }
 
 // returns a pointer to the requested set of weights
@@ -231,6 +378,13 @@ NeuralNet *NeuralNet::FromInputBuffer(InputFileBuffer *ib) {
 template <typename Type> bool NeuralNet::FastGetNetOutput(const Type *inputs,
                                                           int output_id,
                                                           Type *output) {
+  if (dense_net_ != NULL) {
+    for (int in = 0; in < in_cnt_; in++) {
+      dense_inputs_[in] = inputs[in] - fast_nodes_[in].bias;
+    }
+    (*output) = dense_net_->GetNetOutput(&dense_inputs_[0], output_id);
+    return true;
+  }
   // feed inputs in and offset them by the pre-computed bias
   int node_idx = 0;
   Node *node = &fast_nodes_[0];
@@ -289,9 +443,15 @@ template <typename Type> bool NeuralNet::GetNetOutput(const Type *inputs,
 // Instantiate all supported templates now that the functions have been defined.
 template bool NeuralNet::FeedForward(const float *inputs, float *outputs);
 template bool NeuralNet::FeedForward(const double *inputs, double *outputs);
+template bool NeuralNet::FeedForward(const float *inputs, int sample_cnt,
+                                     float *outputs);
+template bool NeuralNet::FeedForward(const double *inputs, int sample_cnt,
+                                     double *outputs);
 template bool NeuralNet::FastFeedForward(const float *inputs, float *outputs);
 template bool NeuralNet::FastFeedForward(const double *inputs,
                                          double *outputs);
+template bool NeuralNet::Calibrate(const float *inputs);
+template bool NeuralNet::Calibrate(const double *inputs);
 template bool NeuralNet::GetNetOutput(const float *inputs, int output_id,
                                       float *output);
 template bool NeuralNet::GetNetOutput(const double *inputs, int output_id,
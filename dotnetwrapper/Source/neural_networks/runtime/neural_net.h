@@ -13,6 +13,7 @@
 #include <vector>
 #include "neuron.h"
 #include "input_file_buffer.h"
+#include "dense_net.h"
 
 namespace tesseract {
 
@@ -30,15 +31,34 @@ class NeuralNet {
     // Different flavors of feed forward function
     template <typename Type> bool FeedForward(const Type *inputs,
                                               Type *outputs);
+    // Feed forward of sample_cnt samples at once: inputs holds in_cnt()
+    // inputs per sample and outputs gets out_cnt() outputs per sample.
+    // Read-only nets in layers share the loads of the weights between
+    // the samples, so this is faster than a FeedForward per sample.
+    template <typename Type> bool FeedForward(const Type *inputs,
+                                              int sample_cnt,
+                                              Type *outputs);
     // Compute the output of a specific output node.
     // This function is useful for application that are interested in a single
     // output of the net and do not want to waste time on the rest
     template <typename Type> bool GetNetOutput(const Type *inputs,
                                                int output_id,
                                                Type *output);
+    // Feeds a sample to a read-only net in layers to calibrate the scales
+    // of its inputs for Quantize. Returns false for other nets.
+    template <typename Type> bool Calibrate(const Type *inputs);
+    // Converts the weights of a calibrated net to int8, as described in
+    // DenseNet. The feedforward functions then use the int8 weights.
+    bool Quantize();
+    // Writes a quantized net to a file, which FromFile reads back as
+    // a quantized net, without the float weights
+    bool WriteQuantized(const string &file_name) const;
     // Accessor functions
     int in_cnt() const { return in_cnt_; }
     int out_cnt() const { return out_cnt_; }
+    bool quantized() const {
+      return dense_net_ != NULL && dense_net_->quantized();
+    }
 
   protected:
     struct Node;
@@ -77,6 +97,9 @@ class NeuralNet {
     // Magic number expected at the beginning of the NN
     // binary file
     static const unsigned int kNetSignature = 0xFEFEABD0;
+    // Magic number expected at the beginning of a quantized NN
+    // binary file
+    static const unsigned int kQuantizedNetSignature = 0xFEFEABD1;
     // count of allocated wgts in the last chunk
     int alloc_wgt_cnt_;
     // vector of weights buffers
@@ -94,6 +117,13 @@ class NeuralNet {
     // vector of input offsets used by fast read-only
     // feedforward function
     vector<Node> fast_nodes_;
+    // Matrix version of the fast nodes, used instead of them by the
+    // read-only feedforward functions if the nodes are in layers.
+    // NULL otherwise
+    DenseNet *dense_net_;
+    // inputs offset by the input biases, and outputs, of dense_net_
+    vector<float> dense_inputs_;
+    vector<float> dense_outputs_;
     // Network Initialization function
     void Init();
     // Clears all neurons
@@ -113,6 +143,9 @@ class NeuralNet {
       if (input_buff->Read(&read_val, sizeof(read_val)) != sizeof(read_val)) {
         return false;
       }
+      if (read_val == kQuantizedNetSignature) {
+        return ReadQuantized(input_buff);
+      }
       if (read_val != kNetSignature) {
         return false;
       }
@@ -221,11 +254,65 @@ class NeuralNet {
       return true;
     }
 
+    // Reads the rest of a quantized net, written by WriteQuantized.
+    // Only the input nodes are kept in fast_nodes_, for their biases, and
+    // the layers in dense_net_.
+    template<class ReadBuffType> bool ReadQuantized(
+        ReadBuffType *input_buff) {
+      unsigned int read_val;
+      if (input_buff->Read(&read_val, sizeof(read_val)) != sizeof(read_val)) {
+        return false;
+      }
+      in_cnt_ = read_val;
+      if (in_cnt_ <= 0) {
+        return false;
+      }
+      if (input_buff->Read(&read_val, sizeof(read_val)) != sizeof(read_val)) {
+        return false;
+      }
+      out_cnt_ = read_val;
+      if (out_cnt_ <= 0) {
+        return false;
+      }
+      if (input_buff->Read(&read_val, sizeof(read_val)) != sizeof(read_val)) {
+        return false;
+      }
+      int layer_cnt = read_val;
+      if (layer_cnt <= 0) {
+        return false;
+      }
+      fast_nodes_.resize(in_cnt_);
+      for (int node_idx = 0; node_idx < in_cnt_; node_idx++) {
+        Node *node = &fast_nodes_[node_idx];
+        node->fan_in_cnt = 0;
+        node->inputs = NULL;
+        if (input_buff->Read(&node->bias, sizeof(node->bias)) !=
+            sizeof(node->bias)) {
+          return false;
+        }
+      }
+      dense_net_ = new DenseNet(in_cnt_);
+      if (!dense_net_->ReadQuantizedLayers(input_buff, layer_cnt) ||
+          dense_net_->out_cnt() != out_cnt_) {
+        return false;
+      }
+      neuron_cnt_ = in_cnt_;
+      for (int layer = 0; layer < layer_cnt; layer++) {
+        neuron_cnt_ += dense_net_->layer_out_cnt(layer);
+      }
+      dense_inputs_.resize(in_cnt_);
+      dense_outputs_.resize(out_cnt_);
+      return true;
+    }
     // creates a connection between two nodes
     bool SetConnection(int from, int to);
     // Create a read only version of the net that
     // has faster feedforward performance
     bool CreateFastNet();
+    // Creates dense_net_ from the fast nodes if each non-input node takes
+    // its inputs from the layer of nodes just before its own, and the
+    // outputs make the last layer
+    void CreateDenseNet();
     // internal function to allocate a new set of weights
     // Centralized weight allocation attempts to increase
     // weights locality of reference making it more cache friendly
@@ -260,6 +260,7 @@ Textord::~Textord() {
 void Textord::TextordPage(PageSegMode pageseg_mode,
                           int width, int height, Pix* pix,
                           BLOCK_LIST* blocks, TO_BLOCK_LIST* to_blocks) {
+  PageStageTimer timer(ccstruct_->page_stats(), PAGE_STAGE_TEXTORD);
   page_tr_.set_x(width);
   page_tr_.set_y(height);
   if (to_blocks->empty()) {
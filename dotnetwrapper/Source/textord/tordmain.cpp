@@ -219,6 +219,7 @@ namespace tesseract {
 
 void Textord::find_components(Pix* pix, BLOCK_LIST *blocks,
                               TO_BLOCK_LIST *to_blocks) {
+  PageStageTimer timer(ccstruct_->page_stats(), PAGE_STAGE_FIND_COMPONENTS);
   int width = pixGetWidth(pix);
   int height = pixGetHeight(pix);
   if (width > MAX_INT16 || height > MAX_INT16) {
@@ -69,6 +69,17 @@ void WriteProtos(
      BOOL8  WriteSigProtos,
      BOOL8  WriteInsigProtos);
 
+// Gathers the prototypes of the classes as ClusterClasses hands them over.
+struct NormProtoCollector {
+  // Only the clusterer of the last class is kept, for its parameters, with
+  // the proto list of that class.
+  CLUSTERER *Clusterer;
+  LIST ProtoList;
+  LIST NormProtoList;
+
+  void AddClass(CLASS_CLUSTERS Clusters);
+};
+
 /**----------------------------------------------------------------------------
           Global Data Definitions and Declarations
 ----------------------------------------------------------------------------**/
@@ -143,11 +154,10 @@ int main (
   char  *PageName;
   FILE  *TrainingPage;
   LIST  CharList = NIL_LIST;
-  CLUSTERER  *Clusterer = NULL;
-  LIST    ProtoList = NIL_LIST;
-  LIST    NormProtoList = NIL_LIST;
-  LIST pCharList;
-  LABELEDLIST CharSample;
+  NormProtoCollector collector;
+  collector.Clusterer = NULL;
+  collector.ProtoList = NIL_LIST;
+  collector.NormProtoList = NIL_LIST;
   FEATURE_DEFS_STRUCT FeatureDefs;
   InitFeatureDefs(&FeatureDefs);
 
@@ -165,38 +175,20 @@ int main (
   // To allow an individual font to form a separate cluster,
   // reduce the min samples:
   // Config.MinSamples = 0.5 / num_fonts;
-  pCharList = CharList;
-  iterate(pCharList) {
-    //Cluster
-    CharSample = (LABELEDLIST)first_node(pCharList);
-    Clusterer =
-      SetUpForClustering(FeatureDefs, CharSample, PROGRAM_FEATURE_TYPE);
-    float SavedMinSamples = Config.MinSamples;
-    // To disable the tendency to produce a single cluster for all fonts,
-    // make MagicSamples an impossible to achieve number:
-    // Config.MagicSamples = CharSample->SampleCount * 10;
-    Config.MagicSamples = CharSample->SampleCount;
-    while (Config.MinSamples > 0.001) {
-      ProtoList = ClusterSamples(Clusterer, &Config);
-      if (NumberOfProtos(ProtoList, 1, 0) > 0) {
-        break;
-      } else {
-        Config.MinSamples *= 0.95;
-        printf("0 significant protos for %s."
-               " Retrying clustering with MinSamples = %f%%\n",
-               CharSample->Label, Config.MinSamples);
-      }
-    }
-    Config.MinSamples = SavedMinSamples;
-    AddToNormProtosList(&NormProtoList, ProtoList, CharSample->Label);
-  }
+  // The classes are clustered on NumThreads threads, and their protos
+  // gathered in the order of CharList.
+  ClassClustersCallback *add_class =
+      NewPermanentTessCallback(&collector, &NormProtoCollector::AddClass);
+  ClusterClasses(FeatureDefs, CharList, PROGRAM_FEATURE_TYPE,
+                 &Config, TRUE, add_class);
+  delete add_class;
   FreeTrainingSamples(CharList);
-  if (Clusterer == NULL) // To avoid a SIGSEGV
+  if (collector.Clusterer == NULL) // To avoid a SIGSEGV
     return 1;
-  WriteNormProtos (Directory, NormProtoList, Clusterer);
-  FreeClusterer(Clusterer);
-  FreeProtoList(&ProtoList);
-  FreeNormProtoList(NormProtoList);
+  WriteNormProtos (Directory, collector.NormProtoList, collector.Clusterer);
+  FreeClusterer(collector.Clusterer);
+  FreeProtoList(&collector.ProtoList);
+  FreeNormProtoList(collector.NormProtoList);
   printf ("\n");
   return 0;
 }  // main
@@ -280,3 +272,13 @@ void WriteProtos(
       WritePrototype( File, N, Proto );
   }
 }  // WriteProtos
+
+/*-------------------------------------------------------------------------*/
+void NormProtoCollector::AddClass(CLASS_CLUSTERS Clusters) {
+  AddToNormProtosList(&NormProtoList, Clusters->ProtoList,
+                      Clusters->CharSample->Label);
+  if (Clusterer != NULL)
+    FreeClusterer(Clusterer);
+  Clusterer = Clusters->Clusterer;
+  ProtoList = Clusters->ProtoList;
+}  // AddClass
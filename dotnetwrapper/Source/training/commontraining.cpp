@@ -26,6 +26,8 @@
 #include "tprintf.h"
 #include "freelist.h"
 #include "unicity_table.h"
+#include "pagestats.h"
+#include "threadpool.h"
 
 #include <math.h>
 
@@ -47,6 +49,8 @@ char CTFontName[MAXNAMESIZE];
 
 const char* test_ch = "";
 
+int NumThreads = 1;
+
 /*---------------------------------------------------------------------------*/
 void ParseArguments(int argc, char **argv) {
 /*
@@ -73,6 +77,7 @@ void ParseArguments(int argc, char **argv) {
  **			-U InputUnicharsetFile
  **			-O OutputUnicharsetFile
  **			-X InputXHeightsFile
+ **			-T NumThreads
 
  **	Return: none
  **	Exceptions: Illegal options terminate the program.
@@ -83,7 +88,7 @@ void ParseArguments(int argc, char **argv) {
   BOOL8  Error;
 
   Error = FALSE;
-  while ((Option = tessopt(argc, argv, "F:O:U:R:D:C:I:M:B:S:X:")) != EOF) {
+  while ((Option = tessopt(argc, argv, "F:O:U:R:D:C:I:M:B:S:X:T:")) != EOF) {
     switch (Option) {
       case 'C':
         ParametersRead = sscanf( tessoptarg, "%lf", &(Config.Confidence) );
@@ -141,6 +146,11 @@ void ParseArguments(int argc, char **argv) {
         InputXHeightsFile = tessoptarg;
         printf("InputXHeightsFile %s\n", InputXHeightsFile);
         break;
+      case 'T':
+        ParametersRead = sscanf( tessoptarg, "%d", &NumThreads );
+        if ( ParametersRead != 1 ) Error = TRUE;
+        else if ( NumThreads < 1 ) NumThreads = 1;
+        break;
       case '?':
         Error = TRUE;
         break;
@@ -154,6 +164,7 @@ void ParseArguments(int argc, char **argv) {
       fprintf (stderr, "\t[-U InputUnicharsetFile] [-O OutputUnicharsetFile]\n");
       fprintf (stderr, "\t[-F FontInfoFile]\n");
       fprintf (stderr, "\t[-X InputXHeightsFile]\n");
+      fprintf (stderr, "\t[-T NumThreads]\n");
       fprintf (stderr, "\t[ TrainingPage ... ]\n");
       exit (2);
     }
@@ -520,6 +531,145 @@ CLUSTERER *SetUpForClustering(
 
 }	/* SetUpForClustering */
 
+// Shared by the tasks of ClusterClasses.
+struct ClusterClassesContext {
+  const FEATURE_DEFS_STRUCT *feature_defs;
+  const char *program_feature_type;
+  const CLUSTERCONFIG *config;
+  BOOL8 retry_for_sig_protos;
+  ClassClustersCallback *class_done;
+  CLASS_CLUSTERS clusters;
+  int num_classes;
+  // Number of classes done, for the progress report.
+  int num_done;
+  // Index of the first class not yet given to class_done.
+  int num_handed_over;
+  tesseract::CCUtilMutex mutex;
+};
+
+// Clusters the samples of the class of the given index. Runs on any thread,
+// so it only changes its own copy of the configuration, and the context
+// under its mutex. Then it hands over the classes that are done, up to the
+// first one that is not, in order, so that the clusterers of the classes
+// that are done are not all kept until the end.
+static void ClusterClass(ClusterClassesContext *context, int thread_index,
+                         int item) {
+  CLASS_CLUSTERS class_clusters = &context->clusters[item];
+  LABELEDLIST char_sample = class_clusters->CharSample;
+  double start = tesseract::PageStageTimer::Now();
+  CLUSTERCONFIG config = *context->config;
+  config.MagicSamples = char_sample->SampleCount;
+  CLUSTERER *clusterer = SetUpForClustering(*context->feature_defs,
+                                            char_sample,
+                                            context->program_feature_type);
+  LIST proto_list = ClusterSamples(clusterer, &config);
+  // Recompute the prototypes with fewer samples needed per prototype until
+  // at least one of them is significant.
+  while (context->retry_for_sig_protos &&
+         NumberOfProtos(proto_list, 1, 0) == 0 && config.MinSamples > 0.001) {
+    config.MinSamples *= 0.95;
+    printf("0 significant protos for %s."
+           " Retrying clustering with MinSamples = %f%%\n",
+           char_sample->Label, config.MinSamples);
+    if (config.MinSamples <= 0.001)
+      break;
+    proto_list = ClusterSamples(clusterer, &config);
+  }
+  double seconds = tesseract::PageStageTimer::Now() - start;
+
+  context->mutex.Lock();
+  class_clusters->Clusterer = clusterer;
+  class_clusters->ProtoList = proto_list;
+  class_clusters->Seconds = seconds;
+  ++context->num_done;
+  printf("Clustered %s (%d/%d): %d samples, %d protos in %.3f s\n",
+         char_sample->Label, context->num_done, context->num_classes,
+         clusterer->NumberOfSamples, count(proto_list), seconds);
+  while (context->num_handed_over < context->num_classes) {
+    class_clusters = &context->clusters[context->num_handed_over];
+    if (class_clusters->Clusterer == NULL)
+      break;
+    context->class_done->Run(class_clusters);
+    class_clusters->Clusterer = NULL;
+    class_clusters->ProtoList = NIL_LIST;
+    ++context->num_handed_over;
+  }
+  context->mutex.Unlock();
+}
+
+/*---------------------------------------------------------------------------*/
+void ClusterClasses(
+    const FEATURE_DEFS_STRUCT &FeatureDefs,
+    LIST CharList,
+    const char *program_feature_type,
+    const CLUSTERCONFIG *Config,
+    BOOL8 RetryForSigProtos,
+    ClassClustersCallback *ClassDone)
+/*
+ **	Parameters:
+ **		CharList: LABELEDLISTs of the samples of each class.
+ **		Config: clustering parameters, MagicSamples excepted, which is
+ **		the number of samples of each class.
+ **		RetryForSigProtos: whether to lower MinSamples until some
+ **		prototypes are significant, as cntraining does.
+ **		ClassDone: run on the result of each class, which it must free
+ **		the clusterer of with FreeClusterer, and the proto list of as
+ **		it needs.  It is not deleted.
+ **	Globals:
+ **		NumThreads	number of threads to cluster on
+ **	Operation:
+ **		This routine clusters the samples of each class of CharList
+ **		with SetUpForClustering and ClusterSamples, one class at a time
+ **		on each of NumThreads threads, reporting each class as it is
+ **		done.  ClassDone is run on one class at a time, in the order
+ **		of CharList whatever the number of threads, so the caller
+ **		produces the same output, as soon as the class and those
+ **		before it are done.
+ **	Return: none
+ **	Exceptions:
+ **		None
+ */
+{
+  ClusterClassesContext context;
+  context.feature_defs = &FeatureDefs;
+  context.program_feature_type = program_feature_type;
+  context.config = Config;
+  context.retry_for_sig_protos = RetryForSigProtos;
+  context.class_done = ClassDone;
+  context.num_classes = count(CharList);
+  context.num_done = 0;
+  context.num_handed_over = 0;
+  context.clusters = new CLASS_CLUSTERS_NODE[MAX(context.num_classes, 1)];
+  int i = 0;
+  iterate(CharList) {
+    context.clusters[i].CharSample = (LABELEDLIST) first_node(CharList);
+    context.clusters[i].Clusterer = NULL;
+    context.clusters[i].ProtoList = NIL_LIST;
+    context.clusters[i].Seconds = 0.0;
+    ++i;
+  }
+
+  double start = tesseract::PageStageTimer::Now();
+  tesseract::ThreadPoolTask* task =
+      NewPermanentTessCallback(&ClusterClass, &context);
+  int num_threads = MAX(MIN(NumThreads, context.num_classes), 1);
+  if (num_threads > 1) {
+    tesseract::ThreadPool pool(num_threads);
+    pool.Run(context.num_classes, task);
+  } else {
+    for (i = 0; i < context.num_classes; ++i)
+      task->Run(0, i);
+  }
+  delete task;
+  double seconds = tesseract::PageStageTimer::Now() - start;
+  double class_seconds = 0.0;
+  for (i = 0; i < context.num_classes; ++i)
+    class_seconds += context.clusters[i].Seconds;
+  printf("Clustered %d classes on %d threads in %.3f s (%.3f s of work)\n",
+         context.num_classes, num_threads, seconds, class_seconds);
+  delete [] context.clusters;
+}	/* ClusterClasses */
+
 /*------------------------------------------------------------------------*/
 void MergeInsignificantProtos(LIST ProtoList, const char* label,
                               CLUSTERER	*Clusterer, CLUSTERCONFIG *Config) {
@@ -18,6 +18,7 @@
 #include "cluster.h"
 #include "intproto.h"
 #include "featdefs.h"
+#include "tesscallback.h"
 
 //////////////////////////////////////////////////////////////////////////////
 // Macros ////////////////////////////////////////////////////////////////////
@@ -45,6 +46,9 @@ extern const char *OutputUnicharsetFile;
 extern const char *InputFontInfoFile;
 extern const char *InputXHeightsFile;
 
+// Number of threads the classes are clustered on.
+extern int NumThreads;
+
 //////////////////////////////////////////////////////////////////////////////
 // Structs ///////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
@@ -57,6 +61,21 @@ typedef struct
 }
 LABELEDLISTNODE, *LABELEDLIST;
 
+// The clusterer and prototypes made by ClusterClasses from the samples of one
+// class, and the wall-clock seconds it took.
+typedef struct
+{
+  LABELEDLIST CharSample;
+  CLUSTERER   *Clusterer;
+  LIST        ProtoList;
+  double      Seconds;
+}
+CLASS_CLUSTERS_NODE, *CLASS_CLUSTERS;
+
+// Takes over the clusterer and prototypes of a class clustered by
+// ClusterClasses.
+typedef TessCallback1<CLASS_CLUSTERS> ClassClustersCallback;
+
 typedef struct
 {
   char* Label;
@@ -108,6 +127,14 @@ CLUSTERER *SetUpForClustering(
     LABELEDLIST CharSample,
     const char  *program_feature_type);
 
+void ClusterClasses(
+    const FEATURE_DEFS_STRUCT &FeatureDefs,
+    LIST        CharList,
+    const char  *program_feature_type,
+    const CLUSTERCONFIG *Config,
+    BOOL8       RetryForSigProtos,
+    ClassClustersCallback *ClassDone);
+
 LIST RemoveInsignificantProtos(
     LIST        ProtoList,
     BOOL8       KeepSigProtos,
@@ -0,0 +1,196 @@
+///////////////////////////////////////////////////////////////////////
+// File:        cube_quantize_net.cpp
+// Description: Converts the char net of a cube language to int8 weights.
+//
+// (C) Copyright 2011, Google Inc.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "char_samp_set.h"
+#include "char_set.h"
+#include "cube_reco_context.h"
+#include "feature_base.h"
+#include "neural_net.h"
+#include "tesseractclass.h"
+#include "tuning_params.h"
+
+using tesseract::CharSampSet;
+using tesseract::CharSet;
+using tesseract::CubeRecoContext;
+using tesseract::FeatureBase;
+using tesseract::NeuralNet;
+using tesseract::TuningParams;
+
+// Main program to convert the [lang].cube.nn char net of a cube language
+// to int8 weights. The scales of the inputs of the layers are calibrated
+// on the char samples of a dump file, as written by
+// CharSampSet::CreateCharDumpFile, and the top choices of the float and
+// int8 nets are compared on the samples of a second dump file, or of the
+// same one.
+//
+//   cube_quantize_net tessdata_prefix lang calib.dump quantized.nn [eval.dump]
+//
+// tessdata_prefix is the directory holding tessdata, as for tesseract.
+// quantized.nn is read by the cube classifier like a float net, so once the
+// accuracy delta is acceptable it can replace [lang].cube.nn.
+
+// Returns the class of the highest output, skipping output 0, which is not
+// a class, as in ConvNetCharClassifier::Classify.
+static int TopClass(const vector<float> &outputs) {
+  int top_class = 1;
+  for (int out = 2; out < static_cast<int>(outputs.size()); out++) {
+    if (outputs[out] > outputs[top_class])
+      top_class = out;
+  }
+  return top_class;
+}
+
+// Returns the size of the file in bytes, or -1 if it cannot be opened.
+static long FileSize(const string &file_name) {
+  FILE *fp = fopen(file_name.c_str(), "rb");
+  if (fp == NULL)
+    return -1;
+  fseek(fp, 0, SEEK_END);
+  long size = ftell(fp);
+  fclose(fp);
+  return size;
+}
+
+int main(int argc, char **argv) {
+  if (argc != 5 && argc != 6) {
+    fprintf(stderr, "Usage: %s tessdata_prefix lang calib.dump quantized.nn"
+            " [eval.dump]\n", argv[0]);
+    return 1;
+  }
+  // Cube is only loaded on first use, so load it here.
+  tesseract::Tesseract tess;
+  if (tess.init_tesseract(argv[1], argv[2], tesseract::OEM_CUBE_ONLY) != 0 ||
+      !tess.load_cube_objects()) {
+    fprintf(stderr, "Failed to load cube for language %s\n", argv[2]);
+    return 1;
+  }
+  CubeRecoContext *cntxt = tess.GetCubeRecoContext();
+  if (cntxt->Params()->TypeClassifier() != TuningParams::NN) {
+    fprintf(stderr, "Only the nets of the NN char classifier are supported\n");
+    return 1;
+  }
+  string data_file_path;
+  if (!cntxt->GetDataFilePath(&data_file_path)) {
+    fprintf(stderr, "Unable to get data file path\n");
+    return 1;
+  }
+  string net_file = data_file_path + cntxt->Lang() + ".cube.nn";
+  NeuralNet *float_net = NeuralNet::FromFile(net_file);
+  NeuralNet *int8_net = NeuralNet::FromFile(net_file);
+  if (float_net == NULL || int8_net == NULL) {
+    fprintf(stderr, "Failed to read %s\n", net_file.c_str());
+    return 1;
+  }
+  FeatureBase *feat_extract = cntxt->Classifier()->FeatureExtractor();
+  CharSet *char_set = cntxt->CharacterSet();
+  vector<float> features(float_net->in_cnt());
+  vector<float> float_outputs(float_net->out_cnt());
+  vector<float> int8_outputs(float_net->out_cnt());
+
+  CharSampSet *calib_set = CharSampSet::FromCharDumpFile(argv[3]);
+  if (calib_set == NULL) {
+    fprintf(stderr, "Failed to read char samples from %s\n", argv[3]);
+    return 1;
+  }
+  int calib_cnt = 0;
+  for (int s = 0; s < calib_set->SampleCount(); ++s) {
+    if (!feat_extract->ComputeFeatures(calib_set->Samples()[s],
+                                       &features[0]))
+      continue;
+    if (!int8_net->Calibrate(&features[0])) {
+      fprintf(stderr, "%s is not made of layers and cannot be quantized\n",
+              net_file.c_str());
+      return 1;
+    }
+    ++calib_cnt;
+  }
+  if (!int8_net->Quantize() || !int8_net->WriteQuantized(argv[4])) {
+    fprintf(stderr, "Failed to quantize %s to %s\n", net_file.c_str(),
+            argv[4]);
+    return 1;
+  }
+  printf("Calibrated on %d samples, wrote %s: %ld bytes, from %ld\n",
+         calib_cnt, argv[4], FileSize(argv[4]), FileSize(net_file));
+
+  CharSampSet *eval_set = calib_set;
+  if (argc == 6) {
+    eval_set = CharSampSet::FromCharDumpFile(argv[5]);
+    if (eval_set == NULL) {
+      fprintf(stderr, "Failed to read char samples from %s\n", argv[5]);
+      return 1;
+    }
+  }
+  int eval_cnt = 0;
+  int labeled_cnt = 0;
+  int float_correct = 0;
+  int int8_correct = 0;
+  int agree_cnt = 0;
+  double max_diff = 0.0;
+  double sum_diff = 0.0;
+  for (int s = 0; s < eval_set->SampleCount(); ++s) {
+    tesseract::CharSamp *samp = eval_set->Samples()[s];
+    if (!feat_extract->ComputeFeatures(samp, &features[0]) ||
+        !float_net->FeedForward(&features[0], &float_outputs[0]) ||
+        !int8_net->FeedForward(&features[0], &int8_outputs[0]))
+      continue;
+    ++eval_cnt;
+    for (int out = 0; out < static_cast<int>(float_outputs.size()); ++out) {
+      double diff = fabs(float_outputs[out] - int8_outputs[out]);
+      sum_diff += diff;
+      if (diff > max_diff)
+        max_diff = diff;
+    }
+    int float_class = TopClass(float_outputs);
+    int int8_class = TopClass(int8_outputs);
+    if (float_class == int8_class)
+      ++agree_cnt;
+    int label_class = samp->StrLabel() != NULL ?
+        char_set->ClassID(samp->StrLabel()) : -1;
+    if (label_class < 0)
+      continue;
+    ++labeled_cnt;
+    if (float_class == label_class)
+      ++float_correct;
+    if (int8_class == label_class)
+      ++int8_correct;
+  }
+  if (eval_cnt == 0) {
+    fprintf(stderr, "No sample to evaluate\n");
+    return 1;
+  }
+  printf("Evaluated on %d samples, %d labeled\n", eval_cnt, labeled_cnt);
+  printf("Top choice agreement: %.2f%%\n", 100.0 * agree_cnt / eval_cnt);
+  if (labeled_cnt > 0) {
+    printf("Top choice accuracy: float %.2f%%, int8 %.2f%%, delta %+.2f%%\n",
+           100.0 * float_correct / labeled_cnt,
+           100.0 * int8_correct / labeled_cnt,
+           100.0 * (int8_correct - float_correct) / labeled_cnt);
+  }
+  printf("Output difference: mean %g, max %g\n",
+         sum_diff / (eval_cnt * float_outputs.size()), max_diff);
+  if (eval_set != calib_set)
+    delete eval_set;
+  delete calib_set;
+  delete int8_net;
+  delete float_net;
+  return 0;
+}
@@ -150,6 +150,71 @@ char* new_dup(const char* str) {
   return new_str;
 }
 
+// Merges the classes clustered from the samples of a font into ClassList
+// as ClusterClasses hands them over.
+struct FontClassMerger {
+  int fontinfo_id;
+  LIST *ClassList;
+
+  void MergeClass(CLASS_CLUSTERS Clusters);
+};
+
+void FontClassMerger::MergeClass(CLASS_CLUSTERS Clusters) {
+  LABELEDLIST CharSample = Clusters->CharSample;
+  CLUSTERER *Clusterer = Clusters->Clusterer;
+  LIST ProtoList = Clusters->ProtoList;
+  PROTOTYPE *Prototype;
+  int Cid, Pid;
+  PROTO Proto;
+  PROTO_STRUCT DummyProto;
+  BIT_VECTOR Config2;
+  MERGE_CLASS MergeClass;
+  LIST pProtoList;
+
+  CleanUpUnusedData(ProtoList);
+
+  // Merge.
+  MergeInsignificantProtos(ProtoList, CharSample->Label,
+                           Clusterer, &Config);
+  if (strcmp(test_ch, CharSample->Label) == 0)
+    DisplayProtoList(test_ch, ProtoList);
+  ProtoList = RemoveInsignificantProtos(ProtoList, true,
+                                        false,
+                                        Clusterer->SampleSize);
+  FreeClusterer(Clusterer);
+  MergeClass = FindClass (*ClassList, CharSample->Label);
+  if (MergeClass == NULL) {
+    MergeClass = NewLabeledClass (CharSample->Label);
+    *ClassList = push (*ClassList, MergeClass);
+  }
+  Cid = AddConfigToClass(MergeClass->Class);
+  MergeClass->Class->font_set.push_back(fontinfo_id);
+  pProtoList = ProtoList;
+  iterate (pProtoList) {
+    Prototype = (PROTOTYPE *) first_node (pProtoList);
+
+    // See if proto can be approximated by existing proto.
+    Pid = FindClosestExistingProto(MergeClass->Class,
+                                   MergeClass->NumMerged, Prototype);
+    if (Pid == NO_PROTO) {
+      Pid = AddProtoToClass (MergeClass->Class);
+      Proto = ProtoIn (MergeClass->Class, Pid);
+      MakeNewFromOld (Proto, Prototype);
+      MergeClass->NumMerged[Pid] = 1;
+    }
+    else {
+      MakeNewFromOld (&DummyProto, Prototype);
+      ComputeMergedProto (ProtoIn (MergeClass->Class, Pid), &DummyProto,
+          (FLOAT32) MergeClass->NumMerged[Pid], 1.0,
+          ProtoIn (MergeClass->Class, Pid));
+      MergeClass->NumMerged[Pid] ++;
+    }
+    Config2 = MergeClass->Class->Configurations[Cid];
+    AddProtoToConfig (Pid, Config2);
+  }
+  FreeProtoList (&ProtoList);
+}
+
 /*---------------------------------------------------------------------------*/
 int main (int argc, char **argv) {
 /*
@@ -187,18 +252,12 @@ int main (int argc, char **argv) {
   char  *PageName;
   FILE  *TrainingPage;
   FILE  *OutFile;
-  CLUSTERER  *Clusterer = NULL;
-  LIST    ProtoList = NIL_LIST;
-  LABELEDLIST CharSample;
-  PROTOTYPE  *Prototype;
   LIST     ClassList = NIL_LIST;
-  int    Cid, Pid;
-  PROTO    Proto;
-  PROTO_STRUCT  DummyProto;
-  BIT_VECTOR  Config2;
-  MERGE_CLASS  MergeClass;
   INT_TEMPLATES  IntTemplates;
-  LIST pCharList, pProtoList;
+  FontClassMerger merger;
+  merger.ClassList = &ClassList;
+  ClassClustersCallback *merge_class =
+      NewPermanentTessCallback(&merger, &FontClassMerger::MergeClass);
   char Filename[MAXNAMESIZE];
   tesseract::Classify *classify = new tesseract::Classify();
   FEATURE_DEFS_STRUCT FeatureDefs;
@@ -298,57 +357,11 @@ int main (int argc, char **argv) {
                         0, 1.0f / 128.0f, 1.0f / 64.0f, &unicharset_training,
                         TrainingPage, &char_list);
     fclose (TrainingPage);
-    pCharList = char_list;
-    iterate(pCharList) {
-      // Cluster.
-      CharSample = (LABELEDLIST) first_node (pCharList);
-      Clusterer =
-        SetUpForClustering(FeatureDefs, CharSample, PROGRAM_FEATURE_TYPE);
-      Config.MagicSamples = CharSample->SampleCount;
-      ProtoList = ClusterSamples(Clusterer, &Config);
-      CleanUpUnusedData(ProtoList);
-
-      // Merge.
-      MergeInsignificantProtos(ProtoList, CharSample->Label,
-                               Clusterer, &Config);
-      if (strcmp(test_ch, CharSample->Label) == 0)
-        DisplayProtoList(test_ch, ProtoList);
-      ProtoList = RemoveInsignificantProtos(ProtoList, true,
-                                            false,
-                                            Clusterer->SampleSize);
-      FreeClusterer(Clusterer);
-      MergeClass = FindClass (ClassList, CharSample->Label);
-      if (MergeClass == NULL) {
-        MergeClass = NewLabeledClass (CharSample->Label);
-        ClassList = push (ClassList, MergeClass);
-      }
-      Cid = AddConfigToClass(MergeClass->Class);
-      MergeClass->Class->font_set.push_back(fontinfo_id);
-      pProtoList = ProtoList;
-      iterate (pProtoList) {
-        Prototype = (PROTOTYPE *) first_node (pProtoList);
-
-        // See if proto can be approximated by existing proto.
-        Pid = FindClosestExistingProto(MergeClass->Class,
-                                       MergeClass->NumMerged, Prototype);
-        if (Pid == NO_PROTO) {
-          Pid = AddProtoToClass (MergeClass->Class);
-          Proto = ProtoIn (MergeClass->Class, Pid);
-          MakeNewFromOld (Proto, Prototype);
-          MergeClass->NumMerged[Pid] = 1;
-        }
-        else {
-          MakeNewFromOld (&DummyProto, Prototype);
-          ComputeMergedProto (ProtoIn (MergeClass->Class, Pid), &DummyProto,
-              (FLOAT32) MergeClass->NumMerged[Pid], 1.0,
-              ProtoIn (MergeClass->Class, Pid));
-          MergeClass->NumMerged[Pid] ++;
-        }
-        Config2 = MergeClass->Class->Configurations[Cid];
-        AddProtoToConfig (Pid, Config2);
-      }
-      FreeProtoList (&ProtoList);
-    }
+    // Cluster, on NumThreads threads. The classes are merged in the order
+    // of char_list as they are done.
+    merger.fontinfo_id = fontinfo_id;
+    ClusterClasses(FeatureDefs, char_list, PROGRAM_FEATURE_TYPE,
+                   &Config, FALSE, merge_class);
     FreeTrainingSamples(char_list);
 
     // If there is a file with [lang].[fontname].exp[num].fontinfo present,
@@ -361,6 +374,7 @@ int main (int argc, char **argv) {
                    xheights, &(classify->get_fontinfo_table()));
     delete[] fontinfo_file_name;
   }
+  delete merge_class;
   WriteMicrofeat(Directory, ClassList);
   SetUpForFloat2Int(unicharset_training, ClassList);
   IntTemplates = classify->CreateIntTemplates(TrainingData,
@@ -498,6 +498,7 @@ BLOB_CHOICE_LIST_VECTOR *Wordrec::chop_word_main(WERD_RES *word) {
   MATRIX *ratings = NULL;
   DANGERR fixpt;                 /*dangerous ambig */
   inT32 bit_count;               //no of bits
+  PageStageTimer timer(page_stats(), PAGE_STAGE_CHOP_WORD);
 
   set_denorm(&word->denorm);
 
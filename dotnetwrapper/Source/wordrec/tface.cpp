@@ -59,6 +59,24 @@ void Wordrec::program_editup(const char *textbase,
   pass2_seg_states = wordrec_num_seg_states;
 }
 
+/**
+ * @name program_editup_shared
+ *
+ * Same as program_editup, but the pre-trained classifier and the dawgs are
+ * borrowed from master instead of being loaded.
+ */
+void Wordrec::program_editup_shared(const char *textbase,
+                                    Wordrec *master,
+                                    bool init_dict) {
+  if (textbase != NULL) imagefile = textbase;
+  InitFeatureDefs(&feature_defs_);
+  SetupExtractors(&feature_defs_);
+  InitSharedAdaptiveClassifier(*master);
+  if (init_dict) getDict().LoadShared(master->getDict());
+  pass2_ok_split = chop_ok_split;
+  pass2_seg_states = wordrec_num_seg_states;
+}
+
 /**
  * @name end_recog
  *
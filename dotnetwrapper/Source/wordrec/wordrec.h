@@ -163,6 +163,9 @@ class Wordrec : public Classify {
   void program_editup(const char *textbase,
                       bool init_classifier,
                       bool init_permute);
+  void program_editup_shared(const char *textbase,
+                             Wordrec *master,
+                             bool init_permute);
   BLOB_CHOICE_LIST_VECTOR *cc_recog(WERD_RES *word);
   void program_editdown(inT32 elasped_time);
   void set_pass1();
@@ -15,8 +15,11 @@ limitations under the License.
 **/
 
 #include <windows.h>
+#include <vcclr.h>
 #include "tesseractenginewrapper.h"
 #include "..\api\baseapi.h"
+#include "..\api\resultiterator.h"
+#include "..\ccutil\pagestats.h"
 #include "..\cutil\callcpp.h"
 #include "..\wordrec\chop.h"
 #include "..\ccmain\tessedit.h"
@@ -45,6 +48,7 @@ TesseractProcessor::TesseractProcessor()
 	InitializeWorkingSpace();
 
 	_doMonitor = true;
+	_streamResults = false;
 }
 
 TesseractProcessor::~TesseractProcessor()
@@ -430,6 +434,108 @@ String* TesseractProcessor::Apply(System::Drawing::Image* image, int l, int t, i
 	return result;
 }
 
+/**
+Collects the text of each page recognized by TessBaseAPI::RecognizeBatch.
+**/
+class BatchTextCollector
+{
+public:
+	GenericVector<STRING> Texts;
+
+	void Collect(int pageIndex, TessBaseAPI* api)
+	{
+		if (api == NULL)
+		{
+			Texts.push_back(STRING(""));
+			return;
+		}
+
+		char* text = api->GetUTF8Text();
+		Texts.push_back(STRING(text));
+		delete [] text;
+	}
+};
+
+List<String*>* TesseractProcessor::ApplyBatch(List<Image*>* images)
+{
+	// Layout analysis of the next 2 pages overlaps the current recognition.
+	return this->ApplyBatch(images, 2);
+}
+
+List<String*>* TesseractProcessor::ApplyBatch(List<Image*>* images, int queueDepth)
+{
+	if (_apiInstance == null || images == null)
+		return null;
+
+	List<String*>* results = new List<String*>(images->Count);
+	int nPages = images->Count;
+	if (nPages == 0)
+		return results;
+
+	Pix** pages = new Pix*[nPages];
+	for (int i = 0; i < nPages; i++)
+		pages[i] = null;
+
+	BatchTextCollector collector;
+	BatchPageCallback* callback = NewPermanentTessCallback(
+		&collector, &BatchTextCollector::Collect);
+
+	try
+	{
+		for (int i = 0; i < nPages; i++)
+			pages[i] = this->PixFromImage(images->get_Item(i));
+
+		TessBaseAPI* api = (TessBaseAPI*)_apiInstance.ToPointer();
+		api->RecognizeBatch(pages, nPages, queueDepth, callback);
+
+		for (int i = 0; i < collector.Texts.size(); i++)
+			results->Add(new String(collector.Texts[i].string()));
+	}
+	catch (System::Exception* exp)
+	{
+		throw exp;
+	}
+	__finally
+	{
+		delete callback;
+		callback = null;
+
+		for (int i = 0; i < nPages; i++)
+		{
+			if (pages[i] != null)
+				pixDestroy(&pages[i]);
+		}
+		delete [] pages;
+		pages = null;
+	}
+
+	return results;
+}
+
+/**
+Raises TesseractProcessor::ResultReady for each result reported through
+TessBaseAPI::SetResultCallback.
+**/
+class ResultStreamer
+{
+public:
+	gcroot<TesseractProcessor*> Processor;
+
+	void Report(const ResultIterator* it, PageIteratorLevel level)
+	{
+		int left = 0, top = 0, right = 0, bottom = 0;
+		it->BoundingBox(level, &left, &top, &right, &bottom);
+
+		char* text = it->GetUTF8Text(level);
+		String* str = (text != NULL ? new String(text, 0, strlen(text), Encoding::UTF8) : String::Empty);
+		delete [] text;
+
+		Processor->OnResultReady(new ResultReadyEventArgs(
+			static_cast<ResultLevel>(level), str, it->Confidence(level),
+			new RectBound(left, top, right, bottom)));
+	}
+};
+
 String* TesseractProcessor::Process(Pix* pix)
 {
 	TessBaseAPI* api = (TessBaseAPI*)_apiInstance.ToPointer();
@@ -444,8 +550,26 @@ String* TesseractProcessor::Process(TessBaseAPI* api, Pix* pix)
 	this->InitializeMonitor();
 	ETEXT_DESC* monitor = (_doMonitor ? (ETEXT_DESC*)_monitorInstance.ToPointer() : null);
 
-	api->SetImage(pix);
-	bool succed = api->Recognize(monitor) >= 0;
+	ResultStreamer streamer;
+	ResultCallback* callback = null;
+	if (_streamResults)
+	{
+		streamer.Processor = this;
+		callback = NewPermanentTessCallback(&streamer, &ResultStreamer::Report);
+	}
+
+	try
+	{
+		api->SetResultCallback(callback);
+		api->SetImage(pix);
+		bool succed = api->Recognize(monitor) >= 0;
+	}
+	__finally
+	{
+		api->SetResultCallback(null);
+		delete callback;
+		callback = null;
+	}
 
 	char* text = api->GetUTF8Text();
 
@@ -458,6 +582,47 @@ String* TesseractProcessor::Process(TessBaseAPI* api, Pix* pix)
 
 
 
+unsigned char TesseractProcessor::GetBinaryResult(int maxChoices) __gc[]
+{
+	if (_apiInstance == null)
+		return null;
+
+	TessBaseAPI* api = (TessBaseAPI*)_apiInstance.ToPointer();
+	int size = 0;
+	char* data = api->GetBinaryResult(maxChoices, &size);
+	if (data == null)
+		return null;
+
+	unsigned char result __gc[] = new unsigned char __gc[size];
+	System::Runtime::InteropServices::Marshal::Copy(System::IntPtr(data), result, 0, size);
+
+	delete [] data;
+	data = null;
+
+	return result;
+}
+
+PageStatistics* TesseractProcessor::GetPageStatistics()
+{
+	if (_apiInstance == null)
+		return null;
+
+	TessBaseAPI* api = (TessBaseAPI*)_apiInstance.ToPointer();
+	tesseract::PageStats stats;
+	if (!api->GetPageStats(&stats))
+		return null;
+
+	PageStatistics* result = new PageStatistics(tesseract::PAGE_STAGE_COUNT);
+	for (int s = 0; s < tesseract::PAGE_STAGE_COUNT; s++)
+	{
+		result->Seconds[s] = stats.seconds[s];
+		result->Calls[s] = stats.calls[s];
+	}
+	result->Allocations = stats.allocations;
+
+	return result;
+}
+
 System::Collections::Generic::List<Word*>* TesseractProcessor::RetriveResultDetail()
 {
 	if (!_doMonitor || _monitorInstance == null)
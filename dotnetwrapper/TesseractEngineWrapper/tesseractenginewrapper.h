@@ -48,6 +48,13 @@ __gc public class RectBound;
 __gc public class SimpleRecoginitionItem;
 __gc public class Character;
 __gc public class Word;
+__gc public class ResultReadyEventArgs;
+__gc public class PageStatistics;
+
+/**
+Handler of TesseractProcessor::ResultReady.
+**/
+public __delegate void ResultReadyEventHandler(Object* sender, ResultReadyEventArgs* e);
 
 
 __gc public class BlockList
@@ -125,6 +132,39 @@ public:
 	{
 		_doMonitor = doMonitor;
 	}
+
+private:
+	bool _streamResults;
+
+public:
+	/**
+	When true, Apply raises ResultReady for each block, line and word as soon
+	as its recognition is done, before the whole page is finished.
+	**/
+	__property bool get_StreamResults()
+	{
+		return _streamResults;
+	}
+
+	__property void set_StreamResults(bool streamResults)
+	{
+		_streamResults = streamResults;
+	}
+
+	/**
+	Raised during Apply, when StreamResults is true, with the text, bounds and
+	confidence of each recognized block, line and word, in page order: the
+	words of a line, then the line, then its block if it was the last line.
+	The results may still be revised by the page-level passes that follow, so
+	the text returned by Apply remains the final output.
+	**/
+	__event ResultReadyEventHandler* ResultReady;
+
+	// Raises ResultReady. Used by the native result callback.
+	void OnResultReady(ResultReadyEventArgs* e)
+	{
+		ResultReady(this, e);
+	}
 	
 private:
 	System::IntPtr _apiInstance;
@@ -169,8 +209,25 @@ public:
 	String* Apply(String* filePath);
 	String* Apply(Image* image);
 	String* Apply(Image* image, int l, int t, int w, int h);	
+	List<String*>* ApplyBatch(List<Image*>* images);
+	List<String*>* ApplyBatch(List<Image*>* images, int queueDepth);
 	System::Collections::Generic::List<Word*>* RetriveResultDetail();
 
+	/**
+	Returns the result of the last Apply in the binary layout of
+	api\binaryresult.h, with at most maxChoices choices per symbol (all if
+	maxChoices <= 0), or null if there is no result. The bytes can be saved
+	and memory-mapped by consumers instead of parsing hOCR.
+	**/
+	unsigned char GetBinaryResult(int maxChoices) __gc[];
+
+	/**
+	Returns the time spent and the calls made in each stage of the last page,
+	or null if there is none. The stats are only recorded while the
+	tessedit_page_stats variable is set, see SetVariable.
+	**/
+	PageStatistics* GetPageStatistics();
+
 private:
 	Pix* PixFromImage(Image* image);
 	BlockList* DetectBlocks(TessBaseAPI* api, Pix* pix);
@@ -179,6 +236,38 @@ private:
 };
 
 
+/**
+Level of a result reported by TesseractProcessor::ResultReady.
+The values are those of tesseract::PageIteratorLevel.
+**/
+__value public enum ResultLevel
+{
+	Block = 0,
+	Paragraph = 1,
+	TextLine = 2,
+	Word = 3,
+	Symbol = 4
+};
+
+
+/**
+Stage of the recognition of a page timed in PageStatistics.
+The values are those of tesseract::PageStage.
+**/
+__value public enum PageStage
+{
+	Threshold = 0,
+	FindComponents = 1,
+	Textord = 2,
+	AutoPageSeg = 3,
+	AdaptiveClassifier = 4,
+	CharNormClassifier = 5,
+	CubeClassifier = 6,
+	ChopWord = 7,
+	DawgPermute = 8
+};
+
+
 class Helper
 {
 public:
@@ -284,6 +373,58 @@ public:
 	}
 };
 
+/**
+A block, line or word result reported by TesseractProcessor::ResultReady.
+**/
+__gc public class ResultReadyEventArgs : public System::EventArgs
+{
+public:
+	ResultLevel Level;
+
+	// The text, with a newline at the end of each line for blocks and lines
+	String* Text;
+
+	// Mean confidence of the words, from 0 to 100
+	Double Confidence;
+
+	RectBound* Bounds;
+
+public:
+	ResultReadyEventArgs(ResultLevel level, String* text, Double confidence, RectBound* bounds)
+	{
+		Level = level;
+		Text = text;
+		Confidence = confidence;
+		Bounds = bounds;
+	}
+};
+
+/**
+Time spent and calls made in each stage of a page, returned by
+TesseractProcessor::GetPageStatistics. The stages nest, so the time of a
+stage includes that of the stages it calls.
+**/
+__gc public class PageStatistics
+{
+public:
+	// Wall-clock seconds of each stage, indexed by PageStage
+	Double Seconds __gc[];
+
+	// Number of calls of each stage, indexed by PageStage
+	int Calls __gc[];
+
+	// Number of allocations made through the tesseract allocators
+	Int64 Allocations;
+
+public:
+	PageStatistics(int numStages)
+	{
+		Seconds = new Double __gc[numStages];
+		Calls = new int __gc[numStages];
+		Allocations = 0;
+	}
+};
+
 /**
 This class has implemented in tessnet2
 **/